@@ -1,6 +1,23 @@
 #include "vpch.h"
 #include <Viper.h>
 
+#define GAME_PARTICLES 10000
+
+struct Position
+{
+	float x = 0.0f, y = 0.0f;
+};
+
+struct Velocity
+{
+	float x = 0.0f, y = 0.0f;
+};
+
+struct Lifetime
+{
+	float remaining = 0.0f;
+};
+
 class GameLayer : public Viper::Layer
 {
 public:
@@ -9,12 +26,60 @@ public:
 	{
 	}
 
+	void onAttach() override
+	{
+		for (uint32_t i = 0; i < GAME_PARTICLES; i++)
+			this->spawnParticle(i);
+	}
+
+	void onUpdate() override
+	{
+		// fixed while an input recording is replayed, so the particles evolve the same way on every run
+		float timestep = Viper::Application::get().getTimestep();
+
+		this->world.query<Position, Velocity>().parallelEach<Position, Velocity>([timestep](Viper::Entity, Position &position, const Velocity &velocity)
+		{
+			position.x += velocity.x * timestep;
+			position.y += velocity.y * timestep;
+		}, 4);
+
+		// expired particles are replaced, the structural changes are recorded by the workers and applied afterwards
+		Viper::World *world = &this->world;
+
+		this->world.query<Lifetime>().parallelEach<Lifetime>([world, timestep](Viper::Entity entity, Lifetime &lifetime)
+		{
+			lifetime.remaining -= timestep;
+
+			if (lifetime.remaining <= 0.0f)
+			{
+				Viper::CommandBuffer &commands = world->getCommandBuffer();
+				commands.destroy(entity);
+
+				Viper::Entity particle = commands.create();
+				commands.add<Position>(particle);
+				commands.add<Velocity>(particle, Velocity{ (float)(entity.index % 7) - 3.0f, 2.0f });
+				commands.add<Lifetime>(particle, Lifetime{ 1.0f + (entity.index % 5) });
+			}
+		}, 4);
+
+		this->world.flush();
+	}
+
 	void onEvent(Viper::Event &e) override
 	{
 		if (Viper::Input::isKeyPressed(V_KEY_TAB))
-			V_INFO("TAB IS PRESSED!");
+			V_LOG_EVERY_MS(500, V_INFO, "TAB IS PRESSED!");
+	}
+
+private:
+	void spawnParticle(uint32_t seed)
+	{
+		this->world.create(Position(), Velocity{ (float)(seed % 7) - 3.0f, 2.0f }, Lifetime{ 1.0f + (seed % 5) });
 	}
 
+private:
+	Viper::World world;
+
 };
 
 class Game : public Viper::Application
@@ -22,7 +87,8 @@ class Game : public Viper::Application
 public:
 	Game()
 	{
-		pushLayer(new GameLayer());
+		emplaceLayer<GameLayer>();
+		emplaceOverlay<Viper::StatsOverlay>();
 	}
 
 	~Game(){}
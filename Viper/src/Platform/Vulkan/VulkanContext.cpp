@@ -1,12 +1,19 @@
 #include "vpch.h"
 #include "VulkanContext.h"
 
+#include "Viper/Memory/MemoryTracker.h"
+#include "Viper/Debug/Profiler.h"
+
 #include <glm/glm.hpp>
 
 namespace Viper
 {
 
 	#define MAX_FRAMES_IN_FLIGHT 2
+	#define UNIFORM_SLOTS_PER_FRAME 64
+	#define TIMESTAMPS_PER_FRAME 2
+	#define OVERLAY_MAX_VERTICES (6 * 4096)
+	#define MAX_TRANSFORMS 16384
 
 	struct QueueFamilyIndices
 	{
@@ -45,6 +52,8 @@ namespace Viper
 				- binary: Read the file as binary file (avoid text transformations)
 		*/
 
+		V_MEMORY_TAG(Assets);
+
 		std::ifstream file(filename, std::ifstream::ate | std::ifstream::binary);
 
 		if (!file.is_open())
@@ -77,13 +86,43 @@ namespace Viper
 			Cleanup memory
 		*/
 
+		// the render thread may still be presenting
+		{
+			std::lock_guard<std::mutex> lock(this->frameMutex);
+			this->renderThreadRunning = false;
+		}
+		this->frameCondition.notify_all();
+
+		if (this->renderThread.joinable())
+			this->renderThread.join();
+
+		vkDeviceWaitIdle(this->device);
+
 		this->cleanupSwapChain();
 
+		if (this->timestampPool != VK_NULL_HANDLE)
+			vkDestroyQueryPool(this->device, this->timestampPool, nullptr);
+
+		vkDestroyDescriptorPool(this->device, this->descriptorPool, nullptr);
+		vkDestroyDescriptorSetLayout(this->device, this->descriptorSetLayout, nullptr);
+
+		vkUnmapMemory(this->device, this->overlayVertexBufferMemory);
+		vkDestroyBuffer(this->device, this->overlayVertexBuffer, nullptr);
+		this->freeDeviceMemory(this->overlayVertexBufferMemory);
+
+		vkUnmapMemory(this->device, this->uniformBufferMemory);
+		vkDestroyBuffer(this->device, this->uniformBuffer, nullptr);
+		this->freeDeviceMemory(this->uniformBufferMemory);
+
+		vkUnmapMemory(this->device, this->transformBufferMemory);
+		vkDestroyBuffer(this->device, this->transformBuffer, nullptr);
+		this->freeDeviceMemory(this->transformBufferMemory);
+
 		vkDestroyBuffer(this->device, this->indexBuffer, nullptr);
-		vkFreeMemory(this->device, this->indexBufferMemory, nullptr);
+		this->freeDeviceMemory(this->indexBufferMemory);
 
 		vkDestroyBuffer(this->device, this->vertexBuffer, nullptr);
-		vkFreeMemory(this->device, this->vertexBufferMemory, nullptr);
+		this->freeDeviceMemory(this->vertexBufferMemory);
 
 		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
 		{
@@ -107,6 +146,15 @@ namespace Viper
 
 	void VulkanContext::init()
 	{
+		V_MEMORY_TAG(Renderer);
+
+		// swap chain settings are read on the render thread later on, it keeps its own copy
+		int width, height;
+		glfwGetFramebufferSize(this->windowHandle, &width, &height);
+		this->framebufferWidth = static_cast<uint32_t>(width);
+		this->framebufferHeight = static_cast<uint32_t>(height);
+		this->presentMode = this->window->getPresentMode();
+
 		this->createInstance();
 		this->debugger->setupDebugMessenger(this->instance);
 		this->createSurface();
@@ -115,21 +163,150 @@ namespace Viper
 		this->createSwapChain();
 		this->createImageViews();
 		this->createRenderPass();
+		this->createDescriptorSetLayout();
 		this->createGraphicsPipeline();
-		this->createFramebuffers();
+		this->createOverlayRenderPass();
+		this->createOverlayPipeline();
 		this->createCommandPool();
+		this->createDepthResources();
+		this->createSceneResources();
+		this->createFramebuffers();
+		this->createOverlayFramebuffers();
 		this->createVertexBuffer();
 		this->createIndexBuffer();
+		this->createUniformBuffer();
+		this->createTransformBuffer();
+		this->createOverlayVertexBuffer();
+		this->createDescriptorPool();
+		this->createDescriptorSet();
 		this->createCommandBuffers();
 		this->createSyncObjects();
+		this->createTimestampQueries();
+
+		// DrawCommand::mesh indexes this table
+		this->meshes.push_back({ this->vertexBuffer, this->indexBuffer });
+
+		this->renderThreadRunning = true;
+		this->renderThread = std::thread(&VulkanContext::renderLoop, this);
 	}
 
 
 
 	void VulkanContext::swapBuffers()
 	{
-		glfwPollEvents();
-		this->drawFrame();
+		/*
+			Hand the frame built by the main thread over to the render thread.
+			Waits until the render thread is done with the previous frame, so the main thread is at most one frame ahead:
+			while frame N is recorded and submitted, the layers already build frame N + 1.
+		*/
+
+		V_PROFILE_FUNCTION();
+
+		// testing
+		DrawCommand testDraw;
+		testDraw.indexCount = static_cast<uint32_t>(this->indices.size());
+		testDraw.transform = this->testTransform;
+		testDraw.transformIndex = this->testTransformIndex;
+		this->frames[this->submitIndex].queue.submit(RenderPassType::Opaque, 0.0f, testDraw, this->getTestBounds());
+
+		// pause while the window is minimized (glfw may only be called from the main thread)
+		int width = 0, height = 0;
+		glfwGetFramebufferSize(this->windowHandle, &width, &height);
+
+		while (width == 0 || height == 0)
+		{
+			glfwWaitEvents();
+			glfwGetFramebufferSize(this->windowHandle, &width, &height);
+		}
+
+		std::unique_lock<std::mutex> lock(this->frameMutex);
+
+		{
+			V_PROFILE_SCOPE("Wait for render thread");
+			this->frameCondition.wait(lock, [this]() { return !this->framePending && !this->renderBusy; });
+		}
+
+		this->stats = this->renderStats;
+
+		FramePacket &frame = this->frames[this->submitIndex];
+		frame.camera = this->cameraData;
+		frame.inputTimestamp = this->inputTimestamp;
+		frame.framebufferWidth = static_cast<uint32_t>(width);
+		frame.framebufferHeight = static_cast<uint32_t>(height);
+		frame.presentMode = this->window->getPresentMode();
+		frame.swapChainInvalid = this->swapChainInvalidated || this->window->getFramebufferResizeState();
+
+		this->window->setFramebufferResizeState(false);
+		this->swapChainInvalidated = false;
+
+		// the other packet was consumed by the render thread - it becomes the main thread's
+		this->renderIndex = this->submitIndex;
+		this->submitIndex ^= 1;
+		this->frames[this->submitIndex].queue.clear();
+		this->frames[this->submitIndex].queue.setCullFrustum(Frustum::fromMatrix(this->cameraData.viewProjection));
+		this->frames[this->submitIndex].overlay.clear();
+		this->frames[this->submitIndex].transforms.clear();
+
+		this->framePending = true;
+		lock.unlock();
+		this->frameCondition.notify_all();
+	}
+
+	void VulkanContext::setCamera(const glm::mat4 &viewProjection)
+	{
+		this->cameraData.viewProjection = viewProjection;
+
+		// the draws of the frame being built are culled with the new camera from now on
+		this->frames[this->submitIndex].queue.setCullFrustum(Frustum::fromMatrix(viewProjection));
+	}
+
+	AABB VulkanContext::getTestBounds() const
+	{
+		AABB bounds(this->vertices[0].pos, this->vertices[0].pos);
+
+		for (const Vertex &vertex : this->vertices)
+			bounds = AABB::merge(bounds, AABB(vertex.pos, vertex.pos));
+
+		return bounds.transformed(this->testTransform);
+	}
+
+	void VulkanContext::setTransforms(const glm::mat4 *matrices, uint32_t count)
+	{
+		if (count > MAX_TRANSFORMS)
+		{
+			V_CORE_WARN("{0} transforms set for the frame, only the first {1} fit in the transform buffer", count, MAX_TRANSFORMS);
+			count = MAX_TRANSFORMS;
+		}
+
+		this->frames[this->submitIndex].transforms.assign(matrices, matrices + count);
+	}
+
+	void VulkanContext::renderLoop()
+	{
+		V_MEMORY_TAG(Renderer);
+		Profiler::setThreadName("Render");
+
+		for (;;)
+		{
+			std::unique_lock<std::mutex> lock(this->frameMutex);
+			this->frameCondition.wait(lock, [this]() { return this->framePending || !this->renderThreadRunning; });
+
+			if (!this->renderThreadRunning)
+				break;
+
+			this->framePending = false;
+			this->renderBusy = true;
+			FramePacket &frame = this->frames[this->renderIndex];
+			lock.unlock();
+
+			this->drawFrame(frame);
+
+			lock.lock();
+			this->renderBusy = false;
+			this->renderStats = this->frameStats;
+			lock.unlock();
+			this->frameCondition.notify_all();
+		}
 	}
 
 
@@ -464,23 +641,34 @@ namespace Viper
 				- VK_PRESENT_MODE_FIFO_KHR
 				- VK_PRESENT_MODE_FIFO_RELAXED_KHR
 				- VK_PRESENT_MODE_MAILBOX_KHR
+
+			The mode follows the window's presentation policy, walking down its list of preferences.
+			FIFO is the only mode that is guaranteed to be available, so it ends every list.
 		*/
 
-		VkPresentModeKHR bestMode = VK_PRESENT_MODE_FIFO_KHR;
+		std::vector<VkPresentModeKHR> preferredModes;
 
-		for (const auto &availablePresentMode : availablePresentModes)
+		switch (this->presentMode)
 		{
-			if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
-			{
-				return availablePresentMode;
-			}
-			else if (availablePresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR)
-			{
-				bestMode = availablePresentMode;
-			}
+			case PresentMode::VSync:
+				preferredModes = { VK_PRESENT_MODE_FIFO_KHR };
+				break;
+			case PresentMode::NoVSync:
+			case PresentMode::LowLatency:
+				preferredModes = { VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_KHR };
+				break;
+			case PresentMode::Mailbox:
+				preferredModes = { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_FIFO_KHR };
+				break;
+		}
+
+		for (VkPresentModeKHR preferredMode : preferredModes)
+		{
+			if (std::find(availablePresentModes.begin(), availablePresentModes.end(), preferredMode) != availablePresentModes.end())
+				return preferredMode;
 		}
 
-		return bestMode;
+		return VK_PRESENT_MODE_FIFO_KHR;
 	}
 
 	VkExtent2D VulkanContext::chooseSwapExtent(const VkSurfaceCapabilitiesKHR &capabilities)
@@ -494,16 +682,12 @@ namespace Viper
 		{
 			return capabilities.currentExtent;
 		}
-		else
-		{
-			int width, height;
-			glfwGetFramebufferSize(this->windowHandle, &width, &height);
-		}
 
+		// framebuffer size as seen by the main thread when the frame was handed over
 		VkExtent2D actualExtent =
 		{
-			static_cast<uint32_t>(this->window->getWidth()),
-			static_cast<uint32_t>(this->window->getHeight())
+			this->framebufferWidth,
+			this->framebufferHeight
 		};
 
 		actualExtent.width = std::max(capabilities.minImageExtent.width, std::min(capabilities.maxImageExtent.width, actualExtent.width));
@@ -525,7 +709,13 @@ namespace Viper
 		VkExtent2D extent = this->chooseSwapExtent(swapChainSupport.capabilities);
 
 		// We have to decide how many images we would like to have in the swap chain. 
+		// One more than the minimum avoids waiting on the driver, the low latency policy keeps the queue as short as possible.
 		uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
+		if (this->presentMode == PresentMode::LowLatency)
+		{
+			imageCount = swapChainSupport.capabilities.minImageCount;
+		}
+
 		if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount)
 		{
 			imageCount = swapChainSupport.capabilities.maxImageCount;
@@ -545,7 +735,9 @@ namespace Viper
 		createInfo.imageArrayLayers = 1;
 
 		// The imageUsage bit field specifies what kind of operations we'll use the images in the swap chain for. 
-		createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+		// The scene is rendered offscreen and blitted into the swap chain image, so it has to be a transfer destination.
+		V_CORE_ASSERT(swapChainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT, "swap chain images can't be a transfer destination!");
+		createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
 
 		// We need to specify how to handle swap chain images that will be used across multiple queue families.
 		// We'll be drawing on the images in the swap chain from the graphics queue and then submitting them on the presentation queue
@@ -593,15 +785,20 @@ namespace Viper
 
 	/******************** Recreating the swap chain ********************/
 
-	void VulkanContext::recreateSwapChain()
+	bool VulkanContext::recreateSwapChain()
 	{
-		// pause program if window is minimalized
-		int width = 0, height = 0;
-		while (width == 0 || height == 0)
-		{
-			glfwGetFramebufferSize(this->windowHandle, &width, &height);
-			glfwWaitEvents();
-		}
+		/*
+			Runs on the render thread. The main thread does not hand over frames while the window is minimized,
+			but the surface can still shrink to nothing in between - then the frame is skipped and the next one tries again.
+		*/
+
+		V_PROFILE_FUNCTION();
+
+		VkSurfaceCapabilitiesKHR capabilities;
+		vkGetPhysicalDeviceSurfaceCapabilitiesKHR(this->physicalDevice, this->surface, &capabilities);
+
+		if (capabilities.currentExtent.width == 0 || capabilities.currentExtent.height == 0)
+			return false;
 
 		vkDeviceWaitIdle(this->device);
 
@@ -611,8 +808,16 @@ namespace Viper
 		this->createImageViews();
 		this->createRenderPass();
 		this->createGraphicsPipeline();
+		this->createOverlayRenderPass();
+		this->createOverlayPipeline();
+		this->createDepthResources();
+		this->createSceneResources();
 		this->createFramebuffers();
+		this->createOverlayFramebuffers();
 		this->createCommandBuffers();
+
+		this->swapChainOutOfDate = false;
+		return true;
 	}
 
 	void VulkanContext::cleanupSwapChain()
@@ -621,9 +826,26 @@ namespace Viper
 			Cleanup swap chain memory
 		*/
 
-		for (auto framebuffer : this->swapChainFramebuffers)
+		vkDestroyImageView(this->device, this->depthImageView, nullptr);
+		vkDestroyImage(this->device, this->depthImage, nullptr);
+		this->freeDeviceMemory(this->depthImageMemory);
+
+		vkDestroyImageView(this->device, this->sceneImageView, nullptr);
+		vkDestroyImage(this->device, this->sceneImage, nullptr);
+		this->freeDeviceMemory(this->sceneImageMemory);
+
+		vkDestroyFramebuffer(this->device, this->sceneFramebuffer, nullptr);
+
+		for (VkFramebuffer framebuffer : this->overlayFramebuffers)
 			vkDestroyFramebuffer(this->device, framebuffer, nullptr);
 
+		// the overlay pipeline is missing when its shaders are not compiled
+		vkDestroyPipeline(this->device, this->overlayPipeline, nullptr);
+		vkDestroyPipelineLayout(this->device, this->overlayPipelineLayout, nullptr);
+		vkDestroyRenderPass(this->device, this->overlayRenderPass, nullptr);
+		this->overlayPipeline = VK_NULL_HANDLE;
+		this->overlayPipelineLayout = VK_NULL_HANDLE;
+
 		vkFreeCommandBuffers(this->device, this->commandPool, static_cast<uint32_t>(this->commandBuffers.size()), this->commandBuffers.data());
 		vkDestroyPipeline(this->device, this->graphicsPipeline, nullptr);
 		vkDestroyPipelineLayout(this->device, this->pipelineLayout, nullptr);
@@ -648,38 +870,340 @@ namespace Viper
 		this->swapChainImageViews.resize(this->swapChainImages.size());
 
 		for (std::size_t i = 0; i < this->swapChainImages.size(); i++)
+			this->swapChainImageViews[i] = this->createImageView(this->swapChainImages[i], this->swapChainImageFormat, VK_IMAGE_ASPECT_COLOR_BIT);
+	}
+
+	VkImageView VulkanContext::createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags)
+	{
+		VkImageViewCreateInfo createInfo = {};
+		createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		createInfo.image = image;
+
+		// The viewType and format fields specify how the image data should be interpreted. 
+		// The viewType parameter allows you to treat images as 1D textures, 2D textures, 3D textures and cube maps.
+		createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		createInfo.format = format;
+
+		// The components field allows you to swizzle the color channels around.
+		createInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+		createInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+		createInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+		createInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+
+		// The subresourceRange field describes what the image's purpose is and which part of the image should be accessed. 
+		createInfo.subresourceRange.aspectMask = aspectFlags;
+		createInfo.subresourceRange.baseMipLevel = 0;
+		createInfo.subresourceRange.levelCount = 1;
+		createInfo.subresourceRange.baseArrayLayer = 0;
+		createInfo.subresourceRange.layerCount = 1;
+
+		VkImageView imageView;
+		if (vkCreateImageView(this->device, &createInfo, nullptr, &imageView) != VK_SUCCESS)
+			throw std::runtime_error("failed to create image views!");
+
+		return imageView;
+	}
+
+
+
+	/******************** Depth buffering ********************/
+
+	void VulkanContext::createDepthResources()
+	{
+		/*
+			A depth attachment is based on an image, just like the color attachment.
+			It has the same resolution as the scene color target and is recreated together with the swap chain.
+		*/
+
+		this->depthFormat = this->findDepthFormat();
+
+		this->createImage(this->swapChainExtent.width, this->swapChainExtent.height, this->depthFormat, VK_IMAGE_TILING_OPTIMAL,
+						  VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, this->depthImage, this->depthImageMemory);
+
+		this->depthImageView = this->createImageView(this->depthImage, this->depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
+
+		// the layout transition UNDEFINED -> DEPTH_STENCIL_ATTACHMENT_OPTIMAL is done by the render pass
+	}
+
+
+
+	/******************** Dynamic resolution ********************/
+
+	void VulkanContext::createSceneResources()
+	{
+		/*
+			The scene is rendered into an offscreen color target instead of the swap chain image.
+			The target is allocated at the full swap chain resolution, every frame only its top-left
+			renderExtent part is drawn to and then blitted (scaled up) over the whole swap chain image.
+			Changing the render scale therefore never reallocates anything.
+		*/
+
+		this->createImage(this->swapChainExtent.width, this->swapChainExtent.height, this->swapChainImageFormat, VK_IMAGE_TILING_OPTIMAL,
+						  VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+						  this->sceneImage, this->sceneImageMemory);
+
+		this->sceneImageView = this->createImageView(this->sceneImage, this->swapChainImageFormat, VK_IMAGE_ASPECT_COLOR_BIT);
+
+		// the scene target and the swap chain share the format, it is both the source and the destination of the upscale blit
+		VkFormatProperties properties;
+		vkGetPhysicalDeviceFormatProperties(this->physicalDevice, this->swapChainImageFormat, &properties);
+
+		V_CORE_ASSERT(properties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_SRC_BIT, "swap chain format can't be used as a blit source!");
+		V_CORE_ASSERT(properties.optimalTilingFeatures & VK_FORMAT_FEATURE_BLIT_DST_BIT, "swap chain format can't be used as a blit destination!");
+
+		// bilinear upscale if the format supports filtered blits
+
+		if (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+			this->blitFilter = VK_FILTER_LINEAR;
+		else
+			this->blitFilter = VK_FILTER_NEAREST;
+
+		this->renderExtent = this->swapChainExtent;
+	}
+
+	void VulkanContext::createTimestampQueries()
+	{
+		/*
+			Two timestamps per frame in flight bracket the frame's command buffer.
+			They are read back once the frame's fence is signaled, so reading never stalls.
+		*/
+
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(this->physicalDevice, &properties);
+
+		QueueFamilyIndices indices = this->findQueueFamilies(this->physicalDevice);
+
+		uint32_t queueFamilyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(this->physicalDevice, &queueFamilyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(this->physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+		uint32_t validBits = queueFamilies[indices.graphicsFamily.value()].timestampValidBits;
+
+		// without timestamps the render scale stays where it is
+		if (validBits == 0)
+		{
+			V_CORE_WARN("GPU timestamps are not supported, dynamic resolution is disabled");
+			return;
+		}
+
+		this->timestampPeriod = properties.limits.timestampPeriod;
+		this->timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+		VkQueryPoolCreateInfo queryPoolInfo = {};
+
+		queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		queryPoolInfo.queryCount = MAX_FRAMES_IN_FLIGHT * TIMESTAMPS_PER_FRAME;
+
+		if (vkCreateQueryPool(this->device, &queryPoolInfo, nullptr, &this->timestampPool) != VK_SUCCESS)
+			throw std::runtime_error("failed to create timestamp query pool!");
+
+		this->timestampsWritten.assign(MAX_FRAMES_IN_FLIGHT, false);
+	}
+
+	void VulkanContext::readGpuTime()
+	{
+		/*
+			Read the timestamps of the frame that last used the current frame slot and feed the measured time to the scale controller.
+			Must be called after the frame's fence has been waited on.
+		*/
+
+		if (this->timestampPool == VK_NULL_HANDLE || !this->timestampsWritten[this->currentFrame])
+			return;
+
+		uint64_t timestamps[TIMESTAMPS_PER_FRAME];
+
+		VkResult result = vkGetQueryPoolResults(this->device, this->timestampPool, (uint32_t)this->currentFrame * TIMESTAMPS_PER_FRAME, TIMESTAMPS_PER_FRAME,
+												sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+		if (result != VK_SUCCESS)
+			return;
+
+		uint64_t ticks = (timestamps[1] - timestamps[0]) & this->timestampMask;
+		this->gpuTime = static_cast<float>(ticks * (double)this->timestampPeriod / 1000000.0);
+
+		this->dynamicResolution.update(this->gpuTime);
+	}
+
+	void VulkanContext::updateRenderExtent()
+	{
+		float scale = this->dynamicResolution.getScale();
+
+		this->renderExtent.width = std::max(1u, (uint32_t)(this->swapChainExtent.width * scale + 0.5f));
+		this->renderExtent.height = std::max(1u, (uint32_t)(this->swapChainExtent.height * scale + 0.5f));
+
+		this->renderExtent.width = std::min(this->renderExtent.width, this->swapChainExtent.width);
+		this->renderExtent.height = std::min(this->renderExtent.height, this->swapChainExtent.height);
+	}
+
+	void VulkanContext::blitToSwapChain(VkCommandBuffer commandBuffer, uint32_t imageIndex, bool present)
+	{
+		/*
+			Upscale the rendered part of the scene target over the whole swap chain image.
+			The render pass leaves the scene target in TRANSFER_SRC_OPTIMAL, the swap chain image is transitioned around the blit.
+			Without present the swap chain image stays in TRANSFER_DST_OPTIMAL for the overlay pass, which transitions it for presentation.
+		*/
+
+		VkImageMemoryBarrier barrier = {};
+
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = this->swapChainImages[imageIndex];
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+
+		// previous contents are overwritten entirely
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		VkImageBlit blit = {};
+
+		blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		blit.srcSubresource.layerCount = 1;
+		blit.srcOffsets[0] = { 0, 0, 0 };
+		blit.srcOffsets[1] = { (int32_t)this->renderExtent.width, (int32_t)this->renderExtent.height, 1 };
+
+		blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		blit.dstSubresource.layerCount = 1;
+		blit.dstOffsets[0] = { 0, 0, 0 };
+		blit.dstOffsets[1] = { (int32_t)this->swapChainExtent.width, (int32_t)this->swapChainExtent.height, 1 };
+
+		vkCmdBlitImage(commandBuffer, this->sceneImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+					   this->swapChainImages[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, this->blitFilter);
+
+		if (!present)
+			return;
+
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = 0;
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+	}
+
+	VkFormat VulkanContext::findSupportedFormat(const std::vector<VkFormat> &candidates, VkImageTiling tiling, VkFormatFeatureFlags features)
+	{
+		/*
+			Return the first format from the list of candidates (ordered from most desirable to least desirable) that supports the requested features.
+		*/
+
+		for (VkFormat format : candidates)
 		{
-			VkImageViewCreateInfo createInfo = {};
-			createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-			createInfo.image = this->swapChainImages[i];
-
-			// The viewType and format fields specify how the image data should be interpreted. 
-			// The viewType parameter allows you to treat images as 1D textures, 2D textures, 3D textures and cube maps.
-			createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-			createInfo.format = this->swapChainImageFormat;
-
-			// The components field allows you to swizzle the color channels around.
-			createInfo.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
-			createInfo.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
-			createInfo.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
-			createInfo.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
-
-			// The subresourceRange field describes what the image's purpose is and which part of the image should be accessed. 
-			createInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-			createInfo.subresourceRange.baseMipLevel = 0;
-			createInfo.subresourceRange.levelCount = 1;
-			createInfo.subresourceRange.baseArrayLayer = 0;
-			createInfo.subresourceRange.layerCount = 1;
-
-			if (vkCreateImageView(this->device, &createInfo, nullptr, &this->swapChainImageViews[i]) != VK_SUCCESS)
-				throw std::runtime_error("failed to create image views!");
+			VkFormatProperties properties;
+			vkGetPhysicalDeviceFormatProperties(this->physicalDevice, format, &properties);
+
+			if (tiling == VK_IMAGE_TILING_LINEAR && (properties.linearTilingFeatures & features) == features)
+				return format;
+			else if (tiling == VK_IMAGE_TILING_OPTIMAL && (properties.optimalTilingFeatures & features) == features)
+				return format;
 		}
+
+		throw std::runtime_error("failed to find supported format!");
+	}
+
+	VkFormat VulkanContext::findDepthFormat()
+	{
+		return this->findSupportedFormat({ VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT },
+										 VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
+	}
+
+	bool VulkanContext::hasStencilComponent(VkFormat format)
+	{
+		return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
+	}
+
+	void VulkanContext::createImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage &image, VkDeviceMemory &imageMemory)
+	{
+		// Image creation
+		VkImageCreateInfo imageInfo = {};
+
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.extent.width = width;
+		imageInfo.extent.height = height;
+		imageInfo.extent.depth = 1;
+		imageInfo.mipLevels = 1;
+		imageInfo.arrayLayers = 1;
+		imageInfo.format = format;
+		imageInfo.tiling = tiling;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		imageInfo.usage = usage;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+		if (vkCreateImage(this->device, &imageInfo, nullptr, &image) != VK_SUCCESS)
+			throw std::runtime_error("failed to create image!");
+
+
+		// Memory allocation
+		VkMemoryRequirements memRequirements;
+		vkGetImageMemoryRequirements(this->device, image, &memRequirements);
+
+		VkMemoryAllocateInfo allocInfo = {};
+
+		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+		allocInfo.allocationSize = memRequirements.size;
+		allocInfo.memoryTypeIndex = this->findMemoryType(memRequirements.memoryTypeBits, properties);
+
+		if (vkAllocateMemory(this->device, &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
+			throw std::runtime_error("failed to allocate image memory!");
+
+		this->trackDeviceMemory(imageMemory, allocInfo.allocationSize);
+
+
+		// Associate memory with image
+		vkBindImageMemory(this->device, image, imageMemory, 0);
 	}
 
 
 
 	/******************** Graphics pipeline ********************/
 
+	void VulkanContext::createDescriptorSetLayout()
+	{
+		/*
+			The descriptor set layout describes the resources the shaders access.
+			Binding 0 holds the per-frame camera data; it is a dynamic uniform buffer so every frame in flight
+			can point at its own region of the ring buffer through the offset passed at bind time.
+			Binding 1 is the storage buffer with the world matrices of all frames in flight, the pushed transform index
+			already includes the offset of the frame's region.
+		*/
+
+		std::array<VkDescriptorSetLayoutBinding, 2> bindings = {};
+
+		VkDescriptorSetLayoutBinding &cameraLayoutBinding = bindings[0];
+		cameraLayoutBinding.binding = 0;
+		cameraLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		cameraLayoutBinding.descriptorCount = 1;
+		cameraLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+		cameraLayoutBinding.pImmutableSamplers = nullptr; // Optional
+
+		VkDescriptorSetLayoutBinding &transformLayoutBinding = bindings[1];
+		transformLayoutBinding.binding = 1;
+		transformLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		transformLayoutBinding.descriptorCount = 1;
+		transformLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo = {};
+
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+		layoutInfo.pBindings = bindings.data();
+
+		if (vkCreateDescriptorSetLayout(this->device, &layoutInfo, nullptr, &this->descriptorSetLayout) != VK_SUCCESS)
+			throw std::runtime_error("failed to create descriptor set layout!");
+	}
+
 	void VulkanContext::createGraphicsPipeline()
 	{
 		/*
@@ -746,6 +1270,7 @@ namespace Viper
 
 
 		//////////////////// Viewports and scissors
+		// Both are dynamic state set per frame to the scaled render extent, these values are ignored.
 		VkViewport viewport = {};
 		viewport.x = 0.0f;
 		viewport.y = 0.0f;
@@ -811,6 +1336,20 @@ namespace Viper
 		multisampling.alphaToOneEnable = VK_FALSE; // Optional
 
 
+		//////////////////// Depth and stencil state
+		// opaque draws are sorted front-to-back by the render queue, so the depth test rejects occluded fragments early
+		VkPipelineDepthStencilStateCreateInfo depthStencil = {};
+
+		depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+		depthStencil.depthTestEnable = VK_TRUE;
+		depthStencil.depthWriteEnable = VK_TRUE;
+		depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+		depthStencil.depthBoundsTestEnable = VK_FALSE;
+		depthStencil.minDepthBounds = 0.0f; // Optional
+		depthStencil.maxDepthBounds = 1.0f; // Optional
+		depthStencil.stencilTestEnable = VK_FALSE;
+
+
 		//////////////////// Color blending state
 		// blend colors returned from fragment shader
 		VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
@@ -839,7 +1378,7 @@ namespace Viper
 		//////////////////// Dynamic state 
 		VkDynamicState dynamicStates[] = {
 			VK_DYNAMIC_STATE_VIEWPORT,
-			VK_DYNAMIC_STATE_LINE_WIDTH
+			VK_DYNAMIC_STATE_SCISSOR
 		};
 
 		VkPipelineDynamicStateCreateInfo dynamicState = {};
@@ -851,10 +1390,17 @@ namespace Viper
 		VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
 
 		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-		pipelineLayoutInfo.setLayoutCount = 0; // Optional
-		pipelineLayoutInfo.pSetLayouts = nullptr; // Optional
-		pipelineLayoutInfo.pushConstantRangeCount = 0; // Optional
-		pipelineLayoutInfo.pPushConstantRanges = nullptr; // Optional
+		// Per-object transforms (or their index in the transform buffer) are pushed with the draw (68 bytes, well inside the guaranteed 128 bytes of push constant space).
+		VkPushConstantRange pushConstantRange = {};
+
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(ObjectConstants);
+
+		pipelineLayoutInfo.setLayoutCount = 1;
+		pipelineLayoutInfo.pSetLayouts = &this->descriptorSetLayout;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
 
 		if (vkCreatePipelineLayout(this->device, &pipelineLayoutInfo, nullptr, &this->pipelineLayout) != VK_SUCCESS)
 			throw std::runtime_error("failed to create pipeline layout!");
@@ -874,9 +1420,9 @@ namespace Viper
 		pipelineInfo.pViewportState = &viewportState;
 		pipelineInfo.pRasterizationState = &rasterizer;
 		pipelineInfo.pMultisampleState = &multisampling;
-		pipelineInfo.pDepthStencilState = nullptr; // Optional
+		pipelineInfo.pDepthStencilState = &depthStencil;
 		pipelineInfo.pColorBlendState = &colorBlending;
-		pipelineInfo.pDynamicState = nullptr; // Optional
+		pipelineInfo.pDynamicState = &dynamicState;
 
 		pipelineInfo.layout = this->pipelineLayout;
 		pipelineInfo.renderPass = this->renderPass;
@@ -888,6 +1434,9 @@ namespace Viper
 		if (vkCreateGraphicsPipelines(this->device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &this->graphicsPipeline) != VK_SUCCESS)
 			throw std::runtime_error("failed to create graphics pipeline!");
 
+		// DrawCommand::pipeline indexes this table
+		this->pipelines = { this->graphicsPipeline };
+
 		vkDestroyShaderModule(this->device, fragShaderModule, nullptr);
 		vkDestroyShaderModule(this->device, vertShaderModule, nullptr);
 	}
@@ -938,7 +1487,23 @@ namespace Viper
 		colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
 		// The finalLayout specifies the layout to automatically transition to when the render pass finishes. 
-		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		// The scene target is blitted to the swap chain afterwards.
+		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+
+		VkAttachmentDescription depthAttachment = {};
+
+		depthAttachment.format = this->findDepthFormat();
+		depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+
+		// depth is not used after drawing has finished
+		depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+		depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
 
 		//////////////////// Subpasses and attachment references.
@@ -954,34 +1519,51 @@ namespace Viper
 		// The layout specifies which layout we would like the attachment to have during a subpass that uses this reference.
 		colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
+		VkAttachmentReference depthAttachmentRef = {};
+
+		depthAttachmentRef.attachment = 1;
+		depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
 
 		VkSubpassDescription subpass = {};
 
 		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
 		subpass.colorAttachmentCount = 1;
 		subpass.pColorAttachments = &colorAttachmentRef;
+		subpass.pDepthStencilAttachment = &depthAttachmentRef;
 
 
 		//////////////////// Subpass dependencies
-		VkSubpassDependency dependency = {};
-
-		dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-		dependency.dstSubpass = 0;
-		dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-		dependency.srcAccessMask = 0;
-		dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-		dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		// The scene and depth targets are shared by the frames in flight: drawing has to wait for the previous frame's
+		// blit (transfer read) and depth writes, and the following blit has to wait for the color writes.
+		std::array<VkSubpassDependency, 2> dependencies = {};
+
+		dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[0].dstSubpass = 0;
+		dependencies[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+		dependencies[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+		dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+		dependencies[1].srcSubpass = 0;
+		dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
 
 		//////////////////// Render pass
 		VkRenderPassCreateInfo renderPassInfo = {};
 
+		VkAttachmentDescription attachments[] = { colorAttachment, depthAttachment };
+
 		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-		renderPassInfo.attachmentCount = 1;
-		renderPassInfo.pAttachments = &colorAttachment;
+		renderPassInfo.attachmentCount = 2;
+		renderPassInfo.pAttachments = attachments;
 		renderPassInfo.subpassCount = 1;
 		renderPassInfo.pSubpasses = &subpass;
-		renderPassInfo.dependencyCount = 1;
-		renderPassInfo.pDependencies = &dependency;
+		renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+		renderPassInfo.pDependencies = dependencies.data();
 
 		if (vkCreateRenderPass(this->device, &renderPassInfo, nullptr, &this->renderPass) != VK_SUCCESS)
 			throw std::runtime_error("failed to create render pass!");
@@ -995,31 +1577,27 @@ namespace Viper
 	{
 		/*
 			A framebuffer object references all of the VkImageView objects that represent the attachments.
+			The scene is drawn into the offscreen target, so a single framebuffer serves every swap chain image.
 		*/
 
-		// resize the container to hold all of the framebuffers
-		this->swapChainFramebuffers.resize(this->swapChainImageViews.size());
-
-		for (size_t i = 0; i < this->swapChainImageViews.size(); i++)
+		VkImageView attachments[] =
 		{
-			VkImageView attachments[] =
-			{
-				this->swapChainImageViews[i]
-			};
+			this->sceneImageView,
+			this->depthImageView
+		};
 
-			VkFramebufferCreateInfo framebufferInfo = {};
+		VkFramebufferCreateInfo framebufferInfo = {};
 
-			framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-			framebufferInfo.renderPass = this->renderPass;
-			framebufferInfo.attachmentCount = 1;
-			framebufferInfo.pAttachments = attachments;
-			framebufferInfo.width = this->swapChainExtent.width;
-			framebufferInfo.height = this->swapChainExtent.height;
-			framebufferInfo.layers = 1;
+		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferInfo.renderPass = this->renderPass;
+		framebufferInfo.attachmentCount = 2;
+		framebufferInfo.pAttachments = attachments;
+		framebufferInfo.width = this->swapChainExtent.width;
+		framebufferInfo.height = this->swapChainExtent.height;
+		framebufferInfo.layers = 1;
 
-			if (vkCreateFramebuffer(this->device, &framebufferInfo, nullptr, &this->swapChainFramebuffers[i]) != VK_SUCCESS)
-				throw std::runtime_error("failed to create framebuffer!");
-		}
+		if (vkCreateFramebuffer(this->device, &framebufferInfo, nullptr, &this->sceneFramebuffer) != VK_SUCCESS)
+			throw std::runtime_error("failed to create framebuffer!");
 	}
 
 
@@ -1038,7 +1616,8 @@ namespace Viper
 
 		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 		poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
-		poolInfo.flags = 0; // optional
+		// command buffers are re-recorded from the render queue every frame
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
 		if (vkCreateCommandPool(this->device, &poolInfo, nullptr, &this->commandPool) != VK_SUCCESS)
 			throw std::runtime_error("failed to create command pool!");
@@ -1050,7 +1629,8 @@ namespace Viper
 			Command buffers are objects used to record commands which can be subsequently submitted to a device queue for execution.
 		*/
 
-		this->commandBuffers.resize(this->swapChainFramebuffers.size());
+		// one command buffer per frame in flight - it is free to be re-recorded once the frame's fence is signaled
+		this->commandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
 
 		VkCommandBufferAllocateInfo allocInfo = {};
 
@@ -1062,59 +1642,136 @@ namespace Viper
 
 		if (vkAllocateCommandBuffers(this->device, &allocInfo, this->commandBuffers.data()) != VK_SUCCESS)
 			throw std::runtime_error("failed to create command buffers!");
+	}
+
+	void VulkanContext::recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, const FramePacket &frame)
+	{
+		/*
+			Record the sorted render queue into the command buffer of the current frame.
+		*/
+
+		V_PROFILE_FUNCTION();
+
+		vkResetCommandBuffer(commandBuffer, 0);
 
 		//////////////////// Starting command buffer recording
+		VkCommandBufferBeginInfo beginInfo = {};
+
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+		beginInfo.pInheritanceInfo = nullptr; // Optional
+
+		if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+			throw std::runtime_error("failed to begin recording command buffer!");
+
+		uint32_t firstQuery = (uint32_t)this->currentFrame * TIMESTAMPS_PER_FRAME;
+
+		if (this->timestampPool != VK_NULL_HANDLE)
+		{
+			vkCmdResetQueryPool(commandBuffer, this->timestampPool, firstQuery, TIMESTAMPS_PER_FRAME);
+			vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, this->timestampPool, firstQuery);
+		}
+
+
+		//////////////////// Starting a render pass
+		VkRenderPassBeginInfo renderPassInfo = {};
+
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		renderPassInfo.renderPass = this->renderPass;
+		renderPassInfo.framebuffer = this->sceneFramebuffer;
+		// The render area defines where shader loads and stores will take place.
+		// Only the scaled part of the scene target is cleared and drawn to.
+		renderPassInfo.renderArea.offset = { 0, 0 };
+		renderPassInfo.renderArea.extent = this->renderExtent;
+
+		// The order of clear values has to be identical to the order of the attachments.
+		std::array<VkClearValue, 2> clearValues = {};
+		clearValues[0].color = { 0.0f, 0.0f, 0.0f, 1.0f };
+		clearValues[1].depthStencil = { 1.0f, 0 };
 
-		for (size_t i = 0; i < this->commandBuffers.size(); i++)
+		renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+		renderPassInfo.pClearValues = clearValues.data();
+
+		vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+		VkViewport viewport = {};
+		viewport.width = (float)this->renderExtent.width;
+		viewport.height = (float)this->renderExtent.height;
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+		VkRect2D scissor = {};
+		scissor.extent = this->renderExtent;
+		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+		// draws come out of the queue grouped by state and front-to-back, the state cache drops the redundant binds
+		this->frameStats = RenderStats();
+		this->frameStats.gpuTime = this->gpuTime;
+		this->frameStats.renderScale = this->dynamicResolution.getScale();
+		this->frameStats.renderWidth = this->renderExtent.width;
+		this->frameStats.renderHeight = this->renderExtent.height;
+		this->frameStats.gpuMemory = this->deviceMemoryUsed;
+		this->frameStats.drawsCulled = frame.queue.getCulledCount();
+
+		VulkanStateCache state(commandBuffer, this->frameStats);
+
+		uint32_t cameraOffset = this->allocateUniform(&frame.camera, sizeof(CameraData));
+		uint32_t transformBase = this->uploadTransforms(frame.transforms);
+
+		for (size_t i = 0; i < frame.queue.size(); i++)
 		{
-			VkCommandBufferBeginInfo beginInfo = {};
+			const DrawCommand &command = frame.queue[i];
 
-			beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-			beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
-			beginInfo.pInheritanceInfo = nullptr; // Optional
+			V_CORE_ASSERT(command.pipeline < this->pipelines.size(), "draw command references an unknown pipeline!");
+			V_CORE_ASSERT(command.mesh < this->meshes.size(), "draw command references an unknown mesh!");
 
-			if (vkBeginCommandBuffer(this->commandBuffers[i], &beginInfo) != VK_SUCCESS)
-				throw std::runtime_error("failed to begin recording command buffer!");
+			const VulkanMesh &mesh = this->meshes[command.mesh];
 
+			state.bindPipeline(this->pipelines[command.pipeline], this->pipelineLayout);
+			state.bindDescriptorSet(0, this->descriptorSet, cameraOffset);
+			state.bindVertexBuffer(mesh.vertexBuffer);
+			state.bindIndexBuffer(mesh.indexBuffer, VK_INDEX_TYPE_UINT16);
 
-			//////////////////// Starting a render pass
-			VkRenderPassBeginInfo renderPassInfo = {};
+			ObjectConstants constants;
+			constants.model = command.transform;
+			constants.transformIndex = DrawCommand::NoTransform;
 
-			renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-			renderPassInfo.renderPass = this->renderPass;
-			renderPassInfo.framebuffer = this->swapChainFramebuffers[i];
-			// The render area defines where shader loads and stores will take place.
-			renderPassInfo.renderArea.offset = { 0, 0 };
-			renderPassInfo.renderArea.extent = this->swapChainExtent;
+			if (command.transformIndex != DrawCommand::NoTransform)
+			{
+				V_CORE_ASSERT(command.transformIndex < frame.transforms.size(), "draw command references a transform that wasn't set for the frame!");
+				constants.transformIndex = transformBase + command.transformIndex;
+			}
 
-			VkClearValue clearColor = { 0.0f, 0.0f, 0.0f, 1.0f };
-			renderPassInfo.clearValueCount = 1;
-			renderPassInfo.pClearValues = &clearColor;
+			vkCmdPushConstants(commandBuffer, this->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(ObjectConstants), &constants);
+			state.drawIndexed(command.indexCount, command.firstIndex, command.vertexOffset);
+		}
 
-			vkCmdBeginRenderPass(this->commandBuffers[i], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-			vkCmdBindPipeline(this->commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, this->graphicsPipeline);
+		vkCmdEndRenderPass(commandBuffer);
 
-			// Binding the vertex buffer
-			VkBuffer vertexBuffers[] = { this->vertexBuffer };
-			VkDeviceSize offsets[] = { 0 };
-			vkCmdBindVertexBuffers(this->commandBuffers[i], 0, 1, vertexBuffers, offsets);
+		// the overlay pass takes the swap chain image over from the blit and hands it to presentation
+		bool drawOverlay = this->overlayPipeline != VK_NULL_HANDLE && !frame.overlay.empty();
 
-			// Using an index buffer
-			vkCmdBindIndexBuffer(this->commandBuffers[i], this->indexBuffer, 0, VK_INDEX_TYPE_UINT16);
+		this->blitToSwapChain(commandBuffer, imageIndex, !drawOverlay);
 
-			vkCmdDrawIndexed(this->commandBuffers[i], static_cast<uint32_t>(this->indices.size()), 1, 0, 0, 0);
-			vkCmdEndRenderPass(this->commandBuffers[i]);
+		if (drawOverlay)
+			this->recordOverlay(commandBuffer, imageIndex, frame.overlay);
 
-			if (vkEndCommandBuffer(this->commandBuffers[i]) != VK_SUCCESS)
-				throw std::runtime_error("failed to record command buffer!");
+		if (this->timestampPool != VK_NULL_HANDLE)
+		{
+			vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, this->timestampPool, firstQuery + 1);
+			this->timestampsWritten[this->currentFrame] = true;
 		}
+
+		if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+			throw std::runtime_error("failed to record command buffer!");
 	}
 
 
 
 	/******************** Drawing ********************/
 
-	void VulkanContext::drawFrame()
+	void VulkanContext::drawFrame(FramePacket &frame)
 	{
 		/*
 			- Acquire an image from the swap chain
@@ -1122,8 +1779,30 @@ namespace Viper
 			- Return the image to the swap chain for presentation
 		*/
 
-		// The vkWaitForFences function takes an array of fences and waits for either any or all of them to be signaled before returning.
-		vkWaitForFences(this->device, 1, &this->inFlightFences[this->currentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max());
+		V_PROFILE_FUNCTION();
+
+		{
+			V_PROFILE_SCOPE("Wait for frame fence");
+			// The vkWaitForFences function takes an array of fences and waits for either any or all of them to be signaled before returning.
+			vkWaitForFences(this->device, 1, &this->inFlightFences[this->currentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max());
+		}
+
+		// the GPU time of the frame that used this slot picks the resolution of this one
+		this->readGpuTime();
+
+		double recordStart = glfwGetTime();
+
+		// settings of the swap chain follow the main thread's state at hand over
+		this->framebufferWidth = frame.framebufferWidth;
+		this->framebufferHeight = frame.framebufferHeight;
+		this->presentMode = frame.presentMode;
+
+		// window resized, presentation policy changed or the last present reported the swap chain out of date
+		if (frame.swapChainInvalid)
+			this->swapChainOutOfDate = true;
+
+		if (this->swapChainOutOfDate && !this->recreateSwapChain())
+			return;
 
 		//////////////////// Acquire an image from the swap chain
 
@@ -1134,7 +1813,7 @@ namespace Viper
 		// Now we just need to figure out when swap chain recreation is necessary and call our new recreateSwapChain function. 
 		if (result == VK_ERROR_OUT_OF_DATE_KHR)
 		{
-			this->recreateSwapChain();
+			this->swapChainOutOfDate = true;
 			return;
 		}
 		else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
@@ -1142,19 +1821,29 @@ namespace Viper
 			throw std::runtime_error("failed to acquire swap chain image!");
 		}
 
+		//////////////////// Sort the frame's draws and record them
+		// the fence of this frame is signaled, so its uniform region is no longer read by the GPU
+		this->uniformHead = 0;
+
+		this->updateRenderExtent();
+
+		frame.queue.sort();
+		this->recordCommandBuffer(this->commandBuffers[this->currentFrame], imageIndex, frame);
+
 		//////////////////// Queue submission and synchronization is configured through parameters in the VkSubmitInfo structure.
 		VkSubmitInfo submitInfo = {};
 
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
 		VkSemaphore waitSemaphores[] = { this->imageAvailableSemaphores[this->currentFrame] };
-		VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+		// the swap chain image is first touched by the blit
+		VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_TRANSFER_BIT };
 		submitInfo.waitSemaphoreCount = 1;
 		submitInfo.pWaitSemaphores = waitSemaphores;
 		submitInfo.pWaitDstStageMask = waitStages;
 
 		submitInfo.commandBufferCount = 1;
-		submitInfo.pCommandBuffers = &this->commandBuffers[imageIndex];
+		submitInfo.pCommandBuffers = &this->commandBuffers[this->currentFrame];
 
 		VkSemaphore signalSemaphores[] = { this->renderFinishedSemaphores[this->currentFrame] };
 		submitInfo.signalSemaphoreCount = 1;
@@ -1166,6 +1855,8 @@ namespace Viper
 		if (vkQueueSubmit(this->graphicsQueue, 1, &submitInfo, this->inFlightFences[this->currentFrame]) != VK_SUCCESS)
 			throw std::runtime_error("failed to submit draw command buffer!");
 
+		this->frameStats.renderThreadTime = static_cast<float>((glfwGetTime() - recordStart) * 1000.0);
+
 		//////////////////// Presentation
 		VkPresentInfoKHR presentInfo = {};
 
@@ -1181,19 +1872,31 @@ namespace Viper
 		result = vkQueuePresentKHR(this->presentQueue, &presentInfo);
 
 
-		// check if window has been resized
-		if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || this->window->getFramebufferResizeState())
+		// with the low latency policy the next frame samples its input only after this one is out, other policies keep MAX_FRAMES_IN_FLIGHT frames queued
+		if (this->presentMode == PresentMode::LowLatency)
+			vkQueueWaitIdle(this->presentQueue);
+
+		//////////////////// Frame timing
+		double presentTime = glfwGetTime();
+
+		if (this->lastPresentTime > 0.0)
+			this->frameStats.frameTime = static_cast<float>((presentTime - this->lastPresentTime) * 1000.0);
+		this->lastPresentTime = presentTime;
+
+		if (frame.inputTimestamp > 0.0)
+			this->inputLatency = static_cast<float>((presentTime - frame.inputTimestamp) * 1000.0);
+		this->frameStats.inputLatency = this->inputLatency;
+
+		// the swap chain is recreated at the start of the next frame
+		if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
 		{
-			this->window->setFramebufferResizeState(false);
-			this->recreateSwapChain();
+			this->swapChainOutOfDate = true;
 		}
 		else if (result != VK_SUCCESS)
 		{
 			throw std::runtime_error("failed to present swap chain image!");
 		}
 
-		vkQueueWaitIdle(this->presentQueue);
-
 		this->currentFrame = (this->currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
 	}
 
@@ -1259,6 +1962,8 @@ namespace Viper
 		if (vkAllocateMemory(this->device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS)
 			throw std::runtime_error("failed to allocate vertex buffer memory!");
 
+		this->trackDeviceMemory(bufferMemory, allocInfo.allocationSize);
+
 
 		// Associate memory with buffer
 		vkBindBufferMemory(this->device, buffer, bufferMemory, 0);
@@ -1331,7 +2036,26 @@ namespace Viper
 		this->copyBuffer(stagingBuffer, this->vertexBuffer, bufferSize);
 
 		vkDestroyBuffer(this->device, stagingBuffer, nullptr);
-		vkFreeMemory(this->device, stagingBufferMemory, nullptr);
+		this->freeDeviceMemory(stagingBufferMemory);
+	}
+
+	void VulkanContext::trackDeviceMemory(VkDeviceMemory memory, VkDeviceSize size)
+	{
+		this->deviceAllocations[memory] = size;
+		this->deviceMemoryUsed += size;
+	}
+
+	void VulkanContext::freeDeviceMemory(VkDeviceMemory memory)
+	{
+		auto it = this->deviceAllocations.find(memory);
+
+		if (it != this->deviceAllocations.end())
+		{
+			this->deviceMemoryUsed -= it->second;
+			this->deviceAllocations.erase(it);
+		}
+
+		vkFreeMemory(this->device, memory, nullptr);
 	}
 
 	uint32_t VulkanContext::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
@@ -1368,7 +2092,449 @@ namespace Viper
 		copyBuffer(stagingBuffer, this->indexBuffer, bufferSize);
 
 		vkDestroyBuffer(this->device, stagingBuffer, nullptr);
-		vkFreeMemory(this->device, stagingBufferMemory, nullptr);
+		this->freeDeviceMemory(stagingBufferMemory);
+	}
+
+
+
+	/******************** Uniform buffers ********************/
+
+	void VulkanContext::createUniformBuffer()
+	{
+		/*
+			One host visible buffer that stays mapped for the lifetime of the context.
+			It is split into a region per frame in flight, so the CPU never writes data the GPU may still be reading.
+		*/
+
+		VkPhysicalDeviceProperties properties;
+		vkGetPhysicalDeviceProperties(this->physicalDevice, &properties);
+
+		// dynamic offsets have to be multiples of minUniformBufferOffsetAlignment
+		VkDeviceSize alignment = properties.limits.minUniformBufferOffsetAlignment;
+		this->uniformAlignment = (sizeof(CameraData) + alignment - 1) & ~(alignment - 1);
+		this->uniformFrameSize = this->uniformAlignment * UNIFORM_SLOTS_PER_FRAME;
+
+		VkDeviceSize bufferSize = this->uniformFrameSize * MAX_FRAMES_IN_FLIGHT;
+
+		this->createBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, this->uniformBuffer, this->uniformBufferMemory);
+
+		void *data;
+		vkMapMemory(this->device, this->uniformBufferMemory, 0, bufferSize, 0, &data);
+		this->uniformBufferMapped = static_cast<uint8_t *>(data);
+	}
+
+	void VulkanContext::createDescriptorPool()
+	{
+		std::array<VkDescriptorPoolSize, 2> poolSizes = {};
+		poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		poolSizes[0].descriptorCount = 1;
+		poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		poolSizes[1].descriptorCount = 1;
+
+		VkDescriptorPoolCreateInfo poolInfo = {};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+		poolInfo.pPoolSizes = poolSizes.data();
+		poolInfo.maxSets = 1;
+
+		if (vkCreateDescriptorPool(this->device, &poolInfo, nullptr, &this->descriptorPool) != VK_SUCCESS)
+			throw std::runtime_error("failed to create descriptor pool!");
+	}
+
+	void VulkanContext::createDescriptorSet()
+	{
+		/*
+			A single descriptor set covers all frames in flight - the frame's region is selected with the dynamic offset.
+		*/
+
+		VkDescriptorSetAllocateInfo allocInfo = {};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = this->descriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &this->descriptorSetLayout;
+
+		if (vkAllocateDescriptorSets(this->device, &allocInfo, &this->descriptorSet) != VK_SUCCESS)
+			throw std::runtime_error("failed to allocate descriptor set!");
+
+		VkDescriptorBufferInfo bufferInfo = {};
+		bufferInfo.buffer = this->uniformBuffer;
+		bufferInfo.offset = 0;
+		bufferInfo.range = sizeof(CameraData);
+
+		VkDescriptorBufferInfo transformBufferInfo = {};
+		transformBufferInfo.buffer = this->transformBuffer;
+		transformBufferInfo.offset = 0;
+		transformBufferInfo.range = VK_WHOLE_SIZE;
+
+		std::array<VkWriteDescriptorSet, 2> descriptorWrites = {};
+
+		descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[0].dstSet = this->descriptorSet;
+		descriptorWrites[0].dstBinding = 0;
+		descriptorWrites[0].dstArrayElement = 0;
+		descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+		descriptorWrites[0].descriptorCount = 1;
+		descriptorWrites[0].pBufferInfo = &bufferInfo;
+
+		descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[1].dstSet = this->descriptorSet;
+		descriptorWrites[1].dstBinding = 1;
+		descriptorWrites[1].dstArrayElement = 0;
+		descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		descriptorWrites[1].descriptorCount = 1;
+		descriptorWrites[1].pBufferInfo = &transformBufferInfo;
+
+		vkUpdateDescriptorSets(this->device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+	}
+
+	uint32_t VulkanContext::allocateUniform(const void *data, VkDeviceSize size)
+	{
+		/*
+			Copy data into the current frame's region and return the dynamic offset that addresses it.
+		*/
+
+		V_CORE_ASSERT(size <= this->uniformAlignment, "uniform data is larger than a uniform slot!");
+		V_CORE_ASSERT(this->uniformHead + this->uniformAlignment <= this->uniformFrameSize, "out of uniform slots for this frame!");
+
+		VkDeviceSize offset = this->currentFrame * this->uniformFrameSize + this->uniformHead;
+		this->uniformHead += this->uniformAlignment;
+
+		memcpy(this->uniformBufferMapped + offset, data, (size_t)size);
+
+		return static_cast<uint32_t>(offset);
+	}
+
+	void VulkanContext::createTransformBuffer()
+	{
+		/*
+			Host visible storage buffer for the world matrices, mapped for the lifetime of the context.
+			Like the uniform buffer it has a region per frame in flight, the matrices of a frame are written with a single copy.
+		*/
+
+		VkDeviceSize bufferSize = sizeof(glm::mat4) * MAX_TRANSFORMS * MAX_FRAMES_IN_FLIGHT;
+
+		this->createBuffer(bufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, this->transformBuffer, this->transformBufferMemory);
+
+		void *data;
+		vkMapMemory(this->device, this->transformBufferMemory, 0, bufferSize, 0, &data);
+		this->transformBufferMapped = static_cast<glm::mat4 *>(data);
+	}
+
+	uint32_t VulkanContext::uploadTransforms(const std::vector<glm::mat4> &transforms)
+	{
+		/*
+			Copy the frame's world matrices into the current frame's region and return the index of its first matrix.
+		*/
+
+		uint32_t base = static_cast<uint32_t>(this->currentFrame * MAX_TRANSFORMS);
+
+		if (!transforms.empty())
+			memcpy(this->transformBufferMapped + base, transforms.data(), transforms.size() * sizeof(glm::mat4));
+
+		return base;
+	}
+
+
+
+
+	/******************** Overlay ********************/
+
+	void VulkanContext::createOverlayRenderPass()
+	{
+		/*
+			Draws on top of the swap chain image after the upscale blit.
+			The image is loaded as the blit left it and handed to presentation when the pass finishes.
+		*/
+
+		VkAttachmentDescription colorAttachment = {};
+
+		colorAttachment.format = this->swapChainImageFormat;
+		colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		colorAttachment.initialLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+		VkAttachmentReference colorAttachmentRef = {};
+
+		colorAttachmentRef.attachment = 0;
+		colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+		VkSubpassDescription subpass = {};
+
+		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpass.colorAttachmentCount = 1;
+		subpass.pColorAttachments = &colorAttachmentRef;
+
+		// blending reads what the blit wrote, presentation waits for the overlay
+		std::array<VkSubpassDependency, 2> dependencies = {};
+
+		dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[0].dstSubpass = 0;
+		dependencies[0].srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		dependencies[0].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		dependencies[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+		dependencies[1].srcSubpass = 0;
+		dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[1].dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+		dependencies[1].dstAccessMask = 0;
+
+		VkRenderPassCreateInfo renderPassInfo = {};
+
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		renderPassInfo.attachmentCount = 1;
+		renderPassInfo.pAttachments = &colorAttachment;
+		renderPassInfo.subpassCount = 1;
+		renderPassInfo.pSubpasses = &subpass;
+		renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+		renderPassInfo.pDependencies = dependencies.data();
+
+		if (vkCreateRenderPass(this->device, &renderPassInfo, nullptr, &this->overlayRenderPass) != VK_SUCCESS)
+			throw std::runtime_error("failed to create overlay render pass!");
+	}
+
+	void VulkanContext::createOverlayPipeline()
+	{
+		/*
+			Alpha blended screen space quads, no depth. The overlay is optional: without its compiled shaders
+			the pipeline stays VK_NULL_HANDLE and frames are presented straight after the blit.
+		*/
+
+		const char *vertPath = "..//Viper//src//Viper//Renderer//Shaders//overlay_vert.spv";
+		const char *fragPath = "..//Viper//src//Viper//Renderer//Shaders//overlay_frag.spv";
+
+		if (!std::filesystem::exists(vertPath) || !std::filesystem::exists(fragPath))
+		{
+			V_CORE_WARN("Overlay shaders are not compiled, the overlay is disabled");
+			return;
+		}
+
+		auto vertShaderCode = readFile(vertPath);
+		auto fragShaderCode = readFile(fragPath);
+
+		VkShaderModule vertShaderModule = this->createShaderModule(vertShaderCode);
+		VkShaderModule fragShaderModule = this->createShaderModule(fragShaderCode);
+
+		VkPipelineShaderStageCreateInfo shaderStages[2] = {};
+
+		shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		shaderStages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+		shaderStages[0].module = vertShaderModule;
+		shaderStages[0].pName = "main";
+
+		shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+		shaderStages[1].module = fragShaderModule;
+		shaderStages[1].pName = "main";
+
+		//////////////////// Vertex input
+		VkVertexInputBindingDescription bindingDescription = {};
+
+		bindingDescription.binding = 0;
+		bindingDescription.stride = sizeof(OverlayVertex);
+		bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+		std::array<VkVertexInputAttributeDescription, 4> attributeDescriptions = {};
+
+		attributeDescriptions[0] = { 0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(OverlayVertex, position) };
+		attributeDescriptions[1] = { 1, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(OverlayVertex, cell) };
+		attributeDescriptions[2] = { 2, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(OverlayVertex, color) };
+		attributeDescriptions[3] = { 3, 0, VK_FORMAT_R32G32_UINT, offsetof(OverlayVertex, glyph) };
+
+		VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
+
+		vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+		vertexInputInfo.vertexBindingDescriptionCount = 1;
+		vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
+		vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
+		vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+
+		VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+
+		inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+		inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+		inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+		//////////////////// Viewport, rasterizer, multisampling
+		// viewport and scissor are dynamic and cover the whole swap chain image
+		VkPipelineViewportStateCreateInfo viewportState = {};
+
+		viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+		viewportState.viewportCount = 1;
+		viewportState.scissorCount = 1;
+
+		VkPipelineRasterizationStateCreateInfo rasterizer = {};
+
+		rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+		rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+		rasterizer.lineWidth = 1.0f;
+		rasterizer.cullMode = VK_CULL_MODE_NONE;
+		rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
+
+		VkPipelineMultisampleStateCreateInfo multisampling = {};
+
+		multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+		multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+		multisampling.minSampleShading = 1.0f;
+
+		//////////////////// Color blending state
+		VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
+
+		colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+		colorBlendAttachment.blendEnable = VK_TRUE;
+		colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+		colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+		colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+		colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+		colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+
+		VkPipelineColorBlendStateCreateInfo colorBlending = {};
+
+		colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+		colorBlending.logicOpEnable = VK_FALSE;
+		colorBlending.attachmentCount = 1;
+		colorBlending.pAttachments = &colorBlendAttachment;
+
+		VkDynamicState dynamicStates[] = {
+			VK_DYNAMIC_STATE_VIEWPORT,
+			VK_DYNAMIC_STATE_SCISSOR
+		};
+
+		VkPipelineDynamicStateCreateInfo dynamicState = {};
+		dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+		dynamicState.dynamicStateCount = 2;
+		dynamicState.pDynamicStates = dynamicStates;
+
+		//////////////////// Pipeline layout creation
+		// the screen size in pixels is the only input besides the vertices
+		VkPushConstantRange pushConstantRange = {};
+
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+		pushConstantRange.offset = 0;
+		pushConstantRange.size = sizeof(glm::vec2);
+
+		VkPipelineLayoutCreateInfo pipelineLayoutInfo = {};
+
+		pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutInfo.pushConstantRangeCount = 1;
+		pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+		if (vkCreatePipelineLayout(this->device, &pipelineLayoutInfo, nullptr, &this->overlayPipelineLayout) != VK_SUCCESS)
+			throw std::runtime_error("failed to create overlay pipeline layout!");
+
+		VkGraphicsPipelineCreateInfo pipelineInfo = {};
+
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		pipelineInfo.stageCount = 2;
+		pipelineInfo.pStages = shaderStages;
+		pipelineInfo.pVertexInputState = &vertexInputInfo;
+		pipelineInfo.pInputAssemblyState = &inputAssembly;
+		pipelineInfo.pViewportState = &viewportState;
+		pipelineInfo.pRasterizationState = &rasterizer;
+		pipelineInfo.pMultisampleState = &multisampling;
+		pipelineInfo.pColorBlendState = &colorBlending;
+		pipelineInfo.pDynamicState = &dynamicState;
+		pipelineInfo.layout = this->overlayPipelineLayout;
+		pipelineInfo.renderPass = this->overlayRenderPass;
+		pipelineInfo.subpass = 0;
+		pipelineInfo.basePipelineIndex = -1;
+
+		if (vkCreateGraphicsPipelines(this->device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &this->overlayPipeline) != VK_SUCCESS)
+			throw std::runtime_error("failed to create overlay pipeline!");
+
+		vkDestroyShaderModule(this->device, fragShaderModule, nullptr);
+		vkDestroyShaderModule(this->device, vertShaderModule, nullptr);
+	}
+
+	void VulkanContext::createOverlayFramebuffers()
+	{
+		/*
+			The overlay draws straight into the swap chain images, one framebuffer per image.
+		*/
+
+		this->overlayFramebuffers.resize(this->swapChainImageViews.size());
+
+		for (size_t i = 0; i < this->swapChainImageViews.size(); i++)
+		{
+			VkFramebufferCreateInfo framebufferInfo = {};
+
+			framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+			framebufferInfo.renderPass = this->overlayRenderPass;
+			framebufferInfo.attachmentCount = 1;
+			framebufferInfo.pAttachments = &this->swapChainImageViews[i];
+			framebufferInfo.width = this->swapChainExtent.width;
+			framebufferInfo.height = this->swapChainExtent.height;
+			framebufferInfo.layers = 1;
+
+			if (vkCreateFramebuffer(this->device, &framebufferInfo, nullptr, &this->overlayFramebuffers[i]) != VK_SUCCESS)
+				throw std::runtime_error("failed to create overlay framebuffer!");
+		}
+	}
+
+	void VulkanContext::createOverlayVertexBuffer()
+	{
+		/*
+			Persistently mapped like the uniform buffer, with a region of OVERLAY_MAX_VERTICES per frame in flight.
+		*/
+
+		VkDeviceSize bufferSize = sizeof(OverlayVertex) * OVERLAY_MAX_VERTICES * MAX_FRAMES_IN_FLIGHT;
+
+		this->createBuffer(bufferSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, this->overlayVertexBuffer, this->overlayVertexBufferMemory);
+
+		void *data;
+		vkMapMemory(this->device, this->overlayVertexBufferMemory, 0, bufferSize, 0, &data);
+		this->overlayVerticesMapped = static_cast<OverlayVertex *>(data);
+	}
+
+	void VulkanContext::recordOverlay(VkCommandBuffer commandBuffer, uint32_t imageIndex, const OverlayBatch &overlay)
+	{
+		/*
+			Copy the overlay vertices into the current frame's region and draw them in a single call.
+			Vertices past OVERLAY_MAX_VERTICES are dropped.
+		*/
+
+		uint32_t vertexCount = static_cast<uint32_t>(std::min<size_t>(overlay.size(), OVERLAY_MAX_VERTICES));
+		uint32_t firstVertex = (uint32_t)this->currentFrame * OVERLAY_MAX_VERTICES;
+
+		memcpy(this->overlayVerticesMapped + firstVertex, overlay.data(), vertexCount * sizeof(OverlayVertex));
+
+		VkRenderPassBeginInfo renderPassInfo = {};
+
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		renderPassInfo.renderPass = this->overlayRenderPass;
+		renderPassInfo.framebuffer = this->overlayFramebuffers[imageIndex];
+		renderPassInfo.renderArea.offset = { 0, 0 };
+		renderPassInfo.renderArea.extent = this->swapChainExtent;
+
+		vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+		VkViewport viewport = {};
+		viewport.width = (float)this->swapChainExtent.width;
+		viewport.height = (float)this->swapChainExtent.height;
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+		VkRect2D scissor = {};
+		scissor.extent = this->swapChainExtent;
+		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+		glm::vec2 screenSize((float)this->swapChainExtent.width, (float)this->swapChainExtent.height);
+		VkDeviceSize offset = 0;
+
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, this->overlayPipeline);
+		vkCmdPushConstants(commandBuffer, this->overlayPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::vec2), &screenSize);
+		vkCmdBindVertexBuffers(commandBuffer, 0, 1, &this->overlayVertexBuffer, &offset);
+		vkCmdDraw(commandBuffer, vertexCount, 1, firstVertex, 0);
+
+		vkCmdEndRenderPass(commandBuffer);
 	}
 
 
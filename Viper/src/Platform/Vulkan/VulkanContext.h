@@ -3,19 +3,58 @@
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include "Viper/Renderer/GraphicsContext.h"
+#include "Viper/Renderer/DynamicResolution.h"
 #include "Viper/Window.h"
 #include "Platform/Vulkan/VulkanDebugger.h"
+#include "Platform/Vulkan/VulkanStateCache.h"
 
 #include <filesystem>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
 
 namespace Viper
 {
 	struct QueueFamilyIndices;
 	struct SwapChainSupportDetails;
 
+	struct CameraData
+	{
+		glm::mat4 viewProjection;
+	};
+
+	// push constants of the scene pipeline
+	struct ObjectConstants
+	{
+		glm::mat4 model;
+		uint32_t transformIndex;	// into the frame's transform storage buffer region, ~0 = use 'model'
+	};
+
+	// everything the render thread needs from the main thread to draw one frame
+	struct FramePacket
+	{
+		RenderQueue queue;
+		OverlayBatch overlay;
+		CameraData camera = { glm::mat4(1.0f) };
+		std::vector<glm::mat4> transforms;
+		double inputTimestamp = 0.0;
+
+		uint32_t framebufferWidth = 0;
+		uint32_t framebufferHeight = 0;
+		PresentMode presentMode = PresentMode::Mailbox;
+		bool swapChainInvalid = false;
+	};
+
+	struct VulkanMesh
+	{
+		VkBuffer vertexBuffer;
+		VkBuffer indexBuffer;
+	};
+
 	struct Vertex
 	{
-		glm::vec2 pos;
+		glm::vec3 pos;
 		glm::vec3 color;
 
 		static VkVertexInputBindingDescription getBindingDescription()
@@ -36,7 +75,7 @@ namespace Viper
 			// position
 			attributeDescriptions[0].binding = 0;
 			attributeDescriptions[0].location = 0;
-			attributeDescriptions[0].format = VK_FORMAT_R32G32_SFLOAT;
+			attributeDescriptions[0].format = VK_FORMAT_R32G32B32_SFLOAT;
 			attributeDescriptions[0].offset = offsetof(Vertex, pos);
 
 			// color
@@ -61,36 +100,20 @@ namespace Viper
 		void init() override;
 		void swapBuffers() override;
 
-		// testing
-		void updateVertices(std::pair<float, float> v1, std::pair<float, float> v2, std::pair<float, float> v3) override
-		{
-			
-			this->vertices[0].pos = { v1.first, v1.second };
-			this->vertices[1].pos = { v2.first, v2.second };
-			this->vertices[2].pos = { v3.first, v3.second };
-
-			// update vertex buffer
-			VkDeviceSize bufferSize = sizeof(this->vertices[0]) * this->vertices.size();
-
-			VkBuffer stagingBuffer;
-			VkDeviceMemory stagingBufferMemory;
-			this->createBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
-
-
-			// Filling the vertex buffer
-			void *data;
-			vkMapMemory(this->device, stagingBufferMemory, 0, bufferSize, 0, &data);
-			memcpy(data, this->vertices.data(), (size_t)bufferSize);
-			vkUnmapMemory(this->device, stagingBufferMemory);
-
-			// move the vertex data to the device local buffer
-			this->copyBuffer(stagingBuffer, this->vertexBuffer, bufferSize);
+		inline RenderQueue &getRenderQueue() override { return this->frames[this->submitIndex].queue; }
+		inline OverlayBatch &getOverlay() override { return this->frames[this->submitIndex].overlay; }
+		inline const RenderStats &getStats() const override { return this->stats; }
+		inline DynamicResolution &getDynamicResolution() override { return this->dynamicResolution; }
 
-			vkDestroyBuffer(this->device, stagingBuffer, nullptr);
-			vkFreeMemory(this->device, stagingBufferMemory, nullptr);
+		void setCamera(const glm::mat4 &viewProjection) override;
+		inline const glm::mat4 &getCamera() const override { return this->cameraData.viewProjection; }
+		void setTransforms(const glm::mat4 *matrices, uint32_t count) override;
+		inline void invalidateSwapChain() override { this->swapChainInvalidated = true; }
+		inline void setInputTimestamp(double time) override { this->inputTimestamp = time; }
 
-			V_CORE_INFO("vertices updated! - {0}, {1}", this->vertices[0].pos.x, this->vertices[0].pos.y);
-		}
+		// testing
+		inline void setTestTransform(const glm::mat4 &transform, uint32_t transformIndex) override { this->testTransform = transform; this->testTransformIndex = transformIndex; }
+		AABB getTestBounds() const override;
 
 	private:
 		void createInstance();
@@ -129,7 +152,7 @@ namespace Viper
 
 		/******************** Recreating the swap chain ********************/
 
-		void recreateSwapChain();
+		bool recreateSwapChain();
 		void cleanupSwapChain();
 
 
@@ -137,11 +160,33 @@ namespace Viper
 		/******************** Image views ********************/
 
 		void createImageViews();
+		VkImageView createImageView(VkImage image, VkFormat format, VkImageAspectFlags aspectFlags);
+
+
+
+		/******************** Depth buffering ********************/
+
+		void createDepthResources();
+		VkFormat findSupportedFormat(const std::vector<VkFormat> &candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
+		VkFormat findDepthFormat();
+		bool hasStencilComponent(VkFormat format);
+		void createImage(uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage &image, VkDeviceMemory &imageMemory);
+
+
+
+		/******************** Dynamic resolution ********************/
+
+		void createSceneResources();
+		void createTimestampQueries();
+		void readGpuTime();
+		void updateRenderExtent();
+		void blitToSwapChain(VkCommandBuffer commandBuffer, uint32_t imageIndex, bool present);
 
 
 
 		/******************** Graphics pipeline ********************/
 
+		void createDescriptorSetLayout();
 		void createGraphicsPipeline();
 		VkShaderModule createShaderModule(const std::vector<char> &code);
 
@@ -163,16 +208,23 @@ namespace Viper
 
 		void createCommandPool();
 		void createCommandBuffers();
+		void recordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, const FramePacket &frame);
 
 
 
 		/******************** Drawing ********************/
 
-		void drawFrame();
+		void drawFrame(FramePacket &frame);
 		void createSyncObjects();
 
 
 
+		/******************** Render thread ********************/
+
+		void renderLoop();
+
+
+
 		/******************** Vertex buffer creation ********************/
 
 		void createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer &buffer, VkDeviceMemory &bufferMemory);
@@ -180,8 +232,33 @@ namespace Viper
 		void createVertexBuffer();
 		uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
 
+		// device memory is counted per allocation for the stats
+		void trackDeviceMemory(VkDeviceMemory memory, VkDeviceSize size);
+		void freeDeviceMemory(VkDeviceMemory memory);
+
 		void createIndexBuffer();
 
+
+
+		/******************** Uniform buffers ********************/
+
+		void createUniformBuffer();
+		void createDescriptorPool();
+		void createDescriptorSet();
+		uint32_t allocateUniform(const void *data, VkDeviceSize size);
+		void createTransformBuffer();
+		uint32_t uploadTransforms(const std::vector<glm::mat4> &transforms);
+
+
+
+		/******************** Overlay ********************/
+
+		void createOverlayRenderPass();
+		void createOverlayPipeline();
+		void createOverlayFramebuffers();
+		void createOverlayVertexBuffer();
+		void recordOverlay(VkCommandBuffer commandBuffer, uint32_t imageIndex, const OverlayBatch &overlay);
+
 		/********************  ********************/
 	private:
 		Window *window;
@@ -196,18 +273,39 @@ namespace Viper
 		VkQueue presentQueue;
 		
 		VkSwapchainKHR swapChain;
+		bool swapChainInvalidated = false;	// main thread, passed on with the next frame
+		bool swapChainOutOfDate = false;	// render thread
 		std::vector<VkImage> swapChainImages;
 		VkFormat swapChainImageFormat;
 		VkExtent2D swapChainExtent;
 
 		std::vector<VkImageView> swapChainImageViews;
 
+		VkImage depthImage;
+		VkDeviceMemory depthImageMemory;
+		VkImageView depthImageView;
+		VkFormat depthFormat;
+
+		// offscreen scene target at swap chain resolution, only renderExtent of it is rendered and upscaled
+		VkImage sceneImage;
+		VkDeviceMemory sceneImageMemory;
+		VkImageView sceneImageView;
+		VkFramebuffer sceneFramebuffer;
+		VkExtent2D renderExtent;
+		VkFilter blitFilter = VK_FILTER_LINEAR;
+
+		DynamicResolution dynamicResolution;
+		VkQueryPool timestampPool = VK_NULL_HANDLE;
+		std::vector<bool> timestampsWritten;
+		float timestampPeriod = 1.0f;
+		uint64_t timestampMask = ~0ull;
+		float gpuTime = 0.0f;
+
 		VkRenderPass renderPass;
+		VkDescriptorSetLayout descriptorSetLayout;
 		VkPipelineLayout pipelineLayout;
 		VkPipeline graphicsPipeline;
 
-		std::vector<VkFramebuffer> swapChainFramebuffers;
-
 		VkCommandPool commandPool;
 		std::vector<VkCommandBuffer> commandBuffers;
 
@@ -216,6 +314,35 @@ namespace Viper
 		std::vector<VkFence> inFlightFences;
 		size_t currentFrame = 0;
 
+		// frames are double buffered: the main thread fills frames[submitIndex] while the render thread draws frames[renderIndex]
+		FramePacket frames[2];
+		uint32_t submitIndex = 0;
+		uint32_t renderIndex = 1;
+
+		std::thread renderThread;
+		std::mutex frameMutex;
+		std::condition_variable frameCondition;
+		bool renderThreadRunning = false;
+		bool framePending = false;
+		bool renderBusy = false;
+
+		// swap chain settings used by the render thread (copied from the frame it draws)
+		uint32_t framebufferWidth = 0;
+		uint32_t framebufferHeight = 0;
+		PresentMode presentMode = PresentMode::Mailbox;
+
+		RenderStats stats;			// main thread, stats of the last finished frame
+		RenderStats renderStats;	// published by the render thread under frameMutex
+		RenderStats frameStats;		// render thread, the frame being drawn
+
+		double lastPresentTime = 0.0;
+		double inputTimestamp = 0.0;
+		float inputLatency = 0.0f;
+
+		// lookup tables for the handles stored in DrawCommand
+		std::vector<VkPipeline> pipelines;
+		std::vector<VulkanMesh> meshes;
+
 		std::vector<Vertex> vertices =
 		{
 			//{{0.0f, -1.0f}, {1.0f, 1.0f, 1.0f}},
@@ -232,9 +359,9 @@ namespace Viper
 			//{{0.1f, 0.1f}, {0.0f, 0.0f, 0.0f}},
 			//{{-0.1f, 0.1f}, {0.0f, 0.0f, 0.0f}}
 
-			{{-1.0f, -1.0f}, {1.0f, 0.0f, 1.0f}},
-			{{1.0f, -1.0f}, {1.0f, 1.0f, 0.0f}},
-			{{0.0f, 0.0f}, {0.0f, 1.0f, 1.0f}}
+			{{-1.0f, -1.0f, 0.0f}, {1.0f, 0.0f, 1.0f}},
+			{{1.0f, -1.0f, 0.0f}, {1.0f, 1.0f, 0.0f}},
+			{{0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 1.0f}}
 		};
 
 		std::vector<uint16_t> indices =
@@ -251,6 +378,41 @@ namespace Viper
 		VkBuffer indexBuffer;
 		VkDeviceMemory indexBufferMemory;
 
+		// per-frame uniform data lives in one persistently mapped buffer split into MAX_FRAMES_IN_FLIGHT regions,
+		// each region is bump allocated from the start every frame and addressed through a dynamic offset
+		VkBuffer uniformBuffer;
+		VkDeviceMemory uniformBufferMemory;
+		uint8_t *uniformBufferMapped = nullptr;
+		VkDeviceSize uniformAlignment = 0;
+		VkDeviceSize uniformFrameSize = 0;
+		VkDeviceSize uniformHead = 0;
+
+		// world matrices, one region of MAX_TRANSFORMS per frame in flight, persistently mapped like the uniform buffer
+		VkBuffer transformBuffer;
+		VkDeviceMemory transformBufferMemory;
+		glm::mat4 *transformBufferMapped = nullptr;
+
+		VkDescriptorPool descriptorPool;
+		VkDescriptorSet descriptorSet;
+
+		// overlay drawn over the swap chain image after the blit, disabled (null pipeline) without its shaders
+		VkRenderPass overlayRenderPass;
+		VkPipelineLayout overlayPipelineLayout = VK_NULL_HANDLE;
+		VkPipeline overlayPipeline = VK_NULL_HANDLE;
+		std::vector<VkFramebuffer> overlayFramebuffers;
+		VkBuffer overlayVertexBuffer;
+		VkDeviceMemory overlayVertexBufferMemory;
+		OverlayVertex *overlayVerticesMapped = nullptr;
+
+		std::unordered_map<VkDeviceMemory, VkDeviceSize> deviceAllocations;
+		VkDeviceSize deviceMemoryUsed = 0;
+
+		CameraData cameraData = { glm::mat4(1.0f) };
+
+		// testing
+		glm::mat4 testTransform = glm::mat4(1.0f);
+		uint32_t testTransformIndex = DrawCommand::NoTransform;
+
 		bool enableValidationLayers = true;
 		VulkanDebugger *debugger = new VulkanDebugger(enableValidationLayers);
 	};
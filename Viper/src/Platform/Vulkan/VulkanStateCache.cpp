@@ -0,0 +1,108 @@
+#include "vpch.h"
+#include "VulkanStateCache.h"
+
+namespace Viper
+{
+
+	VulkanStateCache::VulkanStateCache(VkCommandBuffer commandBuffer, RenderStats &stats)
+		: commandBuffer(commandBuffer), stats(stats)
+	{
+	}
+
+	void VulkanStateCache::bindPipeline(VkPipeline pipeline, VkPipelineLayout layout)
+	{
+		if (this->pipeline == pipeline)
+		{
+			this->stats.pipelineBindsElided++;
+			return;
+		}
+
+		vkCmdBindPipeline(this->commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+		this->stats.pipelineBinds++;
+
+		// descriptor sets stay bound only across pipelines with compatible layouts
+		if (this->pipelineLayout != layout)
+		{
+			for (auto &bound : this->descriptorSets)
+				bound = BoundDescriptorSet();
+		}
+
+		this->pipeline = pipeline;
+		this->pipelineLayout = layout;
+	}
+
+	void VulkanStateCache::bindDescriptorSet(uint32_t setIndex, VkDescriptorSet descriptorSet, uint32_t dynamicOffset)
+	{
+		V_CORE_ASSERT(setIndex < STATE_CACHE_MAX_DESCRIPTOR_SETS, "descriptor set index out of range!");
+		V_CORE_ASSERT(this->pipelineLayout != VK_NULL_HANDLE, "a pipeline has to be bound before its descriptor sets!");
+
+		BoundDescriptorSet &bound = this->descriptorSets[setIndex];
+
+		if (bound.set == descriptorSet && bound.dynamicOffset == dynamicOffset)
+		{
+			this->stats.descriptorSetBindsElided++;
+			return;
+		}
+
+		vkCmdBindDescriptorSets(this->commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, this->pipelineLayout, setIndex, 1, &descriptorSet, 1, &dynamicOffset);
+		this->stats.descriptorSetBinds++;
+
+		bound.set = descriptorSet;
+		bound.dynamicOffset = dynamicOffset;
+	}
+
+	void VulkanStateCache::bindVertexBuffer(VkBuffer buffer, VkDeviceSize offset)
+	{
+		if (this->vertexBuffer == buffer && this->vertexBufferOffset == offset)
+		{
+			this->stats.vertexBufferBindsElided++;
+			return;
+		}
+
+		vkCmdBindVertexBuffers(this->commandBuffer, 0, 1, &buffer, &offset);
+		this->stats.vertexBufferBinds++;
+
+		this->vertexBuffer = buffer;
+		this->vertexBufferOffset = offset;
+	}
+
+	void VulkanStateCache::bindIndexBuffer(VkBuffer buffer, VkIndexType indexType, VkDeviceSize offset)
+	{
+		if (this->indexBuffer == buffer && this->indexBufferOffset == offset && this->indexType == indexType)
+		{
+			this->stats.indexBufferBindsElided++;
+			return;
+		}
+
+		vkCmdBindIndexBuffer(this->commandBuffer, buffer, offset, indexType);
+		this->stats.indexBufferBinds++;
+
+		this->indexBuffer = buffer;
+		this->indexBufferOffset = offset;
+		this->indexType = indexType;
+	}
+
+	void VulkanStateCache::drawIndexed(uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset)
+	{
+		vkCmdDrawIndexed(this->commandBuffer, indexCount, 1, firstIndex, vertexOffset, 0);
+
+		this->stats.drawCalls++;
+		this->stats.indices += indexCount;
+	}
+
+	void VulkanStateCache::invalidate()
+	{
+		this->pipeline = VK_NULL_HANDLE;
+		this->pipelineLayout = VK_NULL_HANDLE;
+
+		for (auto &bound : this->descriptorSets)
+			bound = BoundDescriptorSet();
+
+		this->vertexBuffer = VK_NULL_HANDLE;
+		this->vertexBufferOffset = 0;
+		this->indexBuffer = VK_NULL_HANDLE;
+		this->indexBufferOffset = 0;
+		this->indexType = VK_INDEX_TYPE_UINT16;
+	}
+
+}
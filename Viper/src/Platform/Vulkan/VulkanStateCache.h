@@ -0,0 +1,56 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+
+#include "Viper/Renderer/RenderStats.h"
+
+namespace Viper
+{
+
+	#define STATE_CACHE_MAX_DESCRIPTOR_SETS 4
+
+	class VulkanStateCache
+	{
+		/*
+			Remembers what is bound to the command buffer being recorded and drops redundant binds.
+			The render queue hands out draws sorted by pipeline and material, so consecutive draws mostly share their state.
+		*/
+
+	public:
+		VulkanStateCache(VkCommandBuffer commandBuffer, RenderStats &stats);
+
+		void bindPipeline(VkPipeline pipeline, VkPipelineLayout layout);
+
+		// the engine's descriptor sets hold a single dynamic uniform buffer, so one offset per set
+		void bindDescriptorSet(uint32_t setIndex, VkDescriptorSet descriptorSet, uint32_t dynamicOffset);
+		void bindVertexBuffer(VkBuffer buffer, VkDeviceSize offset = 0);
+		void bindIndexBuffer(VkBuffer buffer, VkIndexType indexType, VkDeviceSize offset = 0);
+
+		void drawIndexed(uint32_t indexCount, uint32_t firstIndex, int32_t vertexOffset);
+
+		// forget everything bound so far (e.g. after a new render pass began)
+		void invalidate();
+
+	private:
+		VkCommandBuffer commandBuffer;
+		RenderStats &stats;
+
+		VkPipeline pipeline = VK_NULL_HANDLE;
+		VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+
+		struct BoundDescriptorSet
+		{
+			VkDescriptorSet set = VK_NULL_HANDLE;
+			uint32_t dynamicOffset = 0;
+		};
+
+		BoundDescriptorSet descriptorSets[STATE_CACHE_MAX_DESCRIPTOR_SETS];
+
+		VkBuffer vertexBuffer = VK_NULL_HANDLE;
+		VkDeviceSize vertexBufferOffset = 0;
+		VkBuffer indexBuffer = VK_NULL_HANDLE;
+		VkDeviceSize indexBufferOffset = 0;
+		VkIndexType indexType = VK_INDEX_TYPE_UINT16;
+	};
+
+}
@@ -1,12 +1,17 @@
 #include "vpch.h"
 #include "WindowsWindow.h"
 
-#include "Viper/Events/ApplicationEvent.h"
-#include "Viper/Events/MouseEvent.h"
-#include "Viper/Events/KeyEvent.h"
+#include "Viper/Events/EventQueue.h"
+#include "Viper/Input.h"
+#include "Viper/Debug/InputRecorder.h"
+#include "Viper/Memory/MemoryTracker.h"
+#include "Viper/Debug/Profiler.h"
 
 #include "Platform/Vulkan/VulkanContext.h"
 
+#include <thread>
+#include <chrono>
+
 namespace Viper
 {
 
@@ -29,7 +34,95 @@ namespace Viper
 
 	void WindowsWindow::onUpdate()
 	{
-		this->context->swapBuffers();
+		V_PROFILE_FUNCTION();
+
+		// input polled at the end of the previous frame has been seen by the layers,
+		// so the frame presented now is the first one that can show its result
+		this->context->setInputTimestamp(this->data.inputTime);
+		this->data.inputTime = 0.0;
+
+		{
+			V_MEMORY_TAG(Renderer);
+			this->context->swapBuffers();
+		}
+
+		this->limitFrameRate();
+
+		// callbacks only record the events, the whole batch goes to the application at once
+		{
+			V_PROFILE_SCOPE("Poll events");
+			V_MEMORY_TAG(Events);
+			glfwPollEvents();
+		}
+
+		if (InputRecorder::isReplaying())
+			this->replayInput();
+
+		// the handlers of this batch already see the new snapshot
+		Input::publish();
+		InputRecorder::endFrame(glfwGetTime());
+
+		// releases that were dropped during the replay (e.g. of the replay key) would leave keys down
+		if (this->replayingInput && !InputRecorder::isReplaying())
+			this->syncInput();
+
+		this->replayingInput = InputRecorder::isReplaying();
+		this->data.eventQueue.dispatch(this->data.eventCallback);
+	}
+
+	void WindowsWindow::setPresentMode(PresentMode presentMode)
+	{
+		if (this->data.presentMode == presentMode)
+			return;
+
+		this->data.presentMode = presentMode;
+		this->context->invalidateSwapChain();
+	}
+
+	void WindowsWindow::setRawMouseMotion(bool enabled)
+	{
+		if (this->data.rawMouseMotion == enabled)
+			return;
+
+		// raw motion needs a disabled (captured) cursor, without support the captured cursor still gives unbounded deltas
+		glfwSetInputMode(this->window, GLFW_CURSOR, enabled ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
+
+		if (glfwRawMouseMotionSupported())
+			glfwSetInputMode(this->window, GLFW_RAW_MOUSE_MOTION, enabled ? GLFW_TRUE : GLFW_FALSE);
+		else if (enabled)
+			V_CORE_WARN("Raw mouse motion is not supported, using the captured cursor motion");
+
+		this->data.rawMouseMotion = enabled;
+
+		// the captured cursor has its own virtual position, the switch must not show up as motion
+		double cursorX, cursorY;
+		glfwGetCursorPos(this->window, &cursorX, &cursorY);
+		Input::recordCursor((float_t)cursorX, (float_t)cursorY);
+	}
+
+	void WindowsWindow::limitFrameRate()
+	{
+		/*
+			Sleep through most of the remaining frame time and spin for the rest,
+			the scheduler can overshoot a short sleep by a millisecond or more.
+		*/
+
+		V_PROFILE_FUNCTION();
+
+		if (this->data.frameRateLimit > 0)
+		{
+			const double spinTime = 0.002;
+			double deadline = this->frameStartTime + 1.0 / this->data.frameRateLimit;
+			double remaining = deadline - glfwGetTime();
+
+			if (remaining > spinTime)
+				std::this_thread::sleep_for(std::chrono::duration<double>(remaining - spinTime));
+
+			while (glfwGetTime() < deadline)
+				std::this_thread::yield();
+		}
+
+		this->frameStartTime = glfwGetTime();
 	}
 
 	void WindowsWindow::init(const WindowProperties &properties)
@@ -38,6 +131,10 @@ namespace Viper
 		this->data.width = properties.width;
 		this->data.height = properties.height;
 		this->data.framebufferResized = false;
+		this->data.presentMode = properties.presentMode;
+		this->data.frameRateLimit = properties.frameRateLimit;
+		this->data.rawMouseMotion = false;
+		this->data.inputTime = 0.0;
 
 		V_CORE_INFO("Creating window {0} ({1}x{2})", this->data.title, this->data.width, this->data.height);
 
@@ -75,92 +172,200 @@ namespace Viper
 
 		glfwSetWindowSizeCallback(this->window, [](GLFWwindow *window, int width, int height)
 		{
-			WindowData *data = reinterpret_cast<WindowData*>(glfwGetWindowUserPointer(window));
-			data->width = width;
-			data->height = height;
-
-			WindowResizeEvent e(width, height);
-			data->eventCallback(e);
+			WindowsWindow::onResize(*reinterpret_cast<WindowData*>(glfwGetWindowUserPointer(window)), width, height, glfwGetTime());
 		}); 
 
 		glfwSetWindowCloseCallback(this->window, [](GLFWwindow *window)
 		{
-			WindowData *data = reinterpret_cast<WindowData*>(glfwGetWindowUserPointer(window));
-
-			WindowCloseEvent e;
-			data->eventCallback(e);
+			WindowsWindow::onClose(*reinterpret_cast<WindowData*>(glfwGetWindowUserPointer(window)), glfwGetTime());
 		});
 
+		// a running replay owns the keyboard and the mouse, the live input is dropped
 		glfwSetKeyCallback(this->window, [](GLFWwindow *window, int key, int scancode, int action, int mods)
 		{
-			WindowData *data = reinterpret_cast<WindowData*>(glfwGetWindowUserPointer(window));
-
-			switch (action)
-			{
-				case GLFW_PRESS:
-				{
-					KeyPressedEvent e(key, 0);
-					data->eventCallback(e);
-					break;
-				}
-				case GLFW_RELEASE:
-				{
-					KeyReleasedEvent e(key);
-					data->eventCallback(e);
-					break;
-				}
-				case GLFW_REPEAT:
-				{
-					KeyPressedEvent e(key, 1);
-					data->eventCallback(e);
-					break;
-				}
-			}
+			if (!InputRecorder::isReplaying())
+				WindowsWindow::onKey(*reinterpret_cast<WindowData*>(glfwGetWindowUserPointer(window)), key, action, glfwGetTime());
 		});
 
 		glfwSetMouseButtonCallback(this->window, [](GLFWwindow *window, int button, int action, int mods)
 		{
-			WindowData *data = reinterpret_cast<WindowData*>(glfwGetWindowUserPointer(window));
-
-			switch (action)
-			{
-				case GLFW_PRESS:
-				{
-					MouseButtonPressedEvent e(button);
-					data->eventCallback(e);
-					break;
-				}
-				case GLFW_RELEASE:
-				{
-					MouseButtonReleasedEvent e(button);
-					data->eventCallback(e);
-					break;
-				}
-			}
+			if (!InputRecorder::isReplaying())
+				WindowsWindow::onMouseButton(*reinterpret_cast<WindowData*>(glfwGetWindowUserPointer(window)), button, action, glfwGetTime());
 		});
 
 		glfwSetScrollCallback(this->window, [](GLFWwindow *window, double_t xOffset, double_t yOffset)
 		{
-			WindowData *data = reinterpret_cast<WindowData*>(glfwGetWindowUserPointer(window));
-
-			MouseScrolledEvent e((float_t)xOffset, (float_t)yOffset);
-			data->eventCallback(e);
+			if (!InputRecorder::isReplaying())
+				WindowsWindow::onScroll(*reinterpret_cast<WindowData*>(glfwGetWindowUserPointer(window)), (float_t)xOffset, (float_t)yOffset, glfwGetTime());
 		});
 
 		glfwSetCursorPosCallback(this->window, [](GLFWwindow *window, double_t xPos, double_t yPos)
 		{
-			WindowData *data = reinterpret_cast<WindowData*>(glfwGetWindowUserPointer(window));
-
-			MouseMovedEvent e((float_t)xPos, (float_t)yPos);
-			data->eventCallback(e);
+			if (!InputRecorder::isReplaying())
+				WindowsWindow::onCursorMove(*reinterpret_cast<WindowData*>(glfwGetWindowUserPointer(window)), (float_t)xPos, (float_t)yPos, glfwGetTime());
 		});
 
+		// the cursor callback only fires on movement, start from the current position
+		double cursorX, cursorY;
+		glfwGetCursorPos(this->window, &cursorX, &cursorY);
+		Input::recordCursor((float_t)cursorX, (float_t)cursorY);
+		Input::publish();
+
+		this->setRawMouseMotion(properties.rawMouseMotion);
+	}
+
+	void WindowsWindow::replayInput()
+	{
+		uint32_t count;
+		const InputRecord *records = InputRecorder::getFrameRecords(count);
+
+		// the latency is measured against the real clock
+		if (count && this->data.inputTime == 0.0)
+			this->data.inputTime = glfwGetTime();
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const InputRecord &record = records[i];
+			double time = InputRecorder::getReplayTime(record);
+
+			switch (record.type)
+			{
+				case InputRecordType::Key:			WindowsWindow::onKey(this->data, record.code, record.action, time); break;
+				case InputRecordType::MouseButton:	WindowsWindow::onMouseButton(this->data, record.code, record.action, time); break;
+				case InputRecordType::CursorMove:	WindowsWindow::onCursorMove(this->data, record.x, record.y, time); break;
+				case InputRecordType::Scroll:		WindowsWindow::onScroll(this->data, record.x, record.y, time); break;
+				case InputRecordType::WindowClose:	WindowsWindow::onClose(this->data, time); break;
+
+				// the real window is resized, its size callback reports it like a live resize
+				case InputRecordType::WindowResize:	glfwSetWindowSize(this->window, (int)record.x, (int)record.y); break;
+			}
+		}
+	}
+
+	void WindowsWindow::syncInput()
+	{
+		InputLevels levels = {};
+
+		for (int key = GLFW_KEY_SPACE; key <= GLFW_KEY_LAST; key++)
+		{
+			if (glfwGetKey(this->window, key) == GLFW_PRESS)
+				levels.keys[key / 64] |= 1ull << (key % 64);
+		}
+
+		for (int button = 0; button <= GLFW_MOUSE_BUTTON_LAST; button++)
+		{
+			if (glfwGetMouseButton(this->window, button) == GLFW_PRESS)
+				levels.buttons |= (uint8_t)(1 << button);
+		}
+
+		double cursorX, cursorY;
+		glfwGetCursorPos(this->window, &cursorX, &cursorY);
+		levels.mouseX = (float_t)cursorX;
+		levels.mouseY = (float_t)cursorY;
+
+		Input::setLevels(levels);
+	}
+
+	void WindowsWindow::onResize(WindowData &data, int width, int height, double time)
+	{
+		InputRecorder::record(InputRecordType::WindowResize, 0, 0, (float)width, (float)height, time);
+
+		data.width = width;
+		data.height = height;
+
+		data.eventQueue.pushWindowResize(width, height);
+	}
+
+	void WindowsWindow::onClose(WindowData &data, double time)
+	{
+		InputRecorder::record(InputRecordType::WindowClose, 0, 0, 0.0f, 0.0f, time);
+
+		data.eventQueue.pushWindowClose();
+	}
+
+	void WindowsWindow::onKey(WindowData &data, int key, int action, double time)
+	{
+		InputRecorder::record(InputRecordType::Key, (uint16_t)key, (uint8_t)action, 0.0f, 0.0f, time);
+
+		if (data.inputTime == 0.0)
+			data.inputTime = time;
+
+		Input::recordKey(key, action != GLFW_RELEASE);
+
+		switch (action)
+		{
+			case GLFW_PRESS:
+			{
+				data.eventQueue.pushKeyPressed(key, 0);
+				break;
+			}
+			case GLFW_RELEASE:
+			{
+				data.eventQueue.pushKeyReleased(key);
+				break;
+			}
+			case GLFW_REPEAT:
+			{
+				data.eventQueue.pushKeyPressed(key, 1);
+				break;
+			}
+		}
+	}
+
+	void WindowsWindow::onMouseButton(WindowData &data, int button, int action, double time)
+	{
+		InputRecorder::record(InputRecordType::MouseButton, (uint16_t)button, (uint8_t)action, 0.0f, 0.0f, time);
+
+		if (data.inputTime == 0.0)
+			data.inputTime = time;
+
+		Input::recordMouseButton(button, action == GLFW_PRESS);
+
+		switch (action)
+		{
+			case GLFW_PRESS:
+			{
+				data.eventQueue.pushMouseButtonPressed(button);
+				break;
+			}
+			case GLFW_RELEASE:
+			{
+				data.eventQueue.pushMouseButtonReleased(button);
+				break;
+			}
+		}
+	}
+
+	void WindowsWindow::onScroll(WindowData &data, float xOffset, float yOffset, double time)
+	{
+		InputRecorder::record(InputRecordType::Scroll, 0, 0, xOffset, yOffset, time);
+
+		if (data.inputTime == 0.0)
+			data.inputTime = time;
+
+		Input::recordScroll(xOffset, yOffset);
+		data.eventQueue.pushMouseScrolled(xOffset, yOffset);
+	}
+
+	void WindowsWindow::onCursorMove(WindowData &data, float x, float y, double time)
+	{
+		InputRecorder::record(InputRecordType::CursorMove, 0, 0, x, y, time);
+
+		if (data.inputTime == 0.0)
+			data.inputTime = time;
+
+		// raw motion can arrive at the mouse's polling rate, it is only accumulated into the snapshot
+		Input::recordCursorMove(x, y, time);
+
+		if (!data.rawMouseMotion)
+			data.eventQueue.pushMouseMoved(x, y);
 	}
 
 	void WindowsWindow::shutdown()
 	{
-		glfwDestroyWindow(this->window);
+		// the context stops the render thread, which may still be presenting to the window
 		delete this->context;
+		glfwDestroyWindow(this->window);
 		glfwTerminate();
 	}
 
@@ -2,6 +2,7 @@
 
 #include "Viper/Window.h"
 #include "Viper/Renderer/GraphicsContext.h"
+#include "Viper/Events/EventQueue.h"
 
 #include <GLFW/glfw3.h>
 
@@ -19,10 +20,18 @@ namespace Viper
 		inline uint16_t getWidth() const override { return data.width; }
 		inline uint16_t getHeight() const override { return data.height; }
 		inline bool getFramebufferResizeState() const override { return data.framebufferResized; }
+		inline PresentMode getPresentMode() const override { return data.presentMode; }
+		inline uint16_t getFrameRateLimit() const override { return data.frameRateLimit; }
 
 		inline void setEventCallback(const eventCallbackFunc &callback) override { this->data.eventCallback = callback; }
 		inline void setFramebufferResizeState(bool framebufferResized) override { this->data.framebufferResized = framebufferResized; }
 
+		void setPresentMode(PresentMode presentMode) override;
+		inline void setFrameRateLimit(uint16_t framesPerSecond) override { this->data.frameRateLimit = framesPerSecond; }
+
+		void setRawMouseMotion(bool enabled) override;
+		inline bool isRawMouseMotion() const override { return this->data.rawMouseMotion; }
+
 		inline void *getNativeWindow() const override { return this->window; }
 		inline void *getContextHandle() const override { return this->context; }
 
@@ -30,10 +39,21 @@ namespace Viper
 		virtual void init(const WindowProperties &properties);
 		virtual void shutdown();
 
+		void limitFrameRate();
+
+		// feeds the recorded callbacks of the replayed frame through the handlers below
+		void replayInput();
+
+		// reads the live keys, buttons and cursor position into the input state
+		void syncInput();
+
 	private:
 		GLFWwindow *window;
 		GraphicsContext *context;
 
+		// a replay ran during the last frame, the live input takes over again once it has ended
+		bool replayingInput = false;
+
 		struct WindowData
 		{
 			std::string title;
@@ -41,10 +61,30 @@ namespace Viper
 			uint16_t height;
 			bool framebufferResized;
 
+			PresentMode presentMode;
+			uint16_t frameRateLimit;
+			bool rawMouseMotion;
+
+			// glfw time of the oldest input that no presented frame has reacted to yet (0 = none)
+			double inputTime;
+
 			eventCallbackFunc eventCallback;
+
+			// filled by the glfw callbacks while polling, dispatched to eventCallback once per frame
+			EventQueue eventQueue;
 		};
 
+		// the glfw callbacks and the input replay go through these, 'time' is the glfw time of the input
+		static void onResize(WindowData &data, int width, int height, double time);
+		static void onClose(WindowData &data, double time);
+		static void onKey(WindowData &data, int key, int action, double time);
+		static void onMouseButton(WindowData &data, int button, int action, double time);
+		static void onScroll(WindowData &data, float xOffset, float yOffset, double time);
+		static void onCursorMove(WindowData &data, float x, float y, double time);
+
+	private:
 		WindowData data;
+		double frameStartTime = 0.0;
 	};
 
 }
\ No newline at end of file
@@ -6,6 +6,11 @@
 #include "Viper/Application.h"
 #include "Viper/Layer.h"
 #include "Viper/Log.h"
+#include "Viper/Jobs/JobSystem.h"
+#include "Viper/ECS/World.h"
+#include "Viper/Scene/TransformHierarchy.h"
+#include "Viper/Scene/SpatialIndex.h"
+#include "Viper/Debug/StatsOverlay.h"
 
 #include "Viper/Input.h"
 #include "Viper/KeyCodes.h"
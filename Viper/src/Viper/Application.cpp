@@ -4,10 +4,32 @@
 // testing purposes
 #include "Viper/Renderer/GraphicsContext.h"
 
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+
 namespace Viper
 {
 
-	#define BIND_EVENT_FUNCTION(x) std::bind(&x, this, std::placeholders::_1)
+	#define PROFILE_CAPTURE_KEY V_KEY_F11
+	#define PROFILE_CAPTURE_FRAMES 10
+	#define PROFILE_CAPTURE_FILE "ViperProfile.json"
+
+	#define INPUT_RECORD_KEY V_KEY_F9
+	#define INPUT_REPLAY_KEY V_KEY_F10
+	#define INPUT_RECORDING_FILE "ViperInput.vrec"
+
+	#define RAW_MOUSE_MOTION_KEY V_KEY_F8
+
+	// VIPER_ALLOCATION_SAMPLING=<n> records the callstack of every n-th allocation, the hottest are logged on exit
+	#define ALLOCATION_SAMPLING_VARIABLE "VIPER_ALLOCATION_SAMPLING"
+
+	// the first frame and the limit of a measured step, a stall (breakpoint, window drag) doesn't fast-forward the simulation
+	#define DEFAULT_TIMESTEP (1.0f / 60.0f)
+	#define MAX_TIMESTEP 0.1f
+
+	// frames after which every per-frame container has reached its working size
+	#define STEADY_STATE_FRAME 300
 
 	Application *Application::instance = nullptr;
 
@@ -16,47 +38,138 @@ namespace Viper
 		V_CORE_ASSERT(!instance, "Application already exists!");
 		instance = this;
 
+		Profiler::setThreadName("Main");
+
+		if (const char *samplingInterval = std::getenv(ALLOCATION_SAMPLING_VARIABLE))
+			MemoryTracker::setSamplingInterval((uint32_t)std::strtoul(samplingInterval, nullptr, 10));
+
+		JobSystem::init();
+
 		this->window = std::unique_ptr<Window>(Window::create());
-		this->window->setEventCallback(BIND_EVENT_FUNCTION(Application::onEvent));
+		this->window->setEventCallback([this](Event &e) { this->onEvent(e); });
+
+		this->eventHandlers.bind<WindowCloseEvent, Application, &Application::onWindowClose>(this);
+		this->eventHandlers.bind<KeyPressedEvent, Application, &Application::onKeyPressed>(this);
+
+		// testing
+		this->eventHandlers.bind<MouseButtonPressedEvent, Application, &Application::onMouseButtonPressed>(this);
+
+		// the test triangle is drawn with the world matrix of its node, the pick box is the same one the context culls with
+		this->testNode = this->transforms.create();
+		this->testBounds = static_cast<GraphicsContext *>(this->window->getContextHandle())->getTestBounds();
+		this->testProxy = this->pickIndex.insert(this->testBounds);
 	}
 
 
 	Application::~Application()
 	{
 		this->window->~Window();
+
+		JobSystem::shutdown();
+
+		MemoryTracker::logReport();
+		MemoryTracker::dumpSamples();
 	}
 
 	void Application::run()
 	{
+		auto previousFrameStart = std::chrono::steady_clock::now();
+		this->timestep = DEFAULT_TIMESTEP;
+
 		while (this->running)
 		{
-			// testing
+			Profiler::beginFrame();
+			V_PROFILE_SCOPE("Frame");
+
+			auto frameStart = std::chrono::steady_clock::now();
+
+			if (InputRecorder::isReplaying())
+				this->timestep = InputRecorder::getTimestep();
+			else if (frameStart != previousFrameStart)
+				this->timestep = std::min(std::chrono::duration<float>(frameStart - previousFrameStart).count(), MAX_TIMESTEP);
+
+			previousFrameStart = frameStart;
+
+			FrameAllocator::beginFrame();
+			MemoryTracker::beginFrame();
+			uint64_t heapAllocations = HeapStats::getThreadAllocationCount();
+			auto updateStart = std::chrono::steady_clock::now();
+
+			// events posted by other threads since the last frame
+			{
+				V_PROFILE_SCOPE("EventBus::drain");
+				V_MEMORY_TAG(Events);
+				this->eventBus.drain([this](Event &e) { this->onEvent(e); });
+			}
+
+			JobSystem::executeMainThreadJobs();
+
+			// testing: the triangle follows the cursor on the z = 0 plane
+			bool testMoved = false;
+
 			if (Viper::Input::isKeyPressed(V_KEY_TAB))
 			{
-				auto context = static_cast<GraphicsContext *>(this->window->getContextHandle());
-				float mousex = (2.0f * Input::getMouseX() + 1.0f) / this->window->getWidth() - 1.0f;
-				float mousey = (2.0f * Input::getMouseY() + 1.0f) / this->window->getHeight() - 1.0f;
+				Ray ray = this->getMouseRay();
+				float distance;
 
-				context->updateVertices(std::pair<float, float>(mousex, mousey - 0.1f),
-										std::pair<float, float>(mousex + 0.1f, mousey + 0.1f),
-										std::pair<float, float>(mousex - 0.1f, mousey + 0.1f));
+				if (ray.intersectsPlane(glm::vec3(0.0f, 0.0f, 1.0f), 0.0f, distance))
+				{
+					// moving the triangle only changes its node, the vertex buffer stays untouched
+					Transform local;
+					local.position = ray.getPoint(distance);
+					local.scale = glm::vec3(0.1f);
+
+					this->transforms.setLocal(this->testNode, local);
+					testMoved = true;
+				}
 			}
 			
-			for (Layer *layer : this->layers)
-				layer->onUpdate();
+			this->layers.update();
+
+			// world matrices of the frame, the draws refer to them by index
+			{
+				auto context = static_cast<GraphicsContext *>(this->window->getContextHandle());
+
+				this->transforms.update();
+				context->setTransforms(this->transforms.getWorldMatrices(), this->transforms.size());
+				context->setTestTransform(this->transforms.getWorld(this->testNode), this->transforms.getIndex(this->testNode));
+
+				if (testMoved)
+				{
+					this->testBounds = context->getTestBounds();
+					this->pickIndex.move(this->testProxy, this->testBounds);
+				}
+			}
+
+			this->updateTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - updateStart).count();
 
 			window->onUpdate();
+
+			this->frameHeapAllocations = HeapStats::getThreadAllocationCount() - heapAllocations;
+
+#ifndef V_DIST
+			// a steady state frame doesn't touch the heap, transients belong in the frame allocator (see ViperBench frame/steady_state_allocations)
+			if (this->frameHeapAllocations != 0 && FrameAllocator::getFrameNumber() > STEADY_STATE_FRAME)
+				V_LOG_EVERY_MS(5000, V_CORE_WARN, "{0} heap allocations on the main thread in frame {1}", this->frameHeapAllocations, FrameAllocator::getFrameNumber());
+#endif
+
+			this->frameEventCount = this->eventCount;
+			this->eventCount = 0;
 		}
 	}
 
-	void Application::onEvent(Event &e)
+	Ray Application::getMouseRay() const
 	{
-		EventDispatcher dispatcher(e);
+		auto context = static_cast<GraphicsContext *>(this->window->getContextHandle());
 
-		dispatcher.dispatch<WindowCloseEvent>(BIND_EVENT_FUNCTION(Application::onWindowClose));
+		return Ray::fromScreen(Input::getMouseX(), Input::getMouseY(), (float)this->window->getWidth(), (float)this->window->getHeight(),
+							   glm::inverse(context->getCamera()));
+	}
 
-		// testing
-		dispatcher.dispatch<MouseButtonPressedEvent>(BIND_EVENT_FUNCTION(Application::onMouseButtonPressed));
+	void Application::onEvent(Event &e)
+	{
+		this->eventCount++;
+		this->eventHandlers.dispatch(e);
 
 		for (auto it = this->layers.end(); it != this->layers.begin(); )
 		{
@@ -83,10 +196,65 @@ namespace Viper
 		return true;
 	}
 
+	bool Application::onKeyPressed(KeyPressedEvent &e)
+	{
+#ifdef V_ENABLE_PROFILING
+		if (e.getKeyCode() == PROFILE_CAPTURE_KEY && e.getRepeatCount() == 0)
+		{
+			Profiler::beginCapture(PROFILE_CAPTURE_FRAMES, PROFILE_CAPTURE_FILE);
+			return true;
+		}
+#endif
+
+		// a replay drops the live keys and replays the press that ended its recording, the keys below only act outside of it
+		if (e.getRepeatCount() != 0 || InputRecorder::isReplaying())
+			return false;
+
+		// captures the cursor, the motion is then only available as snapshot samples (Input::getMouseDelta)
+		if (e.getKeyCode() == RAW_MOUSE_MOTION_KEY)
+		{
+			this->window->setRawMouseMotion(!this->window->isRawMouseMotion());
+			V_CORE_INFO("Raw mouse motion {0}", this->window->isRawMouseMotion() ? "on" : "off");
+			return true;
+		}
+
+		if (e.getKeyCode() == INPUT_RECORD_KEY)
+		{
+			if (InputRecorder::isRecording())
+				InputRecorder::stopRecording();
+			else
+				InputRecorder::startRecording(INPUT_RECORDING_FILE);
+
+			return true;
+		}
+
+		// runs until the end of the recording
+		if (e.getKeyCode() == INPUT_REPLAY_KEY && !InputRecorder::isRecording())
+		{
+			InputRecorder::startReplay(INPUT_RECORDING_FILE);
+			return true;
+		}
+
+		return false;
+	}
+
 	// testing
 	bool Application::onMouseButtonPressed(MouseButtonPressedEvent &e)
 	{
 		V_CORE_INFO("Mouse button pressed! {0}, {1};{2}", e, Input::getMouseX(), Input::getMouseY());
+
+		float distance;
+		Ray ray = this->getMouseRay();
+
+		uint32_t picked = this->pickIndex.raycast(ray, std::numeric_limits<float>::max(), distance, [this, &ray](uint32_t proxy, float maxDistance)
+		{
+			float hit;
+			return ray.intersects(this->testBounds, maxDistance, hit) ? hit : -1.0f;
+		});
+
+		if (picked == this->testProxy)
+			V_CORE_INFO("Picked the test triangle at distance {0}", distance);
+
 		return true;
 	}
 
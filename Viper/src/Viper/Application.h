@@ -5,9 +5,20 @@
 #include "Viper/Input.h"
 #include "Viper/LayerStack.h"
 #include "Viper/KeyCodes.h"
+#include "Viper/Jobs/JobSystem.h"
+#include "Viper/Memory/FrameAllocator.h"
+#include "Viper/Memory/HeapStats.h"
+#include "Viper/Memory/MemoryTracker.h"
+#include "Viper/Debug/Profiler.h"
+#include "Viper/Debug/InputRecorder.h"
+#include "Viper/Scene/SpatialIndex.h"
+#include "Viper/Scene/TransformHierarchy.h"
 
 #include "Viper/Events/Event.h"
 #include "Viper/Events/ApplicationEvent.h"
+#include "Viper/Events/EventBus.h"
+
+#include "Viper/Events/KeyEvent.h"
 
 // testing
 #include "Viper/Events/MouseEvent.h"
@@ -28,11 +39,45 @@ namespace Viper
 		void pushLayer(Layer *layer);
 		void pushOverlay(Layer *overlay);
 
+		// the layer is constructed in the layer stack's slab allocator instead of the heap
+		template<typename T, typename... Args>
+		T *emplaceLayer(Args&&... args) { return this->layers.emplaceLayer<T>(std::forward<Args>(args)...); }
+
+		template<typename T, typename... Args>
+		T *emplaceOverlay(Args&&... args) { return this->layers.emplaceOverlay<T>(std::forward<Args>(args)...); }
+
 		inline Window &getWindow() const { return *this->window; }
+
+		// other threads post events for the main thread here, they are dispatched at the start of the next frame
+		inline EventBus &getEventBus() { return this->eventBus; }
+
+		// global heap allocations made by the main thread during the last frame (0 in a steady state frame)
+		inline uint64_t getFrameHeapAllocations() const { return this->frameHeapAllocations; }
+
+		// events dispatched during the last frame (window callbacks and the event bus)
+		inline uint32_t getFrameEventCount() const { return this->frameEventCount; }
+
+		// milliseconds the main thread spent on events and layer updates during the last frame
+		inline float getUpdateTime() const { return this->updateTime; }
+
+		// seconds the current frame advances the simulation: the fixed step of a running input replay, else the measured frame time
+		inline float getTimestep() const { return this->timestep; }
+
+		// picking ray through the cursor, unprojected with the camera of the graphics context
+		Ray getMouseRay() const;
+
+		/*
+			Scene transforms, updated after the layers and uploaded as the frame's world matrices (GraphicsContext::setTransforms).
+			A draw of a node sets DrawCommand::transformIndex to getIndex(node). Destroying or re-parenting nodes re-sorts the
+			matrices in the next update(), a layer doing that calls update() itself before it submits draws in the same frame.
+		*/
+		inline TransformHierarchy &getTransforms() { return this->transforms; }
+
 		inline static Application &get() { return *instance; }
 
 	private:
 		bool onWindowClose(WindowCloseEvent &e);
+		bool onKeyPressed(KeyPressedEvent &e);
 
 		// testing
 		bool onMouseButtonPressed(MouseButtonPressedEvent &e);
@@ -42,6 +87,25 @@ namespace Viper
 		bool running = true;
 		LayerStack layers;
 
+		// application level handlers, looked up by event type before the event reaches the layers
+		EventHandlerTable eventHandlers;
+
+		EventBus eventBus;
+
+		uint64_t frameHeapAllocations = 0;
+		uint32_t eventCount = 0;
+		uint32_t frameEventCount = 0;
+		float updateTime = 0.0f;
+		float timestep = 0.0f;
+
+		TransformHierarchy transforms;
+
+		// testing: the test triangle is picked through a spatial index instead of comparing the cursor with its position
+		SpatialIndex pickIndex;
+		uint32_t testProxy = SpatialIndex::NullProxy;
+		AABB testBounds;
+		TransformHandle testNode;
+
 		static Application *instance;
 	};
 
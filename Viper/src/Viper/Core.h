@@ -2,6 +2,16 @@
 
 #define V_ENABLE_ASSERTS
 
+// tagged heap tracking (per allocation header, peaks, sampling profiler) - off in shipping builds
+#ifndef V_DIST
+	#define V_TRACK_MEMORY
+#endif
+
+// V_PROFILE_SCOPE / V_PROFILE_FUNCTION zones - compiled out of shipping builds
+#ifndef V_DIST
+	#define V_ENABLE_PROFILING
+#endif
+
 #ifdef V_PLATFORM_WINDOWS
 	#ifdef V_DYNAMIC_LINK
 		#ifdef V_BUILD_DLL
@@ -17,8 +27,9 @@
 #endif
 
 #ifdef V_ENABLE_ASSERTS
-	#define V_ASSERT(x, ...) { if(!(x)) { V_ERROR("Assertion Failed: {0}", __VA_ARGS__); __debugbreak(); } }
-	#define V_CORE_ASSERT(x, ...) { if(!(x)) { V_CORE_ERROR("Assertion Failed: {0}", __VA_ARGS__); __debugbreak(); } }
+	// the message bypasses the asynchronous log queue, so it is on the console when the debugger breaks
+	#define V_ASSERT(x, ...) { if(!(x)) { ::Viper::Log::getClientSyncLogger()->error("Assertion Failed: {0}", __VA_ARGS__); __debugbreak(); } }
+	#define V_CORE_ASSERT(x, ...) { if(!(x)) { ::Viper::Log::getCoreSyncLogger()->error("Assertion Failed: {0}", __VA_ARGS__); __debugbreak(); } }
 #else	
 	#define V_ASSERT(x, ...)
 	#define V_CORE_ASSERT(x, ...)
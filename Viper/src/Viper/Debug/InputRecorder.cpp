@@ -0,0 +1,192 @@
+#include "vpch.h"
+#include "InputRecorder.h"
+
+#include "Viper/Input.h"
+
+namespace Viper
+{
+
+	#define INPUT_RECORDING_MAGIC 0x43455256	// "VREC"
+	#define INPUT_RECORDING_VERSION 2
+	#define INPUT_RECORDING_RESERVE 65536
+
+	struct InputRecordingHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		float timestep;
+		uint32_t frameCount;
+		uint32_t recordCount;
+
+		// held keys and buttons and the cursor position when the recording started
+		InputLevels levels;
+	};
+
+	static struct InputRecorderState
+	{
+		std::string filename;
+		std::vector<InputRecord> records;
+		InputLevels levels = {};
+
+		float timestep = 0.0f;
+		uint32_t frame = 0;
+		uint32_t frameCount = 0;
+		double frameStart = 0.0;
+
+		// first record of the current frame during a replay
+		size_t cursor = 0;
+	} recorder;
+
+	InputRecorder::State InputRecorder::state = InputRecorder::State::Idle;
+
+	void InputRecorder::startRecording(const std::string &filename, float timestep)
+	{
+		if (state != State::Idle)
+		{
+			V_CORE_WARN("Input recorder is busy, can't record {0}", filename);
+			return;
+		}
+
+		recorder.filename = filename;
+		recorder.records.clear();
+		recorder.records.reserve(INPUT_RECORDING_RESERVE);
+		recorder.levels = Input::getLevels();
+		recorder.timestep = timestep;
+		recorder.frame = 0;
+		recorder.frameStart = 0.0;
+
+		state = State::Recording;
+		V_CORE_INFO("Recording input to {0}", filename);
+	}
+
+	void InputRecorder::stopRecording()
+	{
+		if (state != State::Recording)
+			return;
+
+		state = State::Idle;
+
+		std::ofstream file(recorder.filename, std::ofstream::binary);
+
+		if (!file)
+		{
+			V_CORE_ERROR("Failed to write the input recording {0}", recorder.filename);
+			return;
+		}
+
+		InputRecordingHeader header = { INPUT_RECORDING_MAGIC, INPUT_RECORDING_VERSION, recorder.timestep, recorder.frame, (uint32_t)recorder.records.size(), recorder.levels };
+
+		file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char *>(recorder.records.data()), recorder.records.size() * sizeof(InputRecord));
+
+		V_CORE_INFO("Input recording written to {0} ({1} frames, {2} records)", recorder.filename, recorder.frame, recorder.records.size());
+	}
+
+	bool InputRecorder::startReplay(const std::string &filename)
+	{
+		if (state != State::Idle)
+		{
+			V_CORE_WARN("Input recorder is busy, can't replay {0}", filename);
+			return false;
+		}
+
+		std::ifstream file(filename, std::ifstream::binary);
+		InputRecordingHeader header;
+
+		if (!file || !file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+			header.magic != INPUT_RECORDING_MAGIC || header.version != INPUT_RECORDING_VERSION)
+		{
+			V_CORE_ERROR("{0} is not an input recording", filename);
+			return false;
+		}
+
+		recorder.records.resize(header.recordCount);
+
+		if (!file.read(reinterpret_cast<char *>(recorder.records.data()), header.recordCount * sizeof(InputRecord)))
+		{
+			V_CORE_ERROR("Input recording {0} is truncated", filename);
+			return false;
+		}
+
+		recorder.filename = filename;
+		recorder.timestep = header.timestep;
+		recorder.frameCount = header.frameCount;
+		recorder.frame = 0;
+		recorder.cursor = 0;
+
+		// keys held when the replay was started (the replay key itself) are not part of the recording, the first
+		// cursor move is measured from the recorded position
+		Input::setLevels(header.levels);
+
+		state = State::Replaying;
+		V_CORE_INFO("Replaying input from {0} ({1} frames)", filename, header.frameCount);
+
+		return true;
+	}
+
+	void InputRecorder::stopReplay()
+	{
+		if (state != State::Replaying)
+			return;
+
+		state = State::Idle;
+		V_CORE_INFO("Input replay of {0} finished after {1} frames", recorder.filename, recorder.frame);
+	}
+
+	float InputRecorder::getTimestep()
+	{
+		return state == State::Replaying ? recorder.timestep : 0.0f;
+	}
+
+	void InputRecorder::record(InputRecordType type, uint16_t code, uint8_t action, float x, float y, double time)
+	{
+		if (state != State::Recording)
+			return;
+
+		// the first frame starts with its first input
+		if (recorder.frameStart == 0.0)
+			recorder.frameStart = time;
+
+		recorder.records.push_back({ recorder.frame, type, action, code, x, y, (float)(time - recorder.frameStart) });
+	}
+
+	const InputRecord *InputRecorder::getFrameRecords(uint32_t &count)
+	{
+		count = 0;
+
+		if (state != State::Replaying)
+			return nullptr;
+
+		size_t end = recorder.cursor;
+
+		while (end < recorder.records.size() && recorder.records[end].frame == recorder.frame)
+			end++;
+
+		count = (uint32_t)(end - recorder.cursor);
+		return count ? &recorder.records[recorder.cursor] : nullptr;
+	}
+
+	double InputRecorder::getReplayTime(const InputRecord &record)
+	{
+		return (double)record.frame * recorder.timestep + record.time;
+	}
+
+	void InputRecorder::endFrame(double time)
+	{
+		if (state == State::Recording)
+		{
+			recorder.frame++;
+			recorder.frameStart = time;
+		}
+		else if (state == State::Replaying)
+		{
+			while (recorder.cursor < recorder.records.size() && recorder.records[recorder.cursor].frame == recorder.frame)
+				recorder.cursor++;
+
+			// one frame past the last, the events of the last frame are still dispatched as part of the replay
+			if (++recorder.frame > recorder.frameCount)
+				InputRecorder::stopReplay();
+		}
+	}
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Viper/Core.h"
+
+namespace Viper
+{
+
+	enum class InputRecordType : uint8_t
+	{
+		Key, MouseButton, CursorMove, Scroll, WindowResize, WindowClose
+	};
+
+	//*************** InputRecord struct ***************//
+	struct InputRecord
+	{
+		// frames since the start of the recording
+		uint32_t frame;
+
+		InputRecordType type;
+		uint8_t action;		// glfw action of keys and buttons
+		uint16_t code;		// key code / button
+
+		// cursor position, scroll offset or window size
+		float x, y;
+
+		// seconds since the start of the frame
+		float time;
+	};
+
+
+	//*************** InputRecorder class ***************//
+	class VIPER_API InputRecorder
+	{
+		/*
+			Records the platform input (everything the window callbacks see) per frame to a binary file and replays it.
+
+			While a replay runs the live keyboard and mouse input is ignored, the window feeds the recorded callbacks
+			of each frame through the same path instead, and the application advances with the fixed timestep of the
+			recording - a run is then identical from frame to frame, e.g. to compare profiler captures or benchmarks.
+
+			A replay starts from the keys, buttons and cursor position that were held when the recording started, and the
+			window reads the live levels back when it ends.
+
+			File: "VREC", version, timestep, frame count, record count, the starting InputLevels, then the InputRecords
+			as they are in memory. Main thread only.
+		*/
+
+	public:
+		// starts with the next frame, the file is written by stopRecording()
+		static void startRecording(const std::string &filename, float timestep = 1.0f / 60.0f);
+		static void stopRecording();
+
+		// starts with the next frame, returns false when the file can't be read
+		static bool startReplay(const std::string &filename);
+		static void stopReplay();
+
+		inline static bool isRecording() { return state == State::Recording; }
+		inline static bool isReplaying() { return state == State::Replaying; }
+
+		// fixed timestep of the running replay (0 without one)
+		static float getTimestep();
+
+		// window side: a callback, 'time' is the glfw time of the callback
+		static void record(InputRecordType type, uint16_t code, uint8_t action, float x, float y, double time);
+
+		// window side: records of the replayed frame (nullptr when there's nothing to replay)
+		static const InputRecord *getFrameRecords(uint32_t &count);
+
+		// synthetic glfw time of a replayed record
+		static double getReplayTime(const InputRecord &record);
+
+		// frame boundary, called by the window after polling
+		static void endFrame(double time);
+
+	private:
+		enum class State
+		{
+			Idle, Recording, Replaying
+		};
+
+		static State state;
+	};
+
+}
@@ -0,0 +1,209 @@
+#include "vpch.h"
+#include "Profiler.h"
+
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <iomanip>
+
+namespace Viper
+{
+
+	#define PROFILE_EVENTS_PER_THREAD 65536
+
+	struct ProfileEvent
+	{
+		const char *name;
+		uint64_t start;
+		uint64_t end;
+	};
+
+	struct ThreadBuffer
+	{
+		/*
+			Written only by its thread. An event is complete before count is published,
+			so the exporter reads everything below count without locking.
+		*/
+
+		std::string name;
+		uint32_t threadId = 0;
+
+		std::vector<ProfileEvent> events;
+		std::atomic<uint32_t> count{ 0 };
+		std::atomic<uint32_t> generation{ 0 };		// capture the events belong to
+		std::atomic<uint32_t> dropped{ 0 };
+	};
+
+	static struct ProfilerState
+	{
+		std::mutex threadsMutex;
+		std::vector<std::unique_ptr<ThreadBuffer>> threads;
+
+		std::atomic<uint32_t> generation{ 0 };
+		uint32_t requestedFrames = 0;
+		uint32_t framesLeft = 0;
+		uint32_t capturedFrames = 0;
+		uint64_t captureStart = 0;
+		std::string filename;
+	} profiler;
+
+	static thread_local ThreadBuffer *threadBuffer = nullptr;
+
+	std::atomic<bool> Profiler::capturing{ false };
+
+	static ThreadBuffer *getThreadBuffer()
+	{
+		if (!threadBuffer)
+		{
+			std::lock_guard<std::mutex> lock(profiler.threadsMutex);
+
+			profiler.threads.push_back(std::make_unique<ThreadBuffer>());
+			threadBuffer = profiler.threads.back().get();
+			threadBuffer->threadId = (uint32_t)profiler.threads.size() - 1;
+			threadBuffer->name = "Thread " + std::to_string(threadBuffer->threadId);
+		}
+
+		return threadBuffer;
+	}
+
+	static void writeJsonString(std::ostream &out, const char *text)
+	{
+		out << '"';
+
+		for (; *text; text++)
+		{
+			if (*text == '"' || *text == '\\')
+				out << '\\';
+
+			out << *text;
+		}
+
+		out << '"';
+	}
+
+	void Profiler::beginCapture(uint32_t frameCount, const std::string &filename)
+	{
+		if (capturing || frameCount == 0)
+			return;
+
+		profiler.requestedFrames = frameCount;
+		profiler.filename = filename;
+	}
+
+	void Profiler::beginFrame()
+	{
+		if (capturing.load(std::memory_order_relaxed) && --profiler.framesLeft == 0)
+			Profiler::endCapture();
+
+		if (profiler.requestedFrames)
+		{
+			// buffers of the previous capture are reset by their threads when they see the new generation
+			profiler.generation.fetch_add(1, std::memory_order_relaxed);
+			profiler.capturedFrames = profiler.requestedFrames;
+			profiler.framesLeft = profiler.requestedFrames;
+			profiler.requestedFrames = 0;
+			profiler.captureStart = Profiler::now();
+
+			capturing.store(true, std::memory_order_relaxed);
+		}
+	}
+
+	void Profiler::setThreadName(const std::string &name)
+	{
+		ThreadBuffer *buffer = getThreadBuffer();
+
+		std::lock_guard<std::mutex> lock(profiler.threadsMutex);
+		buffer->name = name;
+	}
+
+	void Profiler::record(const char *name, uint64_t start, uint64_t end)
+	{
+		ThreadBuffer *buffer = getThreadBuffer();
+		uint32_t generation = profiler.generation.load(std::memory_order_relaxed);
+
+		if (buffer->generation.load(std::memory_order_relaxed) != generation)
+		{
+			if (buffer->events.empty())
+				buffer->events.resize(PROFILE_EVENTS_PER_THREAD);
+
+			buffer->count.store(0, std::memory_order_relaxed);
+			buffer->dropped.store(0, std::memory_order_relaxed);
+			buffer->generation.store(generation, std::memory_order_release);
+		}
+
+		uint32_t index = buffer->count.load(std::memory_order_relaxed);
+
+		if (index == PROFILE_EVENTS_PER_THREAD)
+		{
+			buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		buffer->events[index] = { name, start, end };
+		buffer->count.store(index + 1, std::memory_order_release);
+	}
+
+	uint64_t Profiler::now()
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void Profiler::endCapture()
+	{
+		capturing.store(false, std::memory_order_relaxed);
+
+		std::ofstream file(profiler.filename);
+
+		if (!file.is_open())
+		{
+			V_CORE_ERROR("Profiler: failed to open {0}", profiler.filename);
+			return;
+		}
+
+		uint32_t generation = profiler.generation.load(std::memory_order_relaxed);
+		uint64_t zoneCount = 0;
+		uint64_t droppedCount = 0;
+		bool first = true;
+
+		file << std::fixed << std::setprecision(3);
+		file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+		std::lock_guard<std::mutex> lock(profiler.threadsMutex);
+
+		for (const std::unique_ptr<ThreadBuffer> &buffer : profiler.threads)
+		{
+			file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->threadId << ",\"args\":{\"name\":";
+			writeJsonString(file, buffer->name.c_str());
+			file << "}}";
+			first = false;
+
+			if (buffer->generation.load(std::memory_order_acquire) != generation)
+				continue;
+
+			uint32_t count = buffer->count.load(std::memory_order_acquire);
+			droppedCount += buffer->dropped.load(std::memory_order_relaxed);
+
+			for (uint32_t i = 0; i < count; i++)
+			{
+				const ProfileEvent &event = buffer->events[i];
+
+				// zones that were already open when the capture started
+				if (event.start < profiler.captureStart)
+					continue;
+
+				file << ",\n{\"name\":";
+				writeJsonString(file, event.name);
+				file << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->threadId
+					 << ",\"ts\":" << (event.start - profiler.captureStart) / 1000.0
+					 << ",\"dur\":" << (event.end - event.start) / 1000.0 << "}";
+
+				zoneCount++;
+			}
+		}
+
+		file << "\n]}\n";
+
+		V_CORE_INFO("Profiler: {0} zones of {1} frames written to {2} ({3} dropped)", zoneCount, profiler.capturedFrames, profiler.filename, droppedCount);
+	}
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Viper/Core.h"
+
+#include <atomic>
+
+namespace Viper
+{
+
+	//*************** Profiler class ***************//
+	class VIPER_API Profiler
+	{
+		/*
+			Instrumenting CPU profiler.
+			Zones are only recorded while a capture runs; outside of a capture a zone costs one relaxed atomic load.
+			Every thread appends to its own buffer (single writer, no locks), a capture covers a range of whole frames
+			and is written out as Chrome trace JSON - open it in chrome://tracing or ui.perfetto.dev.
+		*/
+
+	public:
+		// the capture starts with the next frame and is written to filename after frameCount frames
+		static void beginCapture(uint32_t frameCount, const std::string &filename);
+
+		// frame boundary, called by the application before anything of the new frame is recorded
+		static void beginFrame();
+
+		inline static bool isCapturing() { return capturing.load(std::memory_order_relaxed); }
+
+		// name of the calling thread in the trace
+		static void setThreadName(const std::string &name);
+
+		// name has to outlive the capture (string literal, __FUNCTION__, ...)
+		static void record(const char *name, uint64_t start, uint64_t end);
+		static uint64_t now();
+
+	private:
+		static void endCapture();
+
+	private:
+		static std::atomic<bool> capturing;
+	};
+
+
+	//*************** ProfileScope class ***************//
+	class ProfileScope
+	{
+	public:
+		ProfileScope(const char *name)
+			: name(name), start(Profiler::isCapturing() ? Profiler::now() : 0)
+		{
+		}
+
+		~ProfileScope()
+		{
+			if (this->start)
+				Profiler::record(this->name, this->start, Profiler::now());
+		}
+
+		ProfileScope(const ProfileScope &) = delete;
+		ProfileScope &operator=(const ProfileScope &) = delete;
+
+	private:
+		const char *name;
+		uint64_t start;
+	};
+
+}
+
+#define V_PROFILE_CONCAT_IMPL(a, b) a##b
+#define V_PROFILE_CONCAT(a, b) V_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef V_ENABLE_PROFILING
+	#define V_PROFILE_SCOPE(name) ::Viper::ProfileScope V_PROFILE_CONCAT(profileScope, __LINE__)(name)
+	#define V_PROFILE_FUNCTION() V_PROFILE_SCOPE(__FUNCTION__)
+#else
+	#define V_PROFILE_SCOPE(name)
+	#define V_PROFILE_FUNCTION()
+#endif
@@ -0,0 +1,187 @@
+#include "vpch.h"
+#include "StatsOverlay.h"
+
+#include "Viper/Application.h"
+#include "Viper/Renderer/GraphicsContext.h"
+#include "Viper/Memory/MemoryTracker.h"
+
+namespace Viper
+{
+
+	#define STATS_OVERLAY_KEY V_KEY_F3
+	#define STATS_OVERLAY_MARGIN 8.0f
+	#define STATS_OVERLAY_WIDTH 360.0f
+	#define STATS_OVERLAY_TEXT_SCALE 2.0f
+	#define STATS_OVERLAY_GRAPH_HEIGHT 60.0f
+	#define STATS_OVERLAY_GRAPH_MAX_MS 50.0f
+
+	// frame time thresholds of the graph colors (60 and 30 fps)
+	#define STATS_OVERLAY_GOOD_MS 16.7f
+	#define STATS_OVERLAY_BAD_MS 33.4f
+
+	static uint32_t frameTimeColor(float ms)
+	{
+		if (ms <= STATS_OVERLAY_GOOD_MS)
+			return OverlayBatch::packColor(0.3f, 0.9f, 0.3f);
+
+		if (ms <= STATS_OVERLAY_BAD_MS)
+			return OverlayBatch::packColor(0.95f, 0.8f, 0.2f);
+
+		return OverlayBatch::packColor(0.95f, 0.25f, 0.2f);
+	}
+
+
+
+	//*************** StatsOverlay class ***************//
+
+	StatsOverlay::StatsOverlay()
+		: Layer("Stats overlay")
+	{
+	}
+
+	void StatsOverlay::onUpdate()
+	{
+		auto context = static_cast<GraphicsContext *>(Application::get().getWindow().getContextHandle());
+		const RenderStats &stats = context->getStats();
+
+		// the history keeps running while hidden, so the graph is complete when it is shown again
+		this->history[this->historyHead] = stats.frameTime;
+		this->historyHead = (this->historyHead + 1) % HistorySize;
+		this->historyCount = std::min(this->historyCount + 1, HistorySize);
+
+		if (!this->visible)
+			return;
+
+		const Application &app = Application::get();
+		const FrameMemoryStats &memory = MemoryTracker::getLastFrame();
+		OverlayBatch &overlay = context->getOverlay();
+
+		const float lineHeight = (OverlayBatch::GlyphHeight + 3) * STATS_OVERLAY_TEXT_SCALE;
+		const uint32_t lineCount = 8;
+
+		float x = STATS_OVERLAY_MARGIN;
+		float y = STATS_OVERLAY_MARGIN;
+		float panelHeight = lineCount * lineHeight + STATS_OVERLAY_GRAPH_HEIGHT * 2.0f + STATS_OVERLAY_MARGIN * 4.0f;
+
+		overlay.drawRect(x, y, STATS_OVERLAY_WIDTH, panelHeight, OverlayBatch::packColor(0.0f, 0.0f, 0.0f, 0.6f));
+
+		x += STATS_OVERLAY_MARGIN;
+		y += STATS_OVERLAY_MARGIN;
+
+		const uint32_t white = OverlayBatch::packColor(1.0f, 1.0f, 1.0f);
+		char line[96];
+
+		float fps = stats.frameTime > 0.0f ? 1000.0f / stats.frameTime : 0.0f;
+		snprintf(line, sizeof(line), "FPS %.0f  FRAME %.2f MS", fps, stats.frameTime);
+		overlay.drawText(x, y, line, frameTimeColor(stats.frameTime), STATS_OVERLAY_TEXT_SCALE);
+		y += lineHeight;
+
+		snprintf(line, sizeof(line), "MAIN %.2f  RENDER %.2f  GPU %.2f", app.getUpdateTime(), stats.renderThreadTime, stats.gpuTime);
+		overlay.drawText(x, y, line, white, STATS_OVERLAY_TEXT_SCALE);
+		y += lineHeight;
+
+		snprintf(line, sizeof(line), "DRAWS %u  CULLED %u  INDICES %u", stats.drawCalls, stats.drawsCulled, stats.indices);
+		overlay.drawText(x, y, line, white, STATS_OVERLAY_TEXT_SCALE);
+		y += lineHeight;
+
+		snprintf(line, sizeof(line), "BINDS %u  ELIDED %u  PIPELINES %u", stats.getBindsIssued(), stats.getBindsElided(), stats.pipelineBinds);
+		overlay.drawText(x, y, line, white, STATS_OVERLAY_TEXT_SCALE);
+		y += lineHeight;
+
+		snprintf(line, sizeof(line), "SCALE %.2f  %ux%u", stats.renderScale, stats.renderWidth, stats.renderHeight);
+		overlay.drawText(x, y, line, white, STATS_OVERLAY_TEXT_SCALE);
+		y += lineHeight;
+
+		snprintf(line, sizeof(line), "GPU MEM %.1f MB", stats.gpuMemory / (1024.0 * 1024.0));
+		overlay.drawText(x, y, line, white, STATS_OVERLAY_TEXT_SCALE);
+		y += lineHeight;
+
+		snprintf(line, sizeof(line), "EVENTS %u  LATENCY %.2f MS", app.getFrameEventCount(), stats.inputLatency);
+		overlay.drawText(x, y, line, white, STATS_OVERLAY_TEXT_SCALE);
+		y += lineHeight;
+
+		snprintf(line, sizeof(line), "ALLOCS %llu  FREES %llu  %llu KB", (unsigned long long)memory.allocations,
+				 (unsigned long long)memory.frees, (unsigned long long)(memory.bytes / 1024));
+		overlay.drawText(x, y, line, memory.allocations ? frameTimeColor(STATS_OVERLAY_BAD_MS) : white, STATS_OVERLAY_TEXT_SCALE);
+		y += lineHeight + STATS_OVERLAY_MARGIN;
+
+		this->drawGraph(overlay, x, y);
+		y += STATS_OVERLAY_GRAPH_HEIGHT + STATS_OVERLAY_MARGIN;
+
+		this->drawHistogram(overlay, x, y);
+	}
+
+	void StatsOverlay::onEvent(Event &event)
+	{
+		EventDispatcher dispatcher(event);
+		dispatcher.dispatch<KeyPressedEvent>([this](KeyPressedEvent &e) { return this->onKeyPressed(e); });
+	}
+
+	bool StatsOverlay::onKeyPressed(KeyPressedEvent &e)
+	{
+		if (e.getKeyCode() != STATS_OVERLAY_KEY || e.getRepeatCount() != 0)
+			return false;
+
+		this->visible = !this->visible;
+		return true;
+	}
+
+	void StatsOverlay::drawGraph(OverlayBatch &overlay, float x, float y)
+	{
+		/*
+			One bar per frame, oldest on the left. Bars are clamped to STATS_OVERLAY_GRAPH_MAX_MS,
+			the line marks the 60 fps budget.
+		*/
+
+		const float width = STATS_OVERLAY_WIDTH - STATS_OVERLAY_MARGIN * 2.0f;
+		const float barWidth = width / HistorySize;
+
+		overlay.drawRect(x, y, width, STATS_OVERLAY_GRAPH_HEIGHT, OverlayBatch::packColor(0.15f, 0.15f, 0.15f, 0.8f));
+
+		uint32_t first = (this->historyHead + HistorySize - this->historyCount) % HistorySize;
+
+		for (uint32_t i = 0; i < this->historyCount; i++)
+		{
+			float ms = this->history[(first + i) % HistorySize];
+			float height = std::min(ms / STATS_OVERLAY_GRAPH_MAX_MS, 1.0f) * STATS_OVERLAY_GRAPH_HEIGHT;
+
+			overlay.drawRect(x + (HistorySize - this->historyCount + i) * barWidth, y + STATS_OVERLAY_GRAPH_HEIGHT - height, barWidth, height, frameTimeColor(ms));
+		}
+
+		float budget = y + STATS_OVERLAY_GRAPH_HEIGHT * (1.0f - STATS_OVERLAY_GOOD_MS / STATS_OVERLAY_GRAPH_MAX_MS);
+		overlay.drawRect(x, budget, width, 1.0f, OverlayBatch::packColor(1.0f, 1.0f, 1.0f, 0.5f));
+	}
+
+	void StatsOverlay::drawHistogram(OverlayBatch &overlay, float x, float y)
+	{
+		/*
+			Distribution of the frame times in the history over HistogramBuckets equal ranges of [0, STATS_OVERLAY_GRAPH_MAX_MS],
+			the last bucket also takes every slower frame.
+		*/
+
+		std::array<uint32_t, HistogramBuckets> buckets = {};
+		uint32_t largest = 1;
+
+		for (uint32_t i = 0; i < this->historyCount; i++)
+		{
+			float ms = this->history[i];
+			uint32_t bucket = std::min((uint32_t)(ms / STATS_OVERLAY_GRAPH_MAX_MS * HistogramBuckets), HistogramBuckets - 1);
+
+			largest = std::max(largest, ++buckets[bucket]);
+		}
+
+		const float width = STATS_OVERLAY_WIDTH - STATS_OVERLAY_MARGIN * 2.0f;
+		const float bucketWidth = width / HistogramBuckets;
+
+		overlay.drawRect(x, y, width, STATS_OVERLAY_GRAPH_HEIGHT, OverlayBatch::packColor(0.15f, 0.15f, 0.15f, 0.8f));
+
+		for (uint32_t i = 0; i < HistogramBuckets; i++)
+		{
+			float height = (float)buckets[i] / largest * STATS_OVERLAY_GRAPH_HEIGHT;
+			float bucketMs = (i + 0.5f) * STATS_OVERLAY_GRAPH_MAX_MS / HistogramBuckets;
+
+			overlay.drawRect(x + i * bucketWidth + 1.0f, y + STATS_OVERLAY_GRAPH_HEIGHT - height, bucketWidth - 2.0f, height, frameTimeColor(bucketMs));
+		}
+	}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Viper/Core.h"
+#include "Viper/Layer.h"
+#include "Viper/Events/KeyEvent.h"
+
+#include <array>
+
+namespace Viper
+{
+
+	class OverlayBatch;
+
+	//*************** StatsOverlay class ***************//
+	class VIPER_API StatsOverlay : public Layer
+	{
+		/*
+			Frame statistics drawn over the game: frame rate, main/render/GPU times, draw and bind counters,
+			render scale, device memory, events and heap allocations, plus a graph of the recent frame times.
+			Push it as an overlay, F3 shows and hides it. Everything is drawn into the context's overlay batch,
+			which the renderer submits with a single draw call.
+		*/
+
+	public:
+		StatsOverlay();
+
+		void onUpdate() override;
+		void onEvent(Event &event) override;
+
+		inline void setVisible(bool visible) { this->visible = visible; }
+		inline bool isVisible() const { return this->visible; }
+
+	private:
+		bool onKeyPressed(KeyPressedEvent &e);
+
+		void drawGraph(OverlayBatch &overlay, float x, float y);
+		void drawHistogram(OverlayBatch &overlay, float x, float y);
+
+	private:
+		static constexpr uint32_t HistorySize = 120;
+		static constexpr uint32_t HistogramBuckets = 8;
+
+		bool visible = true;
+
+		// frame times in milliseconds, ring buffer
+		std::array<float, HistorySize> history = {};
+		uint32_t historyHead = 0;
+		uint32_t historyCount = 0;
+	};
+
+}
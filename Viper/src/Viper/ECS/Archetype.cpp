@@ -0,0 +1,153 @@
+#include "vpch.h"
+#include "Archetype.h"
+
+#include "Viper/Memory/MemoryTracker.h"
+
+namespace Viper
+{
+
+	#define CHUNK_COLUMN_ALIGNMENT 16
+
+	//*************** ChunkPool class ***************//
+
+	ChunkPool::~ChunkPool()
+	{
+		V_CORE_ASSERT(this->blocks.size() == 0, "chunks are still in use!");
+	}
+
+	uint8_t *ChunkPool::allocate()
+	{
+		V_MEMORY_TAG(ECS);
+
+		return this->blocks.create()->memory;
+	}
+
+	void ChunkPool::free(uint8_t *memory)
+	{
+		this->blocks.destroy(reinterpret_cast<Block*>(memory));
+	}
+
+
+
+	//*************** Archetype class ***************//
+
+	static uint32_t alignOffset(uint32_t offset, uint32_t alignment)
+	{
+		return (offset + alignment - 1) & ~(alignment - 1);
+	}
+
+	Archetype::Archetype(const ComponentMask &mask, ChunkPool &pool)
+		: mask(mask), pool(pool)
+	{
+		this->columns.fill(NoColumn);
+
+		uint32_t bytesPerEntity = sizeof(Entity);
+
+		for (ComponentId id = 0; id < MaxComponents; id++)
+		{
+			if (!mask.test(id))
+				continue;
+
+			const ComponentInfo &info = ComponentRegistry::getInfo(id);
+
+			this->columns[id] = (uint8_t)this->components.size();
+			this->components.push_back(id);
+			this->sizes.push_back(info.size);
+			this->infos.push_back(&info);
+
+			bytesPerEntity += info.size;
+		}
+
+		this->offsets.resize(this->components.size());
+
+		// the estimate ignores the padding between the arrays, shrink until the aligned layout fits
+		for (this->capacity = (uint32_t)(ChunkPool::ChunkSize / bytesPerEntity); this->capacity > 0; this->capacity--)
+		{
+			uint32_t offset = sizeof(Entity) * this->capacity;
+
+			for (size_t column = 0; column < this->components.size(); column++)
+			{
+				offset = alignOffset(offset, CHUNK_COLUMN_ALIGNMENT);
+				this->offsets[column] = offset;
+				offset += this->sizes[column] * this->capacity;
+			}
+
+			if (offset <= ChunkPool::ChunkSize)
+				break;
+		}
+
+		V_CORE_ASSERT(this->capacity > 0, "components of the archetype don't fit in a chunk!");
+	}
+
+	Archetype::~Archetype()
+	{
+		for (Chunk &chunk : this->chunks)
+		{
+			for (size_t column = 0; column < this->components.size(); column++)
+			{
+				uint8_t *array = static_cast<uint8_t*>(this->getArray(chunk, (uint8_t)column));
+
+				for (uint32_t row = 0; row < chunk.count; row++)
+					this->infos[column]->destroy(array + (size_t)row * this->sizes[column]);
+			}
+
+			this->pool.free(chunk.memory);
+		}
+	}
+
+	EntityLocation Archetype::allocate(Entity entity)
+	{
+		if (this->chunks.empty() || this->chunks.back().count == this->capacity)
+		{
+			Chunk chunk;
+			chunk.memory = this->pool.allocate();
+			this->chunks.push_back(chunk);
+		}
+
+		EntityLocation location;
+		location.chunk = (uint32_t)(this->chunks.size() - 1);
+
+		Chunk &chunk = this->chunks.back();
+		location.row = chunk.count++;
+
+		this->getEntities(chunk)[location.row] = entity;
+		this->entityCount++;
+
+		return location;
+	}
+
+	Entity Archetype::remove(const EntityLocation &location, const Archetype *relocatedTo)
+	{
+		for (size_t column = 0; column < this->components.size(); column++)
+		{
+			if (!relocatedTo || !relocatedTo->has(this->components[column]))
+				this->infos[column]->destroy(this->getComponent(location, (uint8_t)column));
+		}
+
+		EntityLocation last;
+		last.chunk = (uint32_t)(this->chunks.size() - 1);
+		last.row = this->chunks.back().count - 1;
+
+		Entity moved;
+
+		if (location.chunk != last.chunk || location.row != last.row)
+		{
+			for (size_t column = 0; column < this->components.size(); column++)
+				this->infos[column]->relocate(this->getComponent(location, (uint8_t)column), this->getComponent(last, (uint8_t)column));
+
+			moved = this->getEntities(this->chunks[last.chunk])[last.row];
+			this->getEntities(this->chunks[location.chunk])[location.row] = moved;
+		}
+
+		this->entityCount--;
+
+		if (--this->chunks.back().count == 0)
+		{
+			this->pool.free(this->chunks.back().memory);
+			this->chunks.pop_back();
+		}
+
+		return moved;
+	}
+
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "Viper/Core.h"
+#include "Viper/ECS/Component.h"
+#include "Viper/Memory/ObjectPool.h"
+
+#include <array>
+#include <vector>
+
+namespace Viper
+{
+
+	//*************** ChunkPool class ***************//
+	class VIPER_API ChunkPool
+	{
+		/*
+			Fixed size blocks backing the archetype chunks, taken from an object pool. Released chunks go back to its free list,
+			so entities moving between archetypes don't hit the heap once the pool has warmed up.
+		*/
+
+	public:
+		static constexpr size_t ChunkSize = 16 * 1024;
+
+		// chunks the pool grows by at a time
+		static constexpr size_t ChunksPerBlock = 8;
+
+		ChunkPool() = default;
+		~ChunkPool();
+
+		ChunkPool(const ChunkPool &) = delete;
+		ChunkPool &operator=(const ChunkPool &) = delete;
+
+		uint8_t *allocate();
+		void free(uint8_t *memory);
+
+		inline size_t getAllocatedCount() const { return this->blocks.capacity(); }
+		inline size_t getFreeCount() const { return this->blocks.capacity() - this->blocks.size(); }
+
+	private:
+		struct alignas(16) Block
+		{
+			// left uninitialized, the archetype constructs the components
+			Block() {}
+
+			uint8_t memory[ChunkSize];
+		};
+
+		ObjectPool<Block, ChunksPerBlock> blocks;
+	};
+
+
+	//*************** Chunk struct ***************//
+	struct Chunk
+	{
+		/*
+			One ChunkSize block: the entity ids followed by one tightly packed array per component (SoA).
+		*/
+
+		uint8_t *memory = nullptr;
+		uint32_t count = 0;
+	};
+
+	struct EntityLocation
+	{
+		uint32_t chunk = 0;
+		uint32_t row = 0;
+	};
+
+
+	//*************** Archetype class ***************//
+	class VIPER_API Archetype
+	{
+		/*
+			Storage of all entities with exactly the same set of components.
+			Rows are kept dense: a removed row is filled with the last row of the last chunk, so every chunk but the last one is full
+			and a query walks contiguous arrays only.
+			Archetypes reached by adding / removing one component are cached as edges, structural changes don't look up the world's table twice.
+		*/
+
+	public:
+		static constexpr uint8_t NoColumn = 0xFF;
+
+		Archetype(const ComponentMask &mask, ChunkPool &pool);
+		~Archetype();
+
+		Archetype(const Archetype &) = delete;
+		Archetype &operator=(const Archetype &) = delete;
+
+		// reserves a row at the end, the component storage of the row is left unconstructed
+		EntityLocation allocate(Entity entity);
+
+		/*
+			Destroys the components of the row and fills it with the last row.
+			Components that also exist in 'relocatedTo' have already been moved out by the caller and are not destroyed.
+			Returns the entity that was moved into the row (null if the removed row was the last one).
+		*/
+		Entity remove(const EntityLocation &location, const Archetype *relocatedTo = nullptr);
+
+		inline bool has(ComponentId id) const { return this->mask.test(id); }
+		inline uint8_t getColumn(ComponentId id) const { return this->columns[id]; }
+
+		inline Entity *getEntities(const Chunk &chunk) const { return reinterpret_cast<Entity*>(chunk.memory); }
+		inline void *getArray(const Chunk &chunk, uint8_t column) const { return chunk.memory + this->offsets[column]; }
+
+		template<typename T>
+		inline T *getArray(const Chunk &chunk) const
+		{
+			uint8_t column = this->columns[ComponentRegistry::getId<T>()];
+			V_CORE_ASSERT(column != NoColumn, "archetype doesn't contain the requested component!");
+
+			return reinterpret_cast<T*>(chunk.memory + this->offsets[column]);
+		}
+
+		inline void *getComponent(const EntityLocation &location, uint8_t column) const
+		{
+			return this->chunks[location.chunk].memory + this->offsets[column] + (size_t)location.row * this->sizes[column];
+		}
+
+		inline Archetype *getAddEdge(ComponentId id) const { return this->addEdges[id]; }
+		inline Archetype *getRemoveEdge(ComponentId id) const { return this->removeEdges[id]; }
+		inline void setAddEdge(ComponentId id, Archetype *archetype) { this->addEdges[id] = archetype; }
+		inline void setRemoveEdge(ComponentId id, Archetype *archetype) { this->removeEdges[id] = archetype; }
+
+		inline const ComponentMask &getMask() const { return this->mask; }
+		inline const std::vector<ComponentId> &getComponents() const { return this->components; }
+		inline const std::vector<Chunk> &getChunks() const { return this->chunks; }
+
+		// entities per chunk
+		inline uint32_t getCapacity() const { return this->capacity; }
+		inline size_t getEntityCount() const { return this->entityCount; }
+
+	private:
+		ComponentMask mask;
+		std::vector<ComponentId> components;
+
+		// per column (component in ascending id order)
+		std::vector<uint32_t> offsets;
+		std::vector<uint32_t> sizes;
+		std::vector<const ComponentInfo*> infos;
+		std::array<uint8_t, MaxComponents> columns;
+
+		std::array<Archetype*, MaxComponents> addEdges = {};
+		std::array<Archetype*, MaxComponents> removeEdges = {};
+
+		std::vector<Chunk> chunks;
+		ChunkPool &pool;
+		uint32_t capacity = 0;
+		size_t entityCount = 0;
+	};
+
+}
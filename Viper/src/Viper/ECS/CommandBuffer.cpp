@@ -0,0 +1,109 @@
+#include "vpch.h"
+#include "CommandBuffer.h"
+
+#include "Viper/ECS/World.h"
+#include "Viper/Memory/FrameAllocator.h"
+
+namespace Viper
+{
+
+	#define COMMAND_BUFFER_VALUE_BLOCK_SIZE (16 * 1024)
+
+	//*************** CommandBuffer class ***************//
+
+	CommandBuffer::CommandBuffer()
+		: values(COMMAND_BUFFER_VALUE_BLOCK_SIZE)
+	{
+	}
+
+	CommandBuffer::~CommandBuffer()
+	{
+		this->clear();
+	}
+
+	Entity CommandBuffer::create()
+	{
+		// placeholder: generation 0 never resolves in a world, the index refers to the buffer's own creations
+		Entity placeholder;
+		placeholder.index = this->createdCount++;
+		placeholder.generation = 0;
+
+		this->record(CommandType::Create, placeholder, 0, nullptr);
+
+		return placeholder;
+	}
+
+	void CommandBuffer::destroy(Entity entity)
+	{
+		this->record(CommandType::Destroy, entity, 0, nullptr);
+	}
+
+	void CommandBuffer::playback(World &world)
+	{
+		// placeholder index -> entity, transient - its size depends on how the work was spread over the threads
+		ScopedArena arena(FrameAllocator::getScratch());
+		Entity *created = arena.allocate<Entity>(this->createdCount);
+
+		for (Command &command : this->commands)
+		{
+			Entity entity = command.entity;
+
+			if (!entity.isNull() && entity.generation == 0)
+				entity = created[entity.index];
+
+			switch (command.type)
+			{
+			case CommandType::Create:
+				created[command.entity.index] = world.create();
+				break;
+
+			case CommandType::Destroy:
+				world.destroy(entity);
+				break;
+
+			case CommandType::Add:
+				if (world.isAlive(entity))
+					world.setComponent(entity, command.component, command.value);
+				else
+					ComponentRegistry::getInfo(command.component).destroy(command.value);
+
+				// the value has been moved out or destroyed, clear() must not touch it again
+				command.value = nullptr;
+				break;
+
+			case CommandType::Remove:
+				world.removeComponent(entity, command.component);
+				break;
+			}
+		}
+
+		this->clear();
+	}
+
+	void CommandBuffer::clear()
+	{
+		for (const Command &command : this->commands)
+		{
+			if (command.value)
+				ComponentRegistry::getInfo(command.component).destroy(command.value);
+		}
+
+		this->commands.clear();
+		this->values.reset();
+		this->createdCount = 0;
+	}
+
+	void CommandBuffer::record(CommandType type, Entity entity, ComponentId component, void *value)
+	{
+		V_CORE_ASSERT(type == CommandType::Create || !entity.isNull(), "recording a command for a null entity!");
+
+		Command command;
+		command.type = type;
+		command.component = component;
+		command.entity = entity;
+		command.value = value;
+
+		this->commands.push_back(command);
+	}
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Viper/Core.h"
+#include "Viper/ECS/Component.h"
+#include "Viper/Memory/LinearAllocator.h"
+
+#include <vector>
+
+namespace Viper
+{
+
+	class World;
+
+	//*************** CommandBuffer class ***************//
+	class VIPER_API CommandBuffer
+	{
+		/*
+			Structural changes (create / destroy / add / remove) recorded while a query is iterating and applied later in record order.
+			Entities created by the buffer are placeholders until playback - they are only valid as arguments of the same buffer.
+			Commands targeting an entity that no longer exists at playback are dropped.
+			Component values are moved into a linear allocator, recording doesn't touch the heap once the buffer has warmed up.
+			Not thread safe, every thread records into its own buffer (see World::getCommandBuffer()).
+		*/
+
+	public:
+		CommandBuffer();
+		~CommandBuffer();
+
+		CommandBuffer(const CommandBuffer &) = delete;
+		CommandBuffer &operator=(const CommandBuffer &) = delete;
+
+		Entity create();
+		void destroy(Entity entity);
+
+		template<typename T, typename... Args>
+		void add(Entity entity, Args&&... args)
+		{
+			void *value = this->values.allocate(sizeof(T), alignof(T));
+			new (value) T(std::forward<Args>(args)...);
+
+			this->record(CommandType::Add, entity, ComponentRegistry::getId<T>(), value);
+		}
+
+		template<typename T>
+		void remove(Entity entity)
+		{
+			this->record(CommandType::Remove, entity, ComponentRegistry::getId<T>(), nullptr);
+		}
+
+		// applies and clears the recorded commands
+		void playback(World &world);
+
+		// drops the recorded commands without applying them
+		void clear();
+
+		inline bool isEmpty() const { return this->commands.empty(); }
+		inline size_t size() const { return this->commands.size(); }
+
+	private:
+		enum class CommandType : uint8_t
+		{
+			Create, Destroy, Add, Remove
+		};
+
+		struct Command
+		{
+			CommandType type;
+			ComponentId component;
+			Entity entity;
+			void *value;
+		};
+
+		void record(CommandType type, Entity entity, ComponentId component, void *value);
+
+	private:
+		std::vector<Command> commands;
+		LinearAllocator values;
+		uint32_t createdCount = 0;
+	};
+
+}
@@ -0,0 +1,41 @@
+#include "vpch.h"
+#include "Component.h"
+
+#include <atomic>
+#include <mutex>
+
+namespace Viper
+{
+
+	//*************** ComponentRegistry class ***************//
+
+	// entries are written once before the count is published and never change afterwards
+	static ComponentInfo componentInfos[MaxComponents];
+	static std::atomic<uint32_t> componentCount(0);
+	static std::mutex registryMutex;
+
+	const ComponentInfo &ComponentRegistry::getInfo(ComponentId id)
+	{
+		V_CORE_ASSERT(id < componentCount.load(std::memory_order_acquire), "unknown component id!");
+		return componentInfos[id];
+	}
+
+	uint32_t ComponentRegistry::getCount()
+	{
+		return componentCount.load(std::memory_order_acquire);
+	}
+
+	ComponentId ComponentRegistry::registerComponent(const ComponentInfo &info)
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+
+		ComponentId id = componentCount.load(std::memory_order_relaxed);
+		V_CORE_ASSERT(id < MaxComponents, "too many component types, raise MaxComponents!");
+
+		componentInfos[id] = info;
+		componentCount.store(id + 1, std::memory_order_release);
+
+		return id;
+	}
+
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "Viper/Core.h"
+
+#include <bitset>
+#include <new>
+#include <type_traits>
+#include <typeinfo>
+
+namespace Viper
+{
+
+	//*************** Entity struct ***************//
+	struct Entity
+	{
+		/*
+			Index of the entity's record in its World + generation of the record when the entity was created.
+			Destroying the entity bumps the generation, so a stale id stops resolving. A default constructed entity is null.
+		*/
+
+		static constexpr uint32_t InvalidIndex = ~0u;
+
+		uint32_t index = InvalidIndex;
+		uint32_t generation = 0;
+
+		inline bool isNull() const { return this->index == InvalidIndex; }
+
+		inline bool operator==(const Entity &other) const { return this->index == other.index && this->generation == other.generation; }
+		inline bool operator!=(const Entity &other) const { return !(*this == other); }
+	};
+
+
+	using ComponentId = uint32_t;
+
+	static constexpr uint32_t MaxComponents = 64;
+	using ComponentMask = std::bitset<MaxComponents>;
+
+	//*************** ComponentInfo struct ***************//
+	struct ComponentInfo
+	{
+		const char *name = nullptr;
+		uint32_t size = 0;
+		uint32_t alignment = 0;
+
+		void (*construct)(void *memory) = nullptr;
+		void (*destroy)(void *object) = nullptr;
+
+		// move constructs dst from src and destroys src - components never live at two places
+		void (*relocate)(void *dst, void *src) = nullptr;
+	};
+
+
+	//*************** ComponentRegistry class ***************//
+	class VIPER_API ComponentRegistry
+	{
+		/*
+			Process wide ids of component types, handed out on first use of a type.
+			Any default and move constructible type can be a component.
+		*/
+
+	public:
+		template<typename T>
+		static ComponentId getId()
+		{
+			static const ComponentId id = ComponentRegistry::registerComponent(ComponentRegistry::makeInfo<T>());
+			return id;
+		}
+
+		template<typename... Ts>
+		static ComponentMask getMask()
+		{
+			ComponentMask mask;
+			(mask.set(ComponentRegistry::getId<Ts>()), ...);
+			return mask;
+		}
+
+		static const ComponentInfo &getInfo(ComponentId id);
+		static uint32_t getCount();
+
+	private:
+		template<typename T>
+		static ComponentInfo makeInfo()
+		{
+			static_assert(std::is_default_constructible<T>::value, "components have to be default constructible");
+			static_assert(std::is_move_constructible<T>::value, "components have to be move constructible");
+			static_assert(alignof(T) <= 16, "component is over-aligned, chunks only guarantee 16 byte alignment");
+
+			ComponentInfo info;
+			info.name = typeid(T).name();
+			info.size = sizeof(T);
+			info.alignment = alignof(T);
+			info.construct = [](void *memory) { new (memory) T(); };
+			info.destroy = [](void *object) { static_cast<T*>(object)->~T(); };
+			info.relocate = [](void *dst, void *src)
+			{
+				new (dst) T(std::move(*static_cast<T*>(src)));
+				static_cast<T*>(src)->~T();
+			};
+
+			return info;
+		}
+
+		static ComponentId registerComponent(const ComponentInfo &info);
+	};
+
+}
@@ -0,0 +1,312 @@
+#include "vpch.h"
+#include "World.h"
+
+#include "Viper/Memory/MemoryTracker.h"
+
+namespace Viper
+{
+
+	//*************** Query class ***************//
+
+	Query::Query(World &world, const ComponentMask &include, const ComponentMask &exclude)
+		: world(world), include(include), exclude(exclude)
+	{
+	}
+
+	size_t Query::getEntityCount()
+	{
+		this->refresh();
+
+		size_t count = 0;
+		for (Archetype *archetype : this->archetypes)
+			count += archetype->getEntityCount();
+
+		return count;
+	}
+
+	const std::vector<Archetype*> &Query::getArchetypes()
+	{
+		this->refresh();
+		return this->archetypes;
+	}
+
+	void Query::refresh()
+	{
+		// archetypes are never destroyed before their world, only the new ones have to be tested
+		for (; this->archetypesTested < this->world.archetypes.size(); this->archetypesTested++)
+		{
+			Archetype *archetype = this->world.archetypes[this->archetypesTested].get();
+			const ComponentMask &mask = archetype->getMask();
+
+			if ((mask & this->include) == this->include && (mask & this->exclude).none())
+				this->archetypes.push_back(archetype);
+		}
+	}
+
+
+
+	//*************** World class ***************//
+
+	World::World()
+		: iterating(0)
+	{
+		this->emptyArchetype = this->getArchetype(ComponentMask());
+		this->prepareCommandBuffers();
+	}
+
+	World::~World()
+	{
+		// pending commands may hold component values
+		this->commandBuffers.clear();
+		this->queries.clear();
+		this->archetypes.clear();
+	}
+
+	Entity World::create()
+	{
+		return this->allocateEntity(this->emptyArchetype);
+	}
+
+	void World::destroy(Entity entity)
+	{
+		this->checkStructuralChange();
+
+		EntityRecord *record = this->getRecord(entity);
+
+		if (!record)
+			return;
+
+		Entity moved = record->archetype->remove(record->location);
+
+		if (!moved.isNull())
+			this->records[moved.index].location = record->location;
+
+		record->archetype = nullptr;
+		record->generation++;
+
+		this->freeRecords.push_back(entity.index);
+		this->entityCount--;
+	}
+
+	bool World::isAlive(Entity entity) const
+	{
+		return this->getRecord(entity) != nullptr;
+	}
+
+	Query &World::query(const ComponentMask &include, const ComponentMask &exclude)
+	{
+		for (std::unique_ptr<Query> &query : this->queries)
+		{
+			if (query->getInclude() == include && query->getExclude() == exclude)
+				return *query;
+		}
+
+		V_MEMORY_TAG(ECS);
+
+		this->queries.push_back(std::make_unique<Query>(*this, include, exclude));
+		return *this->queries.back();
+	}
+
+	CommandBuffer &World::getCommandBuffer()
+	{
+		int32_t threadIndex = JobSystem::getThreadIndex();
+
+		// without a running job system the (unregistered) main thread records into the first buffer
+		V_CORE_ASSERT(threadIndex >= 0 || JobSystem::getWorkerCount() == 0, "command buffers are only available to the main thread and job system workers!");
+		V_CORE_ASSERT(std::max(threadIndex, 0) < (int32_t)this->commandBuffers.size(), "job system was started after the world, call flush() first!");
+
+		return *this->commandBuffers[std::max(threadIndex, 0)];
+	}
+
+	void World::flush()
+	{
+		this->checkStructuralChange();
+
+		for (std::unique_ptr<CommandBuffer> &commandBuffer : this->commandBuffers)
+			commandBuffer->playback(*this);
+	}
+
+	void World::setComponent(Entity entity, ComponentId id, void *value)
+	{
+		const ComponentInfo &info = ComponentRegistry::getInfo(id);
+		EntityRecord *record = this->getRecord(entity);
+
+		V_CORE_ASSERT(record, "setting a component of a dead entity!");
+
+		uint8_t column = record->archetype->getColumn(id);
+
+		if (column != Archetype::NoColumn)
+		{
+			void *existing = record->archetype->getComponent(record->location, column);
+			info.destroy(existing);
+			info.relocate(existing, value);
+		}
+		else
+		{
+			info.relocate(this->addComponent(entity, id), value);
+		}
+	}
+
+	void World::removeComponent(Entity entity, ComponentId id)
+	{
+		this->checkStructuralChange();
+
+		EntityRecord *record = this->getRecord(entity);
+
+		if (!record || !record->archetype->has(id))
+			return;
+
+		this->moveEntity(*record, this->getRemoveTarget(record->archetype, id));
+	}
+
+	Entity World::allocateEntity(Archetype *archetype)
+	{
+		this->checkStructuralChange();
+
+		Entity entity;
+
+		if (!this->freeRecords.empty())
+		{
+			entity.index = this->freeRecords.back();
+			this->freeRecords.pop_back();
+		}
+		else
+		{
+			V_MEMORY_TAG(ECS);
+
+			entity.index = (uint32_t)this->records.size();
+			this->records.emplace_back();
+		}
+
+		EntityRecord &record = this->records[entity.index];
+		entity.generation = record.generation;
+
+		record.archetype = archetype;
+		record.location = archetype->allocate(entity);
+
+		this->entityCount++;
+
+		return entity;
+	}
+
+	World::EntityRecord *World::getRecord(Entity entity)
+	{
+		if (entity.index >= this->records.size())
+			return nullptr;
+
+		EntityRecord &record = this->records[entity.index];
+
+		if (!record.archetype || record.generation != entity.generation)
+			return nullptr;
+
+		return &record;
+	}
+
+	const World::EntityRecord *World::getRecord(Entity entity) const
+	{
+		return const_cast<World*>(this)->getRecord(entity);
+	}
+
+	Archetype *World::getArchetype(const ComponentMask &mask)
+	{
+		auto it = this->archetypeTable.find(mask);
+
+		if (it != this->archetypeTable.end())
+			return it->second;
+
+		V_MEMORY_TAG(ECS);
+
+		this->archetypes.push_back(std::make_unique<Archetype>(mask, this->chunkPool));
+
+		Archetype *archetype = this->archetypes.back().get();
+		this->archetypeTable[mask] = archetype;
+
+		return archetype;
+	}
+
+	Archetype *World::getAddTarget(Archetype *archetype, ComponentId id)
+	{
+		Archetype *target = archetype->getAddEdge(id);
+
+		if (!target)
+		{
+			target = this->getArchetype(ComponentMask(archetype->getMask()).set(id));
+
+			archetype->setAddEdge(id, target);
+			target->setRemoveEdge(id, archetype);
+		}
+
+		return target;
+	}
+
+	Archetype *World::getRemoveTarget(Archetype *archetype, ComponentId id)
+	{
+		Archetype *target = archetype->getRemoveEdge(id);
+
+		if (!target)
+		{
+			target = this->getArchetype(ComponentMask(archetype->getMask()).reset(id));
+
+			archetype->setRemoveEdge(id, target);
+			target->setAddEdge(id, archetype);
+		}
+
+		return target;
+	}
+
+	void World::moveEntity(EntityRecord &record, Archetype *target)
+	{
+		Archetype *source = record.archetype;
+		Entity entity = source->getEntities(source->getChunks()[record.location.chunk])[record.location.row];
+
+		EntityLocation location = target->allocate(entity);
+
+		const std::vector<ComponentId> &components = source->getComponents();
+
+		for (size_t column = 0; column < components.size(); column++)
+		{
+			uint8_t targetColumn = target->getColumn(components[column]);
+
+			if (targetColumn != Archetype::NoColumn)
+			{
+				ComponentRegistry::getInfo(components[column]).relocate(
+					target->getComponent(location, targetColumn), source->getComponent(record.location, (uint8_t)column));
+			}
+		}
+
+		Entity moved = source->remove(record.location, target);
+
+		if (!moved.isNull())
+			this->records[moved.index].location = record.location;
+
+		record.archetype = target;
+		record.location = location;
+	}
+
+	void *World::addComponent(Entity entity, ComponentId id)
+	{
+		this->checkStructuralChange();
+
+		EntityRecord *record = this->getRecord(entity);
+		V_CORE_ASSERT(record, "adding a component to a dead entity!");
+
+		Archetype *target = this->getAddTarget(record->archetype, id);
+		this->moveEntity(*record, target);
+
+		return target->getComponent(record->location, target->getColumn(id));
+	}
+
+	void World::prepareCommandBuffers()
+	{
+		size_t count = JobSystem::getWorkerCount() + 1;
+
+		while (this->commandBuffers.size() < count)
+			this->commandBuffers.push_back(std::make_unique<CommandBuffer>());
+	}
+
+	void World::checkStructuralChange() const
+	{
+		V_CORE_ASSERT(this->iterating.load(std::memory_order_relaxed) == 0, "structural change while a query is iterating, record it in a command buffer!");
+	}
+
+}
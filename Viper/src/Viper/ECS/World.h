@@ -0,0 +1,316 @@
+#pragma once
+
+#include "Viper/Core.h"
+#include "Viper/ECS/Component.h"
+#include "Viper/ECS/Archetype.h"
+#include "Viper/ECS/CommandBuffer.h"
+#include "Viper/Jobs/JobSystem.h"
+#include "Viper/Memory/FrameAllocator.h"
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Viper
+{
+
+	class World;
+
+	//*************** Query class ***************//
+	class VIPER_API Query
+	{
+		/*
+			Entities having all 'include' and none of the 'exclude' components.
+			The matching archetypes are cached and only archetypes created since the last use are tested, so iterating an
+			established query is a walk over chunk arrays. Queries are owned and deduplicated by their World.
+
+			Structural changes are not allowed while a query iterates - record them in a CommandBuffer and flush afterwards.
+		*/
+
+	public:
+		Query(World &world, const ComponentMask &include, const ComponentMask &exclude);
+
+		// func(Entity, Ts&...) for every matching entity
+		template<typename... Ts, typename F>
+		void each(F &&func);
+
+		// func(count, const Entity *, Ts *...) once per chunk, for loops over the raw arrays
+		template<typename... Ts, typename F>
+		void eachChunk(F &&func);
+
+		// each() with the chunks spread over the job system, func has to be safe to call concurrently
+		template<typename... Ts, typename F>
+		void parallelEach(F &&func, uint32_t chunksPerJob = 1);
+
+		size_t getEntityCount();
+		const std::vector<Archetype*> &getArchetypes();
+
+		inline const ComponentMask &getInclude() const { return this->include; }
+		inline const ComponentMask &getExclude() const { return this->exclude; }
+
+	private:
+		void refresh();
+
+		template<typename F, typename... Us>
+		static void eachRow(F &func, const Entity *entities, uint32_t count, Us *...arrays)
+		{
+			for (uint32_t row = 0; row < count; row++)
+				func(entities[row], arrays[row]...);
+		}
+
+	private:
+		struct ChunkRef
+		{
+			Archetype *archetype;
+			const Chunk *chunk;
+		};
+
+		World &world;
+		ComponentMask include;
+		ComponentMask exclude;
+
+		std::vector<Archetype*> archetypes;
+		size_t archetypesTested = 0;
+	};
+
+
+	//*************** World class ***************//
+	class VIPER_API World
+	{
+		/*
+			Archetype based entity-component storage.
+			Every distinct set of components is an archetype storing its entities in 16 KB chunks of SoA arrays;
+			adding or removing a component moves the entity's row to the neighbouring archetype.
+			An entity id resolves through a generational record to (archetype, chunk, row).
+
+			Not thread safe for structural changes - jobs started by Query::parallelEach() record them through
+			getCommandBuffer() and flush() applies them on the calling thread.
+		*/
+
+	public:
+		World();
+		~World();
+
+		World(const World &) = delete;
+		World &operator=(const World &) = delete;
+
+		Entity create();
+
+		template<typename... Ts>
+		Entity create(Ts&&... components)
+		{
+			ComponentMask mask = ComponentRegistry::getMask<typename std::decay<Ts>::type...>();
+			V_CORE_ASSERT(mask.count() == sizeof...(Ts), "component type passed twice!");
+
+			Archetype *archetype = this->getArchetype(mask);
+			Entity entity = this->allocateEntity(archetype);
+			const EntityLocation &location = this->records[entity.index].location;
+
+			(new (archetype->getComponent(location, archetype->getColumn(ComponentRegistry::getId<typename std::decay<Ts>::type>())))
+				typename std::decay<Ts>::type(std::forward<Ts>(components)), ...);
+
+			return entity;
+		}
+
+		void destroy(Entity entity);
+		bool isAlive(Entity entity) const;
+
+		// replaces the value if the entity already has the component
+		template<typename T, typename... Args>
+		T &add(Entity entity, Args&&... args)
+		{
+			if (T *existing = this->get<T>(entity))
+			{
+				*existing = T(std::forward<Args>(args)...);
+				return *existing;
+			}
+
+			return *new (this->addComponent(entity, ComponentRegistry::getId<T>())) T(std::forward<Args>(args)...);
+		}
+
+		template<typename T>
+		void remove(Entity entity)
+		{
+			this->removeComponent(entity, ComponentRegistry::getId<T>());
+		}
+
+		// nullptr if the entity is dead or doesn't have the component
+		template<typename T>
+		T *get(Entity entity)
+		{
+			const EntityRecord *record = this->getRecord(entity);
+
+			if (!record)
+				return nullptr;
+
+			uint8_t column = record->archetype->getColumn(ComponentRegistry::getId<T>());
+
+			if (column == Archetype::NoColumn)
+				return nullptr;
+
+			return static_cast<T*>(record->archetype->getComponent(record->location, column));
+		}
+
+		template<typename T>
+		inline bool has(Entity entity) const
+		{
+			const EntityRecord *record = this->getRecord(entity);
+			return record && record->archetype->has(ComponentRegistry::getId<T>());
+		}
+
+		// cached query over the entities having all Ts (and none of 'exclude')
+		template<typename... Ts>
+		inline Query &query(const ComponentMask &exclude = ComponentMask())
+		{
+			return this->query(ComponentRegistry::getMask<Ts...>(), exclude);
+		}
+
+		Query &query(const ComponentMask &include, const ComponentMask &exclude);
+
+		template<typename... Ts, typename F>
+		inline void each(F &&func)
+		{
+			this->query<Ts...>().template each<Ts...>(std::forward<F>(func));
+		}
+
+		// command buffer of the calling thread (main thread or job system worker)
+		CommandBuffer &getCommandBuffer();
+
+		// plays back the command buffers of all threads
+		void flush();
+
+		// type erased structural changes used by the command buffers, 'value' is moved from and destroyed
+		void setComponent(Entity entity, ComponentId id, void *value);
+		void removeComponent(Entity entity, ComponentId id);
+
+		inline size_t getEntityCount() const { return this->entityCount; }
+		inline size_t getArchetypeCount() const { return this->archetypes.size(); }
+		inline size_t getChunkCount() const { return this->chunkPool.getAllocatedCount() - this->chunkPool.getFreeCount(); }
+
+	private:
+		friend class Query;
+
+		struct EntityRecord
+		{
+			Archetype *archetype = nullptr;
+			EntityLocation location;
+			uint32_t generation = 1;	// 0 is never valid, command buffers use it for their placeholders
+		};
+
+		// structural changes are checked against this while queries run
+		class IterationScope
+		{
+		public:
+			IterationScope(World &world) : world(world) { this->world.iterating.fetch_add(1, std::memory_order_relaxed); }
+			~IterationScope() { this->world.iterating.fetch_sub(1, std::memory_order_relaxed); }
+
+		private:
+			World &world;
+		};
+
+		Entity allocateEntity(Archetype *archetype);
+
+		// nullptr for a null, placeholder or stale entity
+		EntityRecord *getRecord(Entity entity);
+		const EntityRecord *getRecord(Entity entity) const;
+
+		Archetype *getArchetype(const ComponentMask &mask);
+		Archetype *getAddTarget(Archetype *archetype, ComponentId id);
+		Archetype *getRemoveTarget(Archetype *archetype, ComponentId id);
+
+		// moves the row of the entity to the target archetype, components missing in the target are destroyed
+		void moveEntity(EntityRecord &record, Archetype *target);
+
+		// moves the entity to the archetype with the component and returns the unconstructed storage of the component
+		void *addComponent(Entity entity, ComponentId id);
+
+		void prepareCommandBuffers();
+		void checkStructuralChange() const;
+
+	private:
+		// declared first - destroyed after the archetypes returned their chunks
+		ChunkPool chunkPool;
+
+		std::vector<std::unique_ptr<Archetype>> archetypes;
+		std::unordered_map<ComponentMask, Archetype*> archetypeTable;
+		Archetype *emptyArchetype = nullptr;
+
+		std::vector<EntityRecord> records;
+		std::vector<uint32_t> freeRecords;
+		size_t entityCount = 0;
+
+		std::vector<std::unique_ptr<Query>> queries;
+		std::vector<std::unique_ptr<CommandBuffer>> commandBuffers;
+
+		std::atomic<uint32_t> iterating;
+	};
+
+
+
+	//*************** Query class ***************//
+
+	template<typename... Ts, typename F>
+	void Query::each(F &&func)
+	{
+		V_CORE_ASSERT((ComponentRegistry::getMask<Ts...>() & ~this->include).none(), "query doesn't include the requested components!");
+
+		this->refresh();
+		World::IterationScope scope(this->world);
+
+		for (Archetype *archetype : this->archetypes)
+		{
+			for (const Chunk &chunk : archetype->getChunks())
+				Query::eachRow(func, archetype->getEntities(chunk), chunk.count, archetype->template getArray<Ts>(chunk)...);
+		}
+	}
+
+	template<typename... Ts, typename F>
+	void Query::eachChunk(F &&func)
+	{
+		V_CORE_ASSERT((ComponentRegistry::getMask<Ts...>() & ~this->include).none(), "query doesn't include the requested components!");
+
+		this->refresh();
+		World::IterationScope scope(this->world);
+
+		for (Archetype *archetype : this->archetypes)
+		{
+			for (const Chunk &chunk : archetype->getChunks())
+				func(chunk.count, (const Entity*)archetype->getEntities(chunk), archetype->template getArray<Ts>(chunk)...);
+		}
+	}
+
+	template<typename... Ts, typename F>
+	void Query::parallelEach(F &&func, uint32_t chunksPerJob)
+	{
+		V_CORE_ASSERT((ComponentRegistry::getMask<Ts...>() & ~this->include).none(), "query doesn't include the requested components!");
+
+		this->refresh();
+		this->world.prepareCommandBuffers();
+
+		// the chunk list only lives for this call, the jobs read it from the calling thread's scratch arena
+		uint32_t chunkCount = 0;
+
+		for (Archetype *archetype : this->archetypes)
+			chunkCount += (uint32_t)archetype->getChunks().size();
+
+		ScopedArena arena(FrameAllocator::getScratch());
+		ChunkRef *chunks = arena.allocate<ChunkRef>(chunkCount);
+		uint32_t chunkIndex = 0;
+
+		for (Archetype *archetype : this->archetypes)
+		{
+			for (const Chunk &chunk : archetype->getChunks())
+				chunks[chunkIndex++] = { archetype, &chunk };
+		}
+
+		World::IterationScope scope(this->world);
+
+		JobSystem::parallelFor(chunkCount, chunksPerJob, [chunks, &func](uint32_t index)
+		{
+			const ChunkRef &ref = chunks[index];
+			Query::eachRow(func, ref.archetype->getEntities(*ref.chunk), ref.chunk->count, ref.archetype->template getArray<Ts>(*ref.chunk)...);
+		});
+	}
+
+}
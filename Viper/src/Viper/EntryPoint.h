@@ -15,6 +15,8 @@
 		app->run();
 		delete app;
 
+		Viper::Log::shutdown();
+
 	}
 
 #else
@@ -9,7 +9,7 @@ namespace Viper
 	class VIPER_API WindowResizeEvent : public Event
 	{
 	public:
-		WindowResizeEvent(uint16_t width, uint16_t height) : width(width), height(height) { }
+		WindowResizeEvent(uint16_t width, uint16_t height) : Event(getStaticType(), getStaticCategoryFlags()), width(width), height(height) { }
 
 		inline uint16_t getWidth() const { return this->width; };
 		inline uint16_t getHeight() const { return this->height; };
@@ -32,7 +32,7 @@ namespace Viper
 	class VIPER_API WindowCloseEvent : public Event
 	{
 	public:
-		WindowCloseEvent() { }
+		WindowCloseEvent() : Event(getStaticType(), getStaticCategoryFlags()) { }
 
 		EVENT_CLASS_TYPE(WindowClose);
 		EVENT_CLASS_CATEGORY(EventCategoryApplication);
@@ -43,7 +43,7 @@ namespace Viper
 	class VIPER_API AppTickEvent : public Event
 	{
 	public:
-		AppTickEvent() { }
+		AppTickEvent() : Event(getStaticType(), getStaticCategoryFlags()) { }
 
 		EVENT_CLASS_TYPE(AppTick);
 		EVENT_CLASS_CATEGORY(EventCategoryApplication);
@@ -54,7 +54,7 @@ namespace Viper
 	class VIPER_API AppUpdateEvent : public Event
 	{
 	public:
-		AppUpdateEvent() { }
+		AppUpdateEvent() : Event(getStaticType(), getStaticCategoryFlags()) { }
 
 		EVENT_CLASS_TYPE(AppUpdate);
 		EVENT_CLASS_CATEGORY(EventCategoryApplication);
@@ -65,9 +65,39 @@ namespace Viper
 	class VIPER_API AppRenderEvent : public Event
 	{
 	public:
-		AppRenderEvent() { }
+		AppRenderEvent() : Event(getStaticType(), getStaticCategoryFlags()) { }
 
 		EVENT_CLASS_TYPE(AppRender);
 		EVENT_CLASS_CATEGORY(EventCategoryApplication);
 	};
+
+
+	//*************** UserEvent class ***************//
+	class VIPER_API UserEvent : public Event
+	{
+		/*
+			Application defined notification (e.g. an asset finished loading on a worker thread).
+			The meaning of the id and payload is up to the application.
+		*/
+
+	public:
+		UserEvent(uint32_t id, uint64_t payload) : Event(getStaticType(), getStaticCategoryFlags()), id(id), payload(payload) { }
+
+		inline uint32_t getId() const { return this->id; }
+		inline uint64_t getPayload() const { return this->payload; }
+
+		std::string toString() const override
+		{
+			std::stringstream ss;
+			ss << "UserEvent: " << this->id << ", " << this->payload;
+			return ss.str();
+		}
+
+		EVENT_CLASS_TYPE(AppUser);
+		EVENT_CLASS_CATEGORY(EventCategoryApplication);
+
+	private:
+		uint32_t id;
+		uint64_t payload;
+	};
 }
\ No newline at end of file
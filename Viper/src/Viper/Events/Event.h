@@ -10,9 +10,11 @@ namespace Viper
 	{
 		None = 0,
 		WindowClose, WindowResize, WindowFocus, WindowLostFocus, WindowMoved,
-		AppTick, AppUpdate, AppRender,
+		AppTick, AppUpdate, AppRender, AppUser,
 		KeyPressed, KeyReleased,
-		MouseButtonPressed, MouseButtonReleased, MouseMoved, MouseScrolled
+		MouseButtonPressed, MouseButtonReleased, MouseMoved, MouseScrolled,
+
+		Count	// number of event types, size of the handler tables
 	};
 
 	enum EventCategory
@@ -25,11 +27,11 @@ namespace Viper
 		EventCategoryMouseButton		= BIT(4)
 	};
 
-	#define EVENT_CLASS_TYPE(type)  static EventType getStaticType() { return EventType::##type; }\
-									virtual EventType getEventType() const override { return getStaticType(); }\
+	// type and category flags are stored in the Event itself (passed to its constructor), so querying them is not a virtual call
+	#define EVENT_CLASS_TYPE(type)  static constexpr EventType getStaticType() { return EventType::type; }\
 									virtual const char *getName() const override { return #type; }
 
-	#define EVENT_CLASS_CATEGORY(category) virtual uint32_t getCategoryFlags() const override { return category; }
+	#define EVENT_CLASS_CATEGORY(category) static constexpr uint32_t getStaticCategoryFlags() { return category; }
 
 	//*************** Event class ***************//
 	class VIPER_API Event
@@ -37,9 +39,13 @@ namespace Viper
 		friend class EventDispatcher;
 
 	public:
-		virtual EventType getEventType() const = 0;
+		virtual ~Event() { }
+
+		inline EventType getEventType() const { return this->type; }
+		inline uint32_t getCategoryFlags() const { return this->categoryFlags; }
+
+		// names and strings are only meant for logging
 		virtual const char *getName() const = 0;
-		virtual uint32_t getCategoryFlags() const = 0;
 		virtual std::string toString() const { return this->getName(); }
 
 		inline bool isInCategory(EventCategory category)
@@ -47,26 +53,35 @@ namespace Viper
 			return getCategoryFlags() & category;
 		}
 
+	protected:
+		Event(EventType type, uint32_t categoryFlags) : type(type), categoryFlags(categoryFlags) { }
+
 	public:
 		bool handled = false;	
+
+	private:
+		EventType type;
+		uint32_t categoryFlags;
 	};
 
 
 	//*************** EventDispatcher class ***************//
 	class EventDispatcher
 	{
-		template<typename T>
-		using eventFunc = std::function<bool(T&)>;
+		/*
+			Ad hoc dispatch of a single event, the handler is any callable taking T& and returning bool.
+			The callable is taken by template parameter, so a lambda is called directly without being wrapped in a std::function.
+		*/
 
 	public:
 		EventDispatcher(Event &e) : e(e) { }
 
-		template<typename T>
-		bool dispatch(eventFunc<T> func)
+		template<typename T, typename F>
+		bool dispatch(const F &func)
 		{
 			if (e.getEventType() == T::getStaticType())
 			{
-				e.handled = func(*(T*)&e);
+				e.handled = func(static_cast<T&>(e));
 				return true;
 			}
 			return false;
@@ -76,6 +91,72 @@ namespace Viper
 		Event &e;
 	};
 
+
+	//*************** EventHandlerTable class ***************//
+	class EventHandlerTable
+	{
+		/*
+			Handlers registered once per EventType into a flat table indexed by the type.
+			Every slot is a plain delegate (object pointer + function pointer), dispatching an event is one
+			indexed load and one indirect call - no allocation, no type comparisons.
+		*/
+
+	public:
+		// member function handler: table.bind<WindowCloseEvent, Application, &Application::onWindowClose>(this)
+		template<typename T, typename C, bool (C::*Method)(T&)>
+		void bind(C *instance)
+		{
+			this->handlers[(size_t)T::getStaticType()] = { instance, &EventHandlerTable::invokeMethod<T, C, Method> };
+		}
+
+		// free function handler: table.bind<WindowCloseEvent, &onWindowClose>()
+		template<typename T, bool (*Function)(T&)>
+		void bind()
+		{
+			this->handlers[(size_t)T::getStaticType()] = { nullptr, &EventHandlerTable::invokeFunction<T, Function> };
+		}
+
+		template<typename T>
+		void unbind()
+		{
+			this->handlers[(size_t)T::getStaticType()] = {};
+		}
+
+		// returns false if there is no handler for the event's type
+		inline bool dispatch(Event &e) const
+		{
+			const Delegate &handler = this->handlers[(size_t)e.getEventType()];
+
+			if (!handler.function)
+				return false;
+
+			e.handled = handler.function(handler.instance, e);
+			return true;
+		}
+
+	private:
+		template<typename T, typename C, bool (C::*Method)(T&)>
+		static bool invokeMethod(void *instance, Event &e)
+		{
+			return (static_cast<C*>(instance)->*Method)(static_cast<T&>(e));
+		}
+
+		template<typename T, bool (*Function)(T&)>
+		static bool invokeFunction(void *instance, Event &e)
+		{
+			return Function(static_cast<T&>(e));
+		}
+
+	private:
+		struct Delegate
+		{
+			void *instance = nullptr;
+			bool (*function)(void *instance, Event &e) = nullptr;
+		};
+
+		std::array<Delegate, (size_t)EventType::Count> handlers = {};
+	};
+
 	inline std::ostream &operator<<(std::ostream &os, const Event &e)
 	{
 		return os << e.toString();
@@ -0,0 +1,129 @@
+#include "vpch.h"
+#include "EventBus.h"
+
+namespace Viper
+{
+
+	EventBus::EventBus(uint32_t capacity)
+		: enqueuePosition(0), dequeuePosition(0), posted(0), dropped(0), highWaterMark(0)
+	{
+		V_CORE_ASSERT(capacity >= 2, "event bus needs at least two cells!");
+
+		size_t size = 1;
+		while (size < capacity)
+			size <<= 1;
+
+		this->cells = new Cell[size];
+		this->mask = size - 1;
+
+		// a cell is free for the producer at position p when its sequence equals p
+		for (size_t i = 0; i < size; i++)
+			this->cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	EventBus::~EventBus()
+	{
+		delete[] this->cells;
+	}
+
+	bool EventBus::post(const QueuedEvent &event)
+	{
+		size_t position = this->enqueuePosition.load(std::memory_order_relaxed);
+		Cell *cell;
+
+		for (;;)
+		{
+			cell = &this->cells[position & this->mask];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+			if (difference == 0)
+			{
+				// the cell is free, claim it
+				if (this->enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if (difference < 0)
+			{
+				// the consumer has not released this cell yet - the ring is full
+				this->dropped.fetch_add(1, std::memory_order_relaxed);
+				return false;
+			}
+			else
+			{
+				// another producer claimed it first
+				position = this->enqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->event = event;
+		cell->sequence.store(position + 1, std::memory_order_release);
+
+		this->posted.fetch_add(1, std::memory_order_relaxed);
+
+		// records waiting right after this post (approximate while other threads are active),
+		// the consumer may already have drained past this record together with later ones
+		intptr_t pending = (intptr_t)(position + 1) - (intptr_t)this->dequeuePosition.load(std::memory_order_relaxed);
+
+		if (pending > 0)
+		{
+			uint32_t highWaterMark = this->highWaterMark.load(std::memory_order_relaxed);
+			while ((uint32_t)pending > highWaterMark && !this->highWaterMark.compare_exchange_weak(highWaterMark, (uint32_t)pending, std::memory_order_relaxed));
+		}
+
+		return true;
+	}
+
+	bool EventBus::postUser(uint32_t id, uint64_t payload)
+	{
+		QueuedEvent event;
+		event.type = EventType::AppUser;
+		event.user = { id, payload };
+
+		return this->post(event);
+	}
+
+	size_t EventBus::drain(const callbackFunc &callback)
+	{
+		// records posted by the handlers themselves wait for the next drain
+		size_t position = this->dequeuePosition.load(std::memory_order_relaxed);
+		size_t end = this->enqueuePosition.load(std::memory_order_acquire);
+		size_t count = 0;
+
+		while (position != end)
+		{
+			Cell &cell = this->cells[position & this->mask];
+
+			// claimed but not published yet - keep the order and pick it up next time
+			if (cell.sequence.load(std::memory_order_acquire) != position + 1)
+				break;
+
+			QueuedEvent event = cell.event;
+
+			// hand the cell back to the producers one lap later
+			cell.sequence.store(position + this->mask + 1, std::memory_order_release);
+			position++;
+			this->dequeuePosition.store(position, std::memory_order_relaxed);
+
+			EventQueue::dispatchEvent(event, callback);
+			count++;
+		}
+
+		this->drained += count;
+		return count;
+	}
+
+	EventBusStats EventBus::getStats() const
+	{
+		EventBusStats stats;
+
+		stats.posted = this->posted.load(std::memory_order_relaxed);
+		stats.dropped = this->dropped.load(std::memory_order_relaxed);
+		stats.drained = this->drained;
+		stats.highWaterMark = this->highWaterMark.load(std::memory_order_relaxed);
+		stats.capacity = (uint32_t)(this->mask + 1);
+
+		return stats;
+	}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "EventQueue.h"
+
+#include <atomic>
+
+namespace Viper
+{
+
+	//*************** EventBusStats struct ***************//
+	struct EventBusStats
+	{
+		uint64_t posted = 0;		// accepted by the bus
+		uint64_t dropped = 0;		// rejected because the ring was full
+		uint64_t drained = 0;		// handed to the application
+		uint32_t highWaterMark = 0;	// most records waiting at once
+		uint32_t capacity = 0;
+	};
+
+
+	//*************** EventBus class ***************//
+	class VIPER_API EventBus
+	{
+		/*
+			Bounded lock-free ring that lets any thread post events to the main thread (multiple producers, single consumer).
+			Every cell carries a sequence number: a producer claims a slot with a CAS on the enqueue position and publishes
+			the record by bumping the cell's sequence, the consumer only reads cells whose sequence says they are published.
+			Memory never grows - a post into a full ring fails and is counted as dropped, so producers can react to backpressure.
+		*/
+
+	public:
+		using callbackFunc = EventQueue::callbackFunc;
+
+		// capacity is rounded up to a power of two
+		EventBus(uint32_t capacity = 1024);
+		~EventBus();
+
+		EventBus(const EventBus &) = delete;
+		EventBus &operator=(const EventBus &) = delete;
+
+		// any thread, returns false if the ring is full
+		bool post(const QueuedEvent &event);
+		bool postUser(uint32_t id, uint64_t payload);
+
+		// main thread only, dispatches at most the records published when the call started
+		size_t drain(const callbackFunc &callback);
+
+		EventBusStats getStats() const;
+
+	private:
+		struct Cell
+		{
+			std::atomic<size_t> sequence;
+			QueuedEvent event;
+		};
+
+		Cell *cells;
+		size_t mask;
+
+		// producers and the consumer write different cache lines
+		alignas(64) std::atomic<size_t> enqueuePosition;
+		alignas(64) std::atomic<size_t> dequeuePosition;
+
+		alignas(64) std::atomic<uint64_t> posted;
+		std::atomic<uint64_t> dropped;
+		std::atomic<uint32_t> highWaterMark;
+		uint64_t drained = 0;
+	};
+
+}
@@ -0,0 +1,181 @@
+#include "vpch.h"
+#include "EventQueue.h"
+
+#include "Viper/Events/ApplicationEvent.h"
+#include "Viper/Events/KeyEvent.h"
+#include "Viper/Events/MouseEvent.h"
+
+namespace Viper
+{
+
+	#define EVENT_QUEUE_RESERVE 256
+
+	EventQueue::EventQueue()
+	{
+		this->events.reserve(EVENT_QUEUE_RESERVE);
+	}
+
+	void EventQueue::pushWindowResize(uint16_t width, uint16_t height)
+	{
+		QueuedEvent *event = this->coalesce(EventType::WindowResize);
+
+		if (!event)
+			event = &this->push(EventType::WindowResize);
+
+		event->size = { width, height };
+	}
+
+	void EventQueue::pushWindowClose()
+	{
+		this->push(EventType::WindowClose);
+	}
+
+	void EventQueue::pushKeyPressed(uint16_t keyCode, uint16_t repeatCount)
+	{
+		this->push(EventType::KeyPressed).key = { keyCode, repeatCount };
+	}
+
+	void EventQueue::pushKeyReleased(uint16_t keyCode)
+	{
+		this->push(EventType::KeyReleased).key = { keyCode, 0 };
+	}
+
+	void EventQueue::pushMouseButtonPressed(uint16_t button)
+	{
+		this->push(EventType::MouseButtonPressed).button = { button };
+	}
+
+	void EventQueue::pushMouseButtonReleased(uint16_t button)
+	{
+		this->push(EventType::MouseButtonReleased).button = { button };
+	}
+
+	void EventQueue::pushMouseMoved(float_t x, float_t y)
+	{
+		QueuedEvent *event = this->coalesce(EventType::MouseMoved);
+
+		if (!event)
+			event = &this->push(EventType::MouseMoved);
+
+		event->position = { x, y };
+	}
+
+	void EventQueue::pushMouseScrolled(float_t xOffset, float_t yOffset)
+	{
+		QueuedEvent *event = this->coalesce(EventType::MouseScrolled);
+
+		if (event)
+		{
+			event->position.x += xOffset;
+			event->position.y += yOffset;
+		}
+		else
+		{
+			this->push(EventType::MouseScrolled).position = { xOffset, yOffset };
+		}
+	}
+
+	void EventQueue::dispatch(const callbackFunc &callback)
+	{
+		// the callback may push new events (e.g. a layer closing the window), those are dispatched next frame
+		size_t count = this->events.size();
+		this->dispatchEnd = count;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			// copied, the callback may push and reallocate the storage
+			const QueuedEvent event = this->events[i];
+			EventQueue::dispatchEvent(event, callback);
+		}
+
+		this->events.erase(this->events.begin(), this->events.begin() + count);
+		this->dispatchEnd = 0;
+	}
+
+	void EventQueue::dispatchEvent(const QueuedEvent &event, const callbackFunc &callback)
+	{
+		switch (event.type)
+		{
+			case EventType::WindowResize:
+			{
+				WindowResizeEvent e(event.size.width, event.size.height);
+				callback(e);
+				break;
+			}
+			case EventType::WindowClose:
+			{
+				WindowCloseEvent e;
+				callback(e);
+				break;
+			}
+			case EventType::KeyPressed:
+			{
+				KeyPressedEvent e(event.key.keyCode, event.key.repeatCount);
+				callback(e);
+				break;
+			}
+			case EventType::KeyReleased:
+			{
+				KeyReleasedEvent e(event.key.keyCode);
+				callback(e);
+				break;
+			}
+			case EventType::MouseButtonPressed:
+			{
+				MouseButtonPressedEvent e(event.button.button);
+				callback(e);
+				break;
+			}
+			case EventType::MouseButtonReleased:
+			{
+				MouseButtonReleasedEvent e(event.button.button);
+				callback(e);
+				break;
+			}
+			case EventType::MouseMoved:
+			{
+				MouseMovedEvent e(event.position.x, event.position.y);
+				callback(e);
+				break;
+			}
+			case EventType::MouseScrolled:
+			{
+				MouseScrolledEvent e(event.position.x, event.position.y);
+				callback(e);
+				break;
+			}
+			case EventType::AppUser:
+			{
+				UserEvent e(event.user.id, event.user.payload);
+				callback(e);
+				break;
+			}
+			default:
+				V_CORE_ASSERT(false, "event type can't be queued!");
+		}
+	}
+
+	QueuedEvent *EventQueue::coalesce(EventType type)
+	{
+		// never merge into a record that is being dispatched
+		if (this->events.size() <= this->dispatchEnd || this->events.back().type != type)
+			return nullptr;
+
+		this->pushedCount++;
+		this->coalescedCount++;
+
+		return &this->events.back();
+	}
+
+	QueuedEvent &EventQueue::push(EventType type)
+	{
+		this->pushedCount++;
+
+		QueuedEvent event;
+		event.type = type;
+
+		this->events.push_back(event);
+		return this->events.back();
+	}
+
+}
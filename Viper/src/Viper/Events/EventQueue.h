@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Event.h"
+
+namespace Viper
+{
+
+	//*************** QueuedEvent struct ***************//
+	struct QueuedEvent
+	{
+		/*
+			Plain data record of an event, the Event object is only built when the queue is dispatched.
+		*/
+
+		struct Size { uint16_t width, height; };
+		struct Key { uint16_t keyCode, repeatCount; };
+		struct Button { uint16_t button; };
+		struct Position { float_t x, y; };
+		struct User { uint32_t id; uint64_t payload; };
+
+		EventType type;
+
+		union
+		{
+			Size size;			// WindowResize
+			Key key;			// KeyPressed, KeyReleased
+			Button button;		// MouseButtonPressed, MouseButtonReleased
+			Position position;	// MouseMoved (position), MouseScrolled (offset)
+			User user;			// AppUser
+		};
+	};
+
+
+	//*************** EventQueue class ***************//
+	class VIPER_API EventQueue
+	{
+		/*
+			Events recorded by the window callbacks during polling and dispatched once per frame in a batch.
+			A record that directly follows a record of the same kind is merged into it where only the final state matters:
+				- mouse moves keep the last position
+				- resizes keep the last size
+				- scrolls add up their offsets
+			Anything in between (a click, a key) breaks the run, so the relative order of different events is preserved.
+		*/
+
+	public:
+		using callbackFunc = std::function<void(Event&)>;
+
+		EventQueue();
+
+		void pushWindowResize(uint16_t width, uint16_t height);
+		void pushWindowClose();
+		void pushKeyPressed(uint16_t keyCode, uint16_t repeatCount);
+		void pushKeyReleased(uint16_t keyCode);
+		void pushMouseButtonPressed(uint16_t button);
+		void pushMouseButtonReleased(uint16_t button);
+		void pushMouseMoved(float_t x, float_t y);
+		void pushMouseScrolled(float_t xOffset, float_t yOffset);
+
+		// hand every queued event to the callback in order and empty the queue
+		void dispatch(const callbackFunc &callback);
+
+		// build the Event described by a record and hand it to the callback
+		static void dispatchEvent(const QueuedEvent &event, const callbackFunc &callback);
+
+		inline size_t size() const { return this->events.size(); }
+		inline bool empty() const { return this->events.empty(); }
+
+		// records pushed / merged into the previous record since the start
+		inline uint64_t getPushedCount() const { return this->pushedCount; }
+		inline uint64_t getCoalescedCount() const { return this->coalescedCount; }
+
+	private:
+		QueuedEvent *coalesce(EventType type);
+		QueuedEvent &push(EventType type);
+
+	private:
+		// the storage is kept between frames, so steady state polling does not allocate
+		std::vector<QueuedEvent> events;
+		size_t dispatchEnd = 0;
+
+		uint64_t pushedCount = 0;
+		uint64_t coalescedCount = 0;
+	};
+
+}
@@ -13,7 +13,7 @@ namespace Viper
 		EVENT_CLASS_CATEGORY(EventCategoryInput | EventCategoryKeyboard);
 
 	protected:
-		KeyEvent(uint16_t keyCode) : keyCode(keyCode) { }
+		KeyEvent(EventType type, uint16_t keyCode) : Event(type, getStaticCategoryFlags()), keyCode(keyCode) { }
 
 	protected:
 		uint16_t keyCode;
@@ -24,7 +24,7 @@ namespace Viper
 	class VIPER_API KeyPressedEvent : public KeyEvent
 	{
 	public:
-		KeyPressedEvent(uint16_t keyCode, uint16_t repeatCount) : KeyEvent(keyCode), repeatCount(repeatCount) { }
+		KeyPressedEvent(uint16_t keyCode, uint16_t repeatCount) : KeyEvent(getStaticType(), keyCode), repeatCount(repeatCount) { }
 
 		inline uint16_t getRepeatCount() const { return this->repeatCount; }
 
@@ -46,7 +46,7 @@ namespace Viper
 	class VIPER_API KeyReleasedEvent : public KeyEvent
 	{
 	public:
-		KeyReleasedEvent(uint16_t keyCode) : KeyEvent(keyCode) { }
+		KeyReleasedEvent(uint16_t keyCode) : KeyEvent(getStaticType(), keyCode) { }
 
 		std::string toString() const override
 		{
@@ -9,7 +9,7 @@ namespace Viper
 	class VIPER_API MouseMovedEvent : public Event
 	{
 	public:
-		MouseMovedEvent(float_t x, float_t y) : xpos(x), ypos(y) { }
+		MouseMovedEvent(float_t x, float_t y) : Event(getStaticType(), getStaticCategoryFlags()), xpos(x), ypos(y) { }
 
 		inline float_t getX() const { return this->xpos; }
 		inline float_t getY() const { return this->ypos; }
@@ -33,7 +33,7 @@ namespace Viper
 	class VIPER_API MouseScrolledEvent : public Event
 	{
 	public:
-		MouseScrolledEvent(float_t xOffset, float_t yOffset) : xoffset(xOffset), yoffset(yOffset) { }
+		MouseScrolledEvent(float_t xOffset, float_t yOffset) : Event(getStaticType(), getStaticCategoryFlags()), xoffset(xOffset), yoffset(yOffset) { }
 
 		inline float_t getXOffset() const { return this->xoffset; }
 		inline float_t getYOffset() const { return this->yoffset; }
@@ -62,7 +62,7 @@ namespace Viper
 		EVENT_CLASS_CATEGORY(EventCategoryInput | EventCategoryMouse);
 
 	protected:
-		MouseButtonEvent(uint16_t button) : button(button) { }
+		MouseButtonEvent(EventType type, uint16_t button) : Event(type, getStaticCategoryFlags()), button(button) { }
 
 	protected:
 		uint16_t button;
@@ -73,7 +73,7 @@ namespace Viper
 	class VIPER_API MouseButtonPressedEvent : public MouseButtonEvent
 	{
 	public:
-		MouseButtonPressedEvent(uint16_t button) : MouseButtonEvent(button) { }
+		MouseButtonPressedEvent(uint16_t button) : MouseButtonEvent(getStaticType(), button) { }
 		
 		std::string toString() const override
 		{
@@ -90,7 +90,7 @@ namespace Viper
 	class VIPER_API MouseButtonReleasedEvent : public MouseButtonEvent
 	{
 	public:
-		MouseButtonReleasedEvent(uint16_t button) : MouseButtonEvent(button) { }
+		MouseButtonReleasedEvent(uint16_t button) : MouseButtonEvent(getStaticType(), button) { }
 
 		std::string toString() const override
 		{
@@ -0,0 +1,133 @@
+#include "vpch.h"
+#include "Input.h"
+
+namespace Viper
+{
+
+	InputSnapshot Input::pending;
+	InputSnapshot Input::snapshots[2];
+	std::atomic<uint32_t> Input::front(0);
+	MouseMotion Input::motionBuffers[3][InputSnapshot::MaxMotionSamples];
+
+	void Input::recordKey(int keyCode, bool down)
+	{
+		// GLFW_KEY_UNKNOWN (-1) and anything past the table
+		if ((uint32_t)keyCode >= InputSnapshot::KeyCount)
+			return;
+
+		if (down && !pending.keys[keyCode])
+			pending.keysPressed[keyCode] = true;
+		else if (!down && pending.keys[keyCode])
+			pending.keysReleased[keyCode] = true;
+
+		pending.keys[keyCode] = down;
+	}
+
+	void Input::recordMouseButton(int button, bool down)
+	{
+		if ((uint32_t)button >= InputSnapshot::MouseButtonCount)
+			return;
+
+		uint8_t bit = (uint8_t)(1 << button);
+
+		if (down)
+		{
+			pending.buttonsPressed |= (pending.buttons & bit) ? 0 : bit;
+			pending.buttons |= bit;
+		}
+		else
+		{
+			pending.buttonsReleased |= (pending.buttons & bit) ? bit : 0;
+			pending.buttons &= ~bit;
+		}
+	}
+
+	void Input::recordCursor(float x, float y)
+	{
+		pending.mouseX = x;
+		pending.mouseY = y;
+	}
+
+	void Input::recordCursorMove(float x, float y, double time)
+	{
+		float dx = x - pending.mouseX;
+		float dy = y - pending.mouseY;
+
+		pending.mouseX = x;
+		pending.mouseY = y;
+		pending.motionX += dx;
+		pending.motionY += dy;
+
+		MouseMotion *samples = motionBuffers[2];
+
+		if (pending.motionCount < InputSnapshot::MaxMotionSamples)
+		{
+			samples[pending.motionCount++] = { dx, dy, time };
+		}
+		else
+		{
+			// the sums stay exact, only the resolution of the tail is lost
+			MouseMotion &last = samples[InputSnapshot::MaxMotionSamples - 1];
+			last.dx += dx;
+			last.dy += dy;
+			last.time = time;
+		}
+	}
+
+	void Input::recordScroll(float xOffset, float yOffset)
+	{
+		pending.scrollX += xOffset;
+		pending.scrollY += yOffset;
+	}
+
+	InputLevels Input::getLevels()
+	{
+		InputLevels levels = {};
+
+		for (uint32_t key = 0; key < InputSnapshot::KeyCount; key++)
+		{
+			if (pending.keys[key])
+				levels.keys[key / 64] |= 1ull << (key % 64);
+		}
+
+		levels.buttons = pending.buttons;
+		levels.mouseX = pending.mouseX;
+		levels.mouseY = pending.mouseY;
+
+		return levels;
+	}
+
+	void Input::setLevels(const InputLevels &levels)
+	{
+		for (uint32_t key = 0; key < InputSnapshot::KeyCount; key++)
+			pending.keys[key] = (levels.keys[key / 64] >> (key % 64)) & 1;
+
+		pending.buttons = levels.buttons;
+		pending.mouseX = levels.mouseX;
+		pending.mouseY = levels.mouseY;
+	}
+
+	void Input::publish()
+	{
+		uint32_t back = front.load(std::memory_order_relaxed) ^ 1;
+
+		snapshots[back] = pending;
+		snapshots[back].motion = motionBuffers[back];
+		memcpy(motionBuffers[back], motionBuffers[2], pending.motionCount * sizeof(MouseMotion));
+
+		front.store(back, std::memory_order_release);
+
+		// the levels carry over, the edges, the scroll and the motion start again
+		pending.keysPressed.reset();
+		pending.keysReleased.reset();
+		pending.buttonsPressed = 0;
+		pending.buttonsReleased = 0;
+		pending.scrollX = 0.0f;
+		pending.scrollY = 0.0f;
+		pending.motionX = 0.0f;
+		pending.motionY = 0.0f;
+		pending.motionCount = 0;
+		pending.frame++;
+	}
+
+}
@@ -2,28 +2,138 @@
 
 #include "Viper/Core.h"
 
+#include <atomic>
+#include <bitset>
+
 namespace Viper
 {
 
+	//*************** MouseMotion struct ***************//
+	struct MouseMotion
+	{
+		// cursor delta of one platform sample (unaccelerated with raw mouse motion), glfw time in seconds
+		float dx, dy;
+		double time;
+	};
+
+
+	//*************** InputSnapshot struct ***************//
+	struct InputSnapshot
+	{
+		/*
+			State of the keyboard and mouse at the end of one poll.
+			The pressed / released edges cover everything since the previous snapshot, a key that went down and up
+			within one frame shows both edges without being down.
+		*/
+
+		// glfw key codes go up to V_KEY_MENU (348)
+		static constexpr uint32_t KeyCount = 512;
+		static constexpr uint32_t MouseButtonCount = 8;
+
+		// a 1000 Hz mouse fills ~100 per frame at 10 fps, further samples are merged into the last one
+		static constexpr uint32_t MaxMotionSamples = 1024;
+
+		std::bitset<KeyCount> keys;
+		std::bitset<KeyCount> keysPressed;
+		std::bitset<KeyCount> keysReleased;
+
+		uint8_t buttons = 0;
+		uint8_t buttonsPressed = 0;
+		uint8_t buttonsReleased = 0;
+
+		float mouseX = 0.0f;
+		float mouseY = 0.0f;
+
+		// summed offsets since the previous snapshot
+		float scrollX = 0.0f;
+		float scrollY = 0.0f;
+
+		// cursor motion since the previous snapshot: the summed delta and every sample in arrival order
+		float motionX = 0.0f;
+		float motionY = 0.0f;
+		const MouseMotion *motion = nullptr;
+		uint32_t motionCount = 0;
+
+		uint64_t frame = 0;
+
+		inline bool isKeyDown(int keyCode) const { return (uint32_t)keyCode < KeyCount && this->keys[keyCode]; }
+		inline bool wasKeyPressed(int keyCode) const { return (uint32_t)keyCode < KeyCount && this->keysPressed[keyCode]; }
+		inline bool wasKeyReleased(int keyCode) const { return (uint32_t)keyCode < KeyCount && this->keysReleased[keyCode]; }
+
+		inline bool isButtonDown(int button) const { return (uint32_t)button < MouseButtonCount && (this->buttons >> button) & 1; }
+		inline bool wasButtonPressed(int button) const { return (uint32_t)button < MouseButtonCount && (this->buttonsPressed >> button) & 1; }
+		inline bool wasButtonReleased(int button) const { return (uint32_t)button < MouseButtonCount && (this->buttonsReleased >> button) & 1; }
+	};
+
+
+	//*************** InputLevels struct ***************//
+	struct InputLevels
+	{
+		/*
+			What is held down and where the cursor is, without any edges or motion - e.g. the state an input recording starts from.
+			Plain data, the keys are a bit per key code.
+		*/
+
+		uint64_t keys[InputSnapshot::KeyCount / 64];
+		uint8_t buttons;
+		float mouseX;
+		float mouseY;
+	};
+
+
+	//*************** Input class ***************//
 	class VIPER_API Input
 	{
+		/*
+			Polled input. The window callbacks record into a pending state while the platform is polled,
+			publish() copies it into a snapshot once per frame - every query is a bit test on that snapshot.
+
+			The snapshot is double buffered and only written at the frame boundary, so it can be read from any thread
+			(e.g. jobs of the current frame) without locking. A reference from getSnapshot() stays valid until the end
+			of the next frame, copy it to keep it for longer.
+		*/
+
 	public:
-		inline static bool isKeyPressed(int keyCode) { return instance->isKeyPressedImpl(keyCode); };
-		inline static bool isMouseButtonPressed(int button) { return instance->isMouseButtonPressedImpl(button); }
-		inline static std::pair<float, float> getMousePosition() { return instance->getMousePositionImpl(); }
-		inline static float getMouseX() { return instance->getMouseXImpl(); }
-		inline static float getMouseY() { return instance->getMouseYImpl(); }
-
-	protected:
-		// methods implementation
-		virtual bool isKeyPressedImpl(int keyCode) = 0;
-		virtual bool isMouseButtonPressedImpl(int button) = 0;
-		virtual std::pair<float, float> getMousePositionImpl() = 0;
-		virtual float getMouseXImpl() = 0;
-		virtual float getMouseYImpl() = 0;
+		inline static bool isKeyPressed(int keyCode) { return Input::getSnapshot().isKeyDown(keyCode); }
+		inline static bool wasKeyPressed(int keyCode) { return Input::getSnapshot().wasKeyPressed(keyCode); }
+		inline static bool wasKeyReleased(int keyCode) { return Input::getSnapshot().wasKeyReleased(keyCode); }
+
+		inline static bool isMouseButtonPressed(int button) { return Input::getSnapshot().isButtonDown(button); }
+		inline static bool wasMouseButtonPressed(int button) { return Input::getSnapshot().wasButtonPressed(button); }
+		inline static bool wasMouseButtonReleased(int button) { return Input::getSnapshot().wasButtonReleased(button); }
+
+		inline static std::pair<float, float> getMousePosition() { const InputSnapshot &snapshot = Input::getSnapshot(); return { snapshot.mouseX, snapshot.mouseY }; }
+		inline static float getMouseX() { return Input::getSnapshot().mouseX; }
+		inline static float getMouseY() { return Input::getSnapshot().mouseY; }
+		inline static std::pair<float, float> getScroll() { const InputSnapshot &snapshot = Input::getSnapshot(); return { snapshot.scrollX, snapshot.scrollY }; }
+		inline static std::pair<float, float> getMouseDelta() { const InputSnapshot &snapshot = Input::getSnapshot(); return { snapshot.motionX, snapshot.motionY }; }
+
+		inline static const InputSnapshot &getSnapshot() { return snapshots[front.load(std::memory_order_acquire)]; }
+
+		// platform side, main thread only
+		static void recordKey(int keyCode, bool down);
+		static void recordMouseButton(int button, bool down);
+
+		// a jump (e.g. the initial position) moves the cursor without a motion sample
+		static void recordCursor(float x, float y);
+		static void recordCursorMove(float x, float y, double time);
+
+		static void recordScroll(float xOffset, float yOffset);
+
+		// levels of the state being recorded, setLevels() replaces them without producing edges or motion
+		static InputLevels getLevels();
+		static void setLevels(const InputLevels &levels);
+
+		// make the recorded state the current snapshot and start collecting the next edges
+		static void publish();
 
 	private:
-		static Input *instance;
+		static InputSnapshot pending;
+		static InputSnapshot snapshots[2];
+		static std::atomic<uint32_t> front;
+
+		// per snapshot, the last one collects the pending samples
+		static MouseMotion motionBuffers[3][InputSnapshot::MaxMotionSamples];
 	};
 
 }
@@ -0,0 +1,307 @@
+#include "vpch.h"
+#include "JobSystem.h"
+#include "WorkStealingQueue.h"
+
+#include "Viper/Memory/MemoryTracker.h"
+#include "Viper/Debug/Profiler.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Viper
+{
+
+	#define IDLE_SPIN_COUNT 64
+
+	// per-thread state, index 0 is the main thread
+	struct JobThread
+	{
+		std::unique_ptr<WorkStealingQueue> queue;
+		std::unique_ptr<Job[]> jobs;
+		uint32_t nextJob = 0;
+	};
+
+	static struct
+	{
+		std::vector<JobThread> threads;
+		std::vector<std::thread> workers;
+		std::atomic<bool> running{ false };
+
+		// jobs submitted by threads without a deque
+		std::mutex externalMutex;
+		std::vector<Job*> externalJobs;
+
+		// sleeping workers are woken when pendingJobs grows
+		std::atomic<uint32_t> pendingJobs{ 0 };
+		std::atomic<uint32_t> sleepingWorkers{ 0 };
+		std::mutex sleepMutex;
+		std::condition_variable wakeUp;
+
+		std::mutex mainThreadMutex;
+		std::vector<std::function<void()>> mainThreadJobs;
+		std::vector<std::function<void()>> mainThreadJobsExecuting;
+	} jobSystem;
+
+	static thread_local int32_t threadIndex = -1;
+	static thread_local uint32_t stealSeed = 0;
+
+	static uint32_t nextRandom()
+	{
+		// xorshift, only used to spread the victims of stealing
+		uint32_t x = stealSeed;
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		stealSeed = x;
+		return x;
+	}
+
+	static Job *findJob()
+	{
+		const size_t threadCount = jobSystem.threads.size();
+
+		if (threadIndex >= 0)
+		{
+			if (Job *job = jobSystem.threads[threadIndex].queue->pop())
+				return job;
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(jobSystem.externalMutex, std::try_to_lock);
+
+			if (lock.owns_lock() && !jobSystem.externalJobs.empty())
+			{
+				Job *job = jobSystem.externalJobs.back();
+				jobSystem.externalJobs.pop_back();
+				return job;
+			}
+		}
+
+		// steal, starting at a random victim
+		size_t first = nextRandom() % threadCount;
+
+		for (size_t i = 0; i < threadCount; i++)
+		{
+			size_t victim = (first + i) % threadCount;
+
+			if ((int32_t)victim == threadIndex)
+				continue;
+
+			if (Job *job = jobSystem.threads[victim].queue->steal())
+				return job;
+		}
+
+		return nullptr;
+	}
+
+	static void execute(Job *job)
+	{
+		jobSystem.pendingJobs.fetch_sub(1, std::memory_order_relaxed);
+
+		JobCounter *counter = job->counter;
+
+		{
+			V_PROFILE_SCOPE("Job");
+			job->function(*job);
+		}
+
+		// a ring slot can be taken again by its owner as soon as it's clear, don't touch the job afterwards
+		if (job->heapAllocated)
+			delete job;
+		else
+			job->busy.store(false, std::memory_order_release);
+
+		if (counter)
+			counter->fetch_sub(1, std::memory_order_release);
+	}
+
+	static void workerLoop(int32_t index)
+	{
+		V_MEMORY_TAG(Jobs);
+		Profiler::setThreadName("Worker " + std::to_string(index));
+
+		threadIndex = index;
+		stealSeed = 0x9E3779B9u * (uint32_t)(index + 1);
+
+		uint32_t idleSpins = 0;
+
+		while (jobSystem.running.load(std::memory_order_acquire))
+		{
+			if (Job *job = findJob())
+			{
+				execute(job);
+				idleSpins = 0;
+				continue;
+			}
+
+			if (++idleSpins < IDLE_SPIN_COUNT)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			// nothing to do for a while - sleep until a job is submitted
+			std::unique_lock<std::mutex> lock(jobSystem.sleepMutex);
+			jobSystem.sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+
+			jobSystem.wakeUp.wait(lock, []()
+			{
+				return jobSystem.pendingJobs.load(std::memory_order_seq_cst) > 0 || !jobSystem.running.load(std::memory_order_acquire);
+			});
+
+			jobSystem.sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+			idleSpins = 0;
+		}
+	}
+
+
+
+	void JobSystem::init(uint32_t workerCount)
+	{
+		V_CORE_ASSERT(!jobSystem.running, "job system is already running!");
+
+		if (workerCount == 0)
+			workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+
+		jobSystem.threads.resize(workerCount + 1);
+
+		for (JobThread &thread : jobSystem.threads)
+		{
+			thread.queue = std::make_unique<WorkStealingQueue>(JobsPerThread);
+			thread.jobs = std::make_unique<Job[]>(JobsPerThread);
+		}
+
+		threadIndex = 0;
+		stealSeed = 0x9E3779B9u;
+		jobSystem.running = true;
+
+		for (uint32_t i = 1; i <= workerCount; i++)
+			jobSystem.workers.emplace_back(workerLoop, (int32_t)i);
+
+		V_CORE_INFO("Job system started with {0} worker threads", workerCount);
+	}
+
+	void JobSystem::shutdown()
+	{
+		if (!jobSystem.running)
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(jobSystem.sleepMutex);
+			jobSystem.running = false;
+		}
+		jobSystem.wakeUp.notify_all();
+
+		for (std::thread &worker : jobSystem.workers)
+			worker.join();
+
+		jobSystem.workers.clear();
+		jobSystem.threads.clear();
+		threadIndex = -1;
+	}
+
+	void JobSystem::wait(const JobCounter &counter)
+	{
+		V_PROFILE_FUNCTION();
+
+		while (counter.load(std::memory_order_acquire) > 0)
+		{
+			if (Job *job = findJob())
+				execute(job);
+			else
+				std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::runOnMainThread(std::function<void()> func)
+	{
+		std::lock_guard<std::mutex> lock(jobSystem.mainThreadMutex);
+		jobSystem.mainThreadJobs.push_back(std::move(func));
+	}
+
+	void JobSystem::executeMainThreadJobs()
+	{
+		V_CORE_ASSERT(threadIndex == 0, "main thread jobs have to be executed on the main thread!");
+
+		{
+			std::lock_guard<std::mutex> lock(jobSystem.mainThreadMutex);
+			std::swap(jobSystem.mainThreadJobs, jobSystem.mainThreadJobsExecuting);
+		}
+
+		// jobs queued by these run next time
+		for (std::function<void()> &func : jobSystem.mainThreadJobsExecuting)
+			func();
+
+		jobSystem.mainThreadJobsExecuting.clear();
+	}
+
+	int32_t JobSystem::getThreadIndex()
+	{
+		return threadIndex;
+	}
+
+	uint32_t JobSystem::getWorkerCount()
+	{
+		return (uint32_t)jobSystem.workers.size();
+	}
+
+	Job *JobSystem::allocateJob()
+	{
+		if (threadIndex < 0)
+		{
+			Job *job = new Job();
+			job->heapAllocated = true;
+			return job;
+		}
+
+		JobThread &thread = jobSystem.threads[threadIndex];
+		Job *job = &thread.jobs[thread.nextJob & (JobsPerThread - 1)];
+
+		// still queued or running - waiting for it could wait on a job further up this thread's own stack
+		if (job->busy.load(std::memory_order_acquire))
+			return nullptr;
+
+		thread.nextJob++;
+		job->heapAllocated = false;
+		job->busy.store(true, std::memory_order_relaxed);
+		return job;
+	}
+
+	void JobSystem::submit(Job *job, JobCounter *counter)
+	{
+		job->counter = counter;
+
+		if (counter)
+			counter->fetch_add(1, std::memory_order_relaxed);
+
+		jobSystem.pendingJobs.fetch_add(1, std::memory_order_seq_cst);
+
+		bool queued = false;
+
+		if (threadIndex >= 0)
+		{
+			queued = jobSystem.threads[threadIndex].queue->push(job);
+		}
+		else
+		{
+			std::lock_guard<std::mutex> lock(jobSystem.externalMutex);
+			jobSystem.externalJobs.push_back(job);
+			queued = true;
+		}
+
+		// the deque is full - run it right away rather than fail
+		if (!queued)
+		{
+			execute(job);
+			return;
+		}
+
+		if (jobSystem.sleepingWorkers.load(std::memory_order_seq_cst) > 0)
+		{
+			std::lock_guard<std::mutex> lock(jobSystem.sleepMutex);
+			jobSystem.wakeUp.notify_one();
+		}
+	}
+
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Viper/Core.h"
+
+#include <atomic>
+
+namespace Viper
+{
+
+	// number of unfinished jobs a waiting thread depends on
+	using JobCounter = std::atomic<uint32_t>;
+
+	//*************** Job struct ***************//
+	struct Job
+	{
+		static constexpr size_t DataSize = 48;
+
+		void (*function)(Job &job) = nullptr;
+		JobCounter *counter = nullptr;
+		bool heapAllocated = false;
+
+		// set from allocation until the job has run, a ring slot is only reused once it's clear
+		std::atomic<bool> busy{ false };
+
+		// the callable is constructed in place, no allocation per job
+		alignas(16) uint8_t data[DataSize];
+	};
+
+
+	//*************** JobSystem class ***************//
+	class VIPER_API JobSystem
+	{
+		/*
+			Worker threads (one per remaining core) each own a work-stealing deque; the main thread owns one as well
+			and executes jobs while it waits. A thread runs its own jobs newest first and steals the oldest jobs of
+			the others when it runs dry.
+
+			Dependencies are expressed with counters: every job started with a counter increments it and decrements
+			it when done, wait() keeps executing other jobs until the counter drops to zero.
+
+			Jobs of one thread come from a ring of JobsPerThread slots. When the next slot still holds a job that is
+			queued or running, the new job is executed right away on the submitting thread instead.
+			Threads unknown to the system (not the main thread or a worker) submit through a locked queue.
+		*/
+
+	public:
+		static constexpr uint32_t JobsPerThread = 4096;
+
+		// parallelFor merges batches beyond this, leaving the rest of the ring to other jobs of the thread
+		static constexpr uint32_t MaxParallelForJobs = JobsPerThread / 2;
+
+		// workerCount = 0 starts one worker per core besides the calling (main) thread
+		static void init(uint32_t workerCount = 0);
+		static void shutdown();
+
+		// the callable is run on any worker, it has to fit in Job::DataSize bytes
+		template<typename F>
+		static void run(F &&func, JobCounter *counter = nullptr)
+		{
+			using Func = typename std::decay<F>::type;
+			static_assert(sizeof(Func) <= Job::DataSize, "job callable is too large, capture by reference or pointer");
+			static_assert(alignof(Func) <= 16, "job callable is over-aligned");
+
+			Job *job = JobSystem::allocateJob();
+
+			// the ring of the thread is full of unfinished jobs
+			if (!job)
+			{
+				Func inlineFunc(std::forward<F>(func));
+				inlineFunc();
+				return;
+			}
+
+			new (job->data) Func(std::forward<F>(func));
+
+			job->function = [](Job &job)
+			{
+				Func *func = reinterpret_cast<Func*>(job.data);
+				(*func)();
+				func->~Func();
+			};
+
+			JobSystem::submit(job, counter);
+		}
+
+		// help executing jobs until the counter reaches zero
+		static void wait(const JobCounter &counter);
+
+		// func(i) for i in [0, count), split into jobs of batchSize iterations (larger ones past MaxParallelForJobs), returns when all are done
+		template<typename F>
+		static void parallelFor(uint32_t count, uint32_t batchSize, const F &func)
+		{
+			if (count == 0)
+				return;
+
+			batchSize = std::max(batchSize, 1u);
+			batchSize = std::max(batchSize, (uint32_t)(((uint64_t)count + MaxParallelForJobs - 1) / MaxParallelForJobs));
+
+			V_CORE_ASSERT(((uint64_t)count + batchSize - 1) / batchSize <= MaxParallelForJobs, "parallelFor submits more jobs than the ring holds!");
+
+			JobCounter counter(0);
+			const F *body = &func;
+
+			for (uint32_t start = 0; start < count; start += batchSize)
+			{
+				uint32_t end = std::min(start + batchSize, count);
+
+				JobSystem::run([body, start, end]()
+				{
+					for (uint32_t i = start; i < end; i++)
+						(*body)(i);
+				}, &counter);
+			}
+
+			JobSystem::wait(counter);
+		}
+
+		// queued for the main thread, executed in executeMainThreadJobs() (e.g. glfw or window calls)
+		static void runOnMainThread(std::function<void()> func);
+		static void executeMainThreadJobs();
+
+		// 0 = main thread, 1..workerCount = workers, -1 = a thread unknown to the system
+		static int32_t getThreadIndex();
+		static uint32_t getWorkerCount();
+
+	private:
+		// nullptr when the next slot of the thread's ring is still in use
+		static Job *allocateJob();
+		static void submit(Job *job, JobCounter *counter);
+	};
+
+}
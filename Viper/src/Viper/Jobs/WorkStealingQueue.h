@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+
+namespace Viper
+{
+
+	struct Job;
+
+	//*************** WorkStealingQueue class ***************//
+	class WorkStealingQueue
+	{
+		/*
+			Fixed size Chase-Lev deque of jobs.
+			The owning thread pushes and pops at the bottom (LIFO - recently pushed jobs are still in cache),
+			other threads steal from the top (FIFO - the oldest, usually largest, pieces of work).
+			Only the last remaining element is contended, that case is settled with a CAS on top.
+		*/
+
+	public:
+		// capacity has to be a power of two
+		WorkStealingQueue(int64_t capacity)
+			: mask(capacity - 1), buffer(new std::atomic<Job*>[capacity])
+		{
+		}
+
+		~WorkStealingQueue()
+		{
+			delete[] this->buffer;
+		}
+
+		WorkStealingQueue(const WorkStealingQueue &) = delete;
+		WorkStealingQueue &operator=(const WorkStealingQueue &) = delete;
+
+		// owner thread only, false if the deque is full
+		bool push(Job *job)
+		{
+			int64_t b = this->bottom.load(std::memory_order_relaxed);
+			int64_t t = this->top.load(std::memory_order_acquire);
+
+			if (b - t > this->mask)
+				return false;
+
+			this->buffer[b & this->mask].store(job, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			this->bottom.store(b + 1, std::memory_order_relaxed);
+
+			return true;
+		}
+
+		// owner thread only
+		Job *pop()
+		{
+			int64_t b = this->bottom.load(std::memory_order_relaxed) - 1;
+			this->bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t t = this->top.load(std::memory_order_relaxed);
+
+			if (t > b)
+			{
+				// empty
+				this->bottom.store(b + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			Job *job = this->buffer[b & this->mask].load(std::memory_order_relaxed);
+
+			if (t == b)
+			{
+				// last element - race the thieves for it
+				if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					job = nullptr;
+
+				this->bottom.store(b + 1, std::memory_order_relaxed);
+			}
+
+			return job;
+		}
+
+		// any thread
+		Job *steal()
+		{
+			int64_t t = this->top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64_t b = this->bottom.load(std::memory_order_acquire);
+
+			if (t >= b)
+				return nullptr;
+
+			Job *job = this->buffer[t & this->mask].load(std::memory_order_relaxed);
+
+			// lost against the owner or another thief
+			if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return nullptr;
+
+			return job;
+		}
+
+		inline bool empty() const
+		{
+			return this->bottom.load(std::memory_order_relaxed) <= this->top.load(std::memory_order_relaxed);
+		}
+
+	private:
+		const int64_t mask;
+		std::atomic<Job*> *buffer;
+
+		alignas(64) std::atomic<int64_t> top{ 0 };
+		alignas(64) std::atomic<int64_t> bottom{ 0 };
+	};
+
+}
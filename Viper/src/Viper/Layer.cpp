@@ -13,4 +13,20 @@ namespace Viper
 	{
 	}
 
+	bool Layer::conflictsWith(const Layer &other) const
+	{
+		// undeclared layers may touch anything
+		if (!this->parallel || !other.parallel)
+			return true;
+
+		return (this->writeSet & (other.readSet | other.writeSet)) != 0 || (other.writeSet & this->readSet) != 0;
+	}
+
+	void Layer::declareAccess(uint64_t reads, uint64_t writes)
+	{
+		this->parallel = true;
+		this->readSet = reads;
+		this->writeSet = writes;
+	}
+
 }
\ No newline at end of file
@@ -19,9 +19,29 @@ namespace Viper
 
 		inline const std::string &getName() { return this->debugName; }
 
+		// a layer that declared its access may update concurrently with layers it does not conflict with
+		inline bool isParallel() const { return this->parallel; }
+		inline uint64_t getReadSet() const { return this->readSet; }
+		inline uint64_t getWriteSet() const { return this->writeSet; }
+
+		bool conflictsWith(const Layer &other) const;
+
+	protected:
+		/*
+			Bit masks of the (application defined) resources onUpdate() reads and writes.
+			Declare them in the constructor, before the layer is pushed - the update schedule is built when the stack changes.
+			Layers that do not declare anything keep updating alone, in stack order.
+		*/
+		void declareAccess(uint64_t reads, uint64_t writes);
+
 	protected:
 		std::string debugName;
 
+	private:
+		bool parallel = false;
+		uint64_t readSet = 0;
+		uint64_t writeSet = 0;
+
 	};
 
 }
\ No newline at end of file
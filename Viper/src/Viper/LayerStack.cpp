@@ -1,51 +1,178 @@
 #include "vpch.h"
 #include "LayerStack.h"
 
+#include "Viper/Jobs/JobSystem.h"
+#include "Viper/Memory/MemoryTracker.h"
+#include "Viper/Memory/FrameAllocator.h"
+#include "Viper/Debug/Profiler.h"
+
 namespace Viper
 {
 
 	LayerStack::LayerStack()
 	{
-		this->layerInsert = this->layers.begin();
 	}
 
 
 	LayerStack::~LayerStack()
 	{
 		for (Layer *layer : this->layers)
-			delete layer;
+		{
+			layer->onDetach();
+
+			if (!this->isSlabLayer(layer))
+				delete layer;
+		}
+
+		for (SlabLayer &slabLayer : this->slabLayers)
+		{
+			slabLayer.layer->~Layer();
+			this->layerAllocator.free(slabLayer.memory, slabLayer.size);
+		}
 	}
 
 
 	void LayerStack::pushLayer(Layer *layer)
 	{
-		this->layerInsert = this->layers.emplace(this->layerInsert, layer);
+		this->layers.emplace(this->layers.begin() + this->layerInsertIndex, layer);
+		this->layerInsertIndex++;
+		this->scheduleDirty = true;
+
+		layer->onAttach();
 	}
 
 	void LayerStack::pushOverlay(Layer *overlay)
 	{
 		this->layers.emplace_back(overlay);
+
+		overlay->onAttach();
 	}
 
 
 	void LayerStack::popLayer(Layer *layer)
 	{
-		auto it = std::find(this->layers.begin(), this->layers.end(), layer);
+		auto it = std::find(this->layers.begin(), this->layers.begin() + this->layerInsertIndex, layer);
 
-		if (it != this->layers.end())
+		if (it != this->layers.begin() + this->layerInsertIndex)
 		{
 			this->layers.erase(it);
-			this->layerInsert--;
+			this->layerInsertIndex--;
+			this->scheduleDirty = true;
+
+			layer->onDetach();
 		}
 	}
 
 
 	void LayerStack::popOverlay(Layer *overlay)
 	{
-		auto it = std::find(this->layers.begin(), this->layers.end(), overlay);
+		auto it = std::find(this->layers.begin() + this->layerInsertIndex, this->layers.end(), overlay);
 
 		if (it != this->layers.end())
+		{
 			this->layers.erase(it);
+			overlay->onDetach();
+		}
+	}
+
+
+	bool LayerStack::isSlabLayer(const Layer *layer) const
+	{
+		for (const SlabLayer &slabLayer : this->slabLayers)
+		{
+			if (slabLayer.layer == layer)
+				return true;
+		}
+
+		return false;
+	}
+
+
+	void LayerStack::update()
+	{
+		V_PROFILE_FUNCTION();
+		V_MEMORY_TAG(Layers);
+
+		if (this->scheduleDirty)
+			this->buildSchedule();
+
+		uint32_t batchStart = 0;
+
+		for (uint32_t batchEnd : this->batchEnds)
+		{
+			// the main thread takes the last layer of the batch itself and helps with the rest while waiting
+			JobCounter counter(0);
+
+			for (uint32_t i = batchStart; i + 1 < batchEnd; i++)
+			{
+				Layer *layer = this->schedule[i];
+				JobSystem::run([layer]()
+				{
+					V_PROFILE_SCOPE(layer->getName().c_str());
+					V_MEMORY_TAG(Layers);
+					layer->onUpdate();
+				}, &counter);
+			}
+
+			{
+				Layer *layer = this->schedule[batchEnd - 1];
+				V_PROFILE_SCOPE(layer->getName().c_str());
+				layer->onUpdate();
+			}
+
+			JobSystem::wait(counter);
+
+			batchStart = batchEnd;
+		}
+
+		// overlays (UI, debug) see the results of all layers and keep their order
+		for (uint32_t i = this->layerInsertIndex; i < this->layers.size(); i++)
+		{
+			V_PROFILE_SCOPE(this->layers[i]->getName().c_str());
+			this->layers[i]->onUpdate();
+		}
+	}
+
+
+	void LayerStack::buildSchedule()
+	{
+		/*
+			Every layer gets the lowest batch that comes after all earlier layers it conflicts with,
+			so conflicting layers keep their stack order and an undeclared layer is a barrier for everything around it.
+		*/
+
+		const uint32_t count = this->layerInsertIndex;
+
+		ScopedArena arena(FrameAllocator::getScratch());
+		std::vector<uint32_t, ArenaAllocator<uint32_t>> batchOf(count, 0, ArenaAllocator<uint32_t>(arena.getAllocator()));
+		uint32_t batchCount = 0;
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			for (uint32_t j = 0; j < i; j++)
+			{
+				if (this->layers[i]->conflictsWith(*this->layers[j]))
+					batchOf[i] = std::max(batchOf[i], batchOf[j] + 1);
+			}
+
+			batchCount = std::max(batchCount, batchOf[i] + 1);
+		}
+
+		this->schedule.clear();
+		this->batchEnds.clear();
+
+		for (uint32_t batch = 0; batch < batchCount; batch++)
+		{
+			for (uint32_t i = 0; i < count; i++)
+			{
+				if (batchOf[i] == batch)
+					this->schedule.push_back(this->layers[i]);
+			}
+
+			this->batchEnds.push_back((uint32_t)this->schedule.size());
+		}
+
+		this->scheduleDirty = false;
 	}
 
-}
\ No newline at end of file
+}
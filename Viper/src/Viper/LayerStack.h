@@ -2,6 +2,7 @@
 
 #include "Viper/Core.h"
 #include "Viper/Layer.h"
+#include "Viper/Memory/SlabAllocator.h"
 
 #include <vector>
 
@@ -14,17 +15,74 @@ namespace Viper
 		LayerStack();
 		~LayerStack();
 
+		// the stack takes ownership of the pushed layers and deletes them when it's destroyed,
+		// onAttach() runs when a layer is pushed and onDetach() when it is popped or the stack goes away
 		void pushLayer(Layer *layer);
 		void pushOverlay(Layer *overlay);
+
+		/*
+			Construct the layer in the stack's slab allocator and push it. Such a layer is owned by the stack
+			even after it has been popped, it is destroyed together with the stack.
+		*/
+		template<typename T, typename... Args>
+		T *emplaceLayer(Args&&... args)
+		{
+			T *layer = this->createLayer<T>(std::forward<Args>(args)...);
+			this->pushLayer(layer);
+			return layer;
+		}
+
+		template<typename T, typename... Args>
+		T *emplaceOverlay(Args&&... args)
+		{
+			T *overlay = this->createLayer<T>(std::forward<Args>(args)...);
+			this->pushOverlay(overlay);
+			return overlay;
+		}
+
 		void popLayer(Layer *layer);
 		void popOverlay(Layer *overlay);
 
+		// onUpdate() of every layer - independent layers concurrently on the job system, then the overlays in order
+		void update();
+
 		std::vector<Layer *>::iterator begin() { return this->layers.begin(); }
 		std::vector<Layer *>::iterator end() { return this->layers.end(); }
 
+	private:
+		template<typename T, typename... Args>
+		T *createLayer(Args&&... args)
+		{
+			static_assert(std::is_base_of<Layer, T>::value, "layers have to derive from Layer");
+
+			T *layer = this->layerAllocator.create<T>(std::forward<Args>(args)...);
+			this->slabLayers.push_back({ layer, layer, sizeof(T) });
+			return layer;
+		}
+
+		bool isSlabLayer(const Layer *layer) const;
+
+		void buildSchedule();
+
 	private:
 		std::vector<Layer *> layers;
-		std::vector<Layer *>::iterator layerInsert;
+		uint32_t layerInsertIndex = 0;
+
+		// layers grouped into batches, layers inside a batch do not conflict, batches run one after another
+		std::vector<Layer *> schedule;
+		std::vector<uint32_t> batchEnds;
+		bool scheduleDirty = true;
+
+		// layers constructed by emplaceLayer / emplaceOverlay, the allocator needs their block and size back to free them
+		struct SlabLayer
+		{
+			Layer *layer;
+			void *memory;
+			size_t size;
+		};
+
+		SlabAllocator layerAllocator;
+		std::vector<SlabLayer> slabLayers;
 	};
 
-}
\ No newline at end of file
+}
@@ -1,23 +1,62 @@
 #include "vpch.h"
 #include "Log.h"
 
+#include "spdlog/async.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
 
 namespace Viper
 {
 
+	#define LOG_QUEUE_SIZE 8192
+	#define LOG_THREAD_COUNT 1
+
 	std::shared_ptr<spdlog::logger> Log::coreLogger;
 	std::shared_ptr<spdlog::logger> Log::clientLogger;
 
-	void Log::init()
+	std::shared_ptr<spdlog::logger> Log::coreSyncLogger;
+	std::shared_ptr<spdlog::logger> Log::clientSyncLogger;
+
+	void Log::init(bool async)
 	{
 		spdlog::set_pattern("%^[%T] %n: %v%$");
 
-		coreLogger = spdlog::stdout_color_mt("Viper"); 
-		coreLogger->set_level(spdlog::level::trace);
+		if (async)
+		{
+			spdlog::init_thread_pool(LOG_QUEUE_SIZE, LOG_THREAD_COUNT);
+
+			coreLogger = spdlog::stdout_color_mt<spdlog::async_factory_nonblock>("Viper");
+			clientLogger = spdlog::stdout_color_mt<spdlog::async_factory_nonblock>("App");
+
+			// unregistered loggers on the same sinks, the sinks lock around every write
+			coreSyncLogger = std::make_shared<spdlog::logger>("Viper", coreLogger->sinks().begin(), coreLogger->sinks().end());
+			clientSyncLogger = std::make_shared<spdlog::logger>("App", clientLogger->sinks().begin(), clientLogger->sinks().end());
+		}
+		else
+		{
+			coreLogger = spdlog::stdout_color_mt("Viper");
+			clientLogger = spdlog::stdout_color_mt("App");
+
+			coreSyncLogger = coreLogger;
+			clientSyncLogger = clientLogger;
+		}
 
-		clientLogger = spdlog::stdout_color_mt("App");
+		coreLogger->set_level(spdlog::level::trace);
 		clientLogger->set_level(spdlog::level::trace);
+
+		coreSyncLogger->set_level(spdlog::level::trace);
+		clientSyncLogger->set_level(spdlog::level::trace);
+		coreSyncLogger->flush_on(spdlog::level::err);
+		clientSyncLogger->flush_on(spdlog::level::err);
+	}
+
+	void Log::shutdown()
+	{
+		// writes out whatever is still queued and stops the logging thread
+		coreLogger.reset();
+		clientLogger.reset();
+		coreSyncLogger.reset();
+		clientSyncLogger.reset();
+		spdlog::shutdown();
 	}
 
-}
\ No newline at end of file
+}
@@ -5,37 +5,106 @@
 #include "spdlog/spdlog.h"
 #include "spdlog/fmt/ostr.h"
 
+#include <atomic>
+#include <chrono>
+
 namespace Viper
 {
 
 	class VIPER_API Log
 	{
 	public:
-		static void init();
+		/*
+			Asynchronous mode: the calling thread only formats the message into a preallocated queue slot,
+			a background thread writes it to the console. When the queue is full the oldest message is dropped,
+			a logging thread never waits on the console.
+		*/
+		static void init(bool async = true);
+		static void shutdown();
 
 		inline static std::shared_ptr<spdlog::logger> &getCoreLogger() { return coreLogger;  }
 		inline static std::shared_ptr<spdlog::logger> &getClientLogger() { return clientLogger; }
 
+		// write to the same console on the calling thread - asserts and fatal errors must be out before the debugger stops
+		inline static std::shared_ptr<spdlog::logger> &getCoreSyncLogger() { return coreSyncLogger; }
+		inline static std::shared_ptr<spdlog::logger> &getClientSyncLogger() { return clientSyncLogger; }
+
 	private:
 		static std::shared_ptr<spdlog::logger> coreLogger;
 		static std::shared_ptr<spdlog::logger> clientLogger;
+
+		static std::shared_ptr<spdlog::logger> coreSyncLogger;
+		static std::shared_ptr<spdlog::logger> clientSyncLogger;
+	};
+
+
+	//*************** LogRateLimiter class ***************//
+	class LogRateLimiter
+	{
+		/*
+			Lets one message through per interval, used by V_LOG_EVERY_MS for messages logged every frame.
+		*/
+
+	public:
+		bool allow(int64_t intervalMs)
+		{
+			int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+			int64_t next = this->nextTime.load(std::memory_order_relaxed);
+
+			return now >= next && this->nextTime.compare_exchange_strong(next, now + intervalMs, std::memory_order_relaxed);
+		}
+
+	private:
+		std::atomic<int64_t> nextTime{ 0 };
 	};
 
 }
 
 
 
+//*************** Compile time level stripping ***************//
+#define V_LOG_LEVEL_TRACE	0
+#define V_LOG_LEVEL_INFO	1
+
+// messages below the active level are removed from the build together with their arguments
+#ifndef V_LOG_ACTIVE_LEVEL
+	#ifdef V_DEBUG
+		#define V_LOG_ACTIVE_LEVEL V_LOG_LEVEL_TRACE
+	#else
+		#define V_LOG_ACTIVE_LEVEL V_LOG_LEVEL_INFO
+	#endif
+#endif
+
+
 //*************** Core log macros ***************//
 #define V_CORE_INFO(...)		::Viper::Log::getCoreLogger()->info(__VA_ARGS__)
 #define V_CORE_WARN(...)		::Viper::Log::getCoreLogger()->warn(__VA_ARGS__)
 #define V_CORE_ERROR(...)		::Viper::Log::getCoreLogger()->error(__VA_ARGS__)
-#define V_CORE_TRACE(...)		::Viper::Log::getCoreLogger()->trace(__VA_ARGS__)
-#define V_CORE_FATAL(...)		::Viper::Log::getCoreLogger()->fatal(__VA_ARGS__)
+#define V_CORE_FATAL(...)		::Viper::Log::getCoreSyncLogger()->critical(__VA_ARGS__)
+
+#if V_LOG_ACTIVE_LEVEL <= V_LOG_LEVEL_TRACE
+	#define V_CORE_TRACE(...)	::Viper::Log::getCoreLogger()->trace(__VA_ARGS__)
+#else
+	#define V_CORE_TRACE(...)	(void)0
+#endif
 
 
 //*************** Client log macros ***************//
 #define V_INFO(...)			::Viper::Log::getClientLogger()->info(__VA_ARGS__)
 #define V_WARN(...)			::Viper::Log::getClientLogger()->warn(__VA_ARGS__)
 #define V_ERROR(...)		::Viper::Log::getClientLogger()->error(__VA_ARGS__)
-#define V_TRACE(...)		::Viper::Log::getClientLogger()->trace(__VA_ARGS__)
-#define V_FATAL(...)		::Viper::Log::getClientLogger()->fatal(__VA_ARGS__)
+#define V_FATAL(...)		::Viper::Log::getClientSyncLogger()->critical(__VA_ARGS__)
+
+#if V_LOG_ACTIVE_LEVEL <= V_LOG_LEVEL_TRACE
+	#define V_TRACE(...)		::Viper::Log::getClientLogger()->trace(__VA_ARGS__)
+#else
+	#define V_TRACE(...)		(void)0
+#endif
+
+
+//*************** Rate limited logging ***************//
+// e.g. V_LOG_EVERY_N(60, V_CORE_INFO, "frame time {0}", time) - first call and then every 60th call of this line
+#define V_LOG_EVERY_N(n, logMacro, ...)		do { static std::atomic<uint32_t> logCounter{ 0 }; if (logCounter.fetch_add(1, std::memory_order_relaxed) % (n) == 0) logMacro(__VA_ARGS__); } while (0)
+// at most one message per intervalMs milliseconds from this line
+#define V_LOG_EVERY_MS(intervalMs, logMacro, ...)	do { static ::Viper::LogRateLimiter logLimiter; if (logLimiter.allow(intervalMs)) logMacro(__VA_ARGS__); } while (0)
+#define V_LOG_ONCE(logMacro, ...)			do { static std::atomic<bool> logged{ false }; if (!logged.exchange(true, std::memory_order_relaxed)) logMacro(__VA_ARGS__); } while (0)
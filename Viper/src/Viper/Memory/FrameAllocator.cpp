@@ -0,0 +1,52 @@
+#include "vpch.h"
+#include "FrameAllocator.h"
+
+namespace Viper
+{
+
+	#define FRAME_ARENA_BLOCK_SIZE (256 * 1024)
+	#define SCRATCH_ARENA_BLOCK_SIZE (64 * 1024)
+
+	std::atomic<uint64_t> FrameAllocator::frameNumber{ 0 };
+
+	struct FrameArenas
+	{
+		LinearAllocator arenas[2] = { LinearAllocator(FRAME_ARENA_BLOCK_SIZE), LinearAllocator(FRAME_ARENA_BLOCK_SIZE) };
+		uint64_t frames[2] = { 0, 0 };
+
+		LinearAllocator scratch = LinearAllocator(SCRATCH_ARENA_BLOCK_SIZE);
+	};
+
+	static thread_local FrameArenas threadArenas;
+
+	void FrameAllocator::beginFrame()
+	{
+		frameNumber.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void *FrameAllocator::allocate(size_t size, size_t alignment)
+	{
+		return FrameAllocator::get().allocate(size, alignment);
+	}
+
+	LinearAllocator &FrameAllocator::get()
+	{
+		uint64_t frame = frameNumber.load(std::memory_order_relaxed);
+		uint32_t index = (uint32_t)(frame & 1);
+
+		// first allocation of this thread in the frame - whatever was in this arena is two frames old
+		if (threadArenas.frames[index] != frame)
+		{
+			threadArenas.arenas[index].reset();
+			threadArenas.frames[index] = frame;
+		}
+
+		return threadArenas.arenas[index];
+	}
+
+	LinearAllocator &FrameAllocator::getScratch()
+	{
+		return threadArenas.scratch;
+	}
+
+}
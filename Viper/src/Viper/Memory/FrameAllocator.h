@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Viper/Memory/LinearAllocator.h"
+
+#include <atomic>
+
+namespace Viper
+{
+
+	//*************** FrameAllocator class ***************//
+	class VIPER_API FrameAllocator
+	{
+		/*
+			Per-thread linear memory for data that lives for the current frame.
+			Every thread has two arenas used on alternate frames; an arena is reset the first time its thread allocates
+			in a new frame. Memory therefore stays valid until the end of the next frame, long enough for a frame packet
+			to be consumed by the render thread while the main thread is already building the following frame.
+		*/
+
+	public:
+		// called by the application at the start of every frame
+		static void beginFrame();
+		inline static uint64_t getFrameNumber() { return frameNumber; }
+
+		static void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		template<typename T>
+		inline static T *allocate(size_t count = 1) { return static_cast<T*>(FrameAllocator::allocate(count * sizeof(T), alignof(T))); }
+
+		// this thread's arena of the current frame
+		static LinearAllocator &get();
+
+		// this thread's scratch arena for temporaries inside a function, use it through a ScopedArena
+		static LinearAllocator &getScratch();
+
+	private:
+		static std::atomic<uint64_t> frameNumber;
+	};
+
+
+	//*************** FrameAllocatorAdaptor class ***************//
+	template<typename T>
+	class FrameAllocatorAdaptor
+	{
+		/*
+			STL allocator adaptor over the frame allocator of the allocating thread.
+		*/
+
+	public:
+		using value_type = T;
+
+		FrameAllocatorAdaptor() = default;
+
+		template<typename U>
+		FrameAllocatorAdaptor(const FrameAllocatorAdaptor<U> &) { }
+
+		inline T *allocate(size_t count) { return FrameAllocator::allocate<T>(count); }
+		inline void deallocate(T *, size_t) { }
+
+		template<typename U>
+		inline bool operator==(const FrameAllocatorAdaptor<U> &) const { return true; }
+
+		template<typename U>
+		inline bool operator!=(const FrameAllocatorAdaptor<U> &) const { return false; }
+	};
+
+	template<typename T>
+	using FrameVector = std::vector<T, FrameAllocatorAdaptor<T>>;
+
+}
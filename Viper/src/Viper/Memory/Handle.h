@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Viper/Core.h"
+
+namespace Viper
+{
+
+	//*************** Handle struct ***************//
+	template<typename T>
+	struct Handle
+	{
+		/*
+			Safe reference to an object in slot based storage (e.g. TransformHierarchy): slot index + generation of the slot
+			when the object was created. Once the object is destroyed the slot's generation changes, so a stale handle is
+			rejected instead of resolving to whatever reuses the slot. A default constructed handle is null.
+		*/
+
+		static constexpr uint32_t InvalidIndex = ~0u;
+
+		uint32_t index = InvalidIndex;
+		uint32_t generation = 0;
+
+		inline bool isNull() const { return this->index == InvalidIndex; }
+
+		inline bool operator==(const Handle &other) const { return this->index == other.index && this->generation == other.generation; }
+		inline bool operator!=(const Handle &other) const { return !(*this == other); }
+	};
+
+}
@@ -0,0 +1,138 @@
+#include "vpch.h"
+#include "HeapStats.h"
+#include "MemoryTracker.h"
+
+#include <atomic>
+#include <new>
+
+namespace Viper
+{
+
+	static std::atomic<uint64_t> allocationCount{ 0 };
+	static std::atomic<uint64_t> freeCount{ 0 };
+	static std::atomic<uint64_t> allocatedBytes{ 0 };
+	static thread_local uint64_t threadAllocationCount = 0;
+
+#ifdef V_TRACK_MEMORY
+	// in front of every block, 16 bytes keep the alignment malloc guarantees
+	struct AllocationHeader
+	{
+		uint64_t size;
+		uint8_t tag;
+		uint8_t padding[7];
+	};
+
+	static_assert(sizeof(AllocationHeader) == 16, "allocation header must preserve malloc alignment");
+#endif
+
+	static void *countedAllocate(size_t size)
+	{
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+		allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+		threadAllocationCount++;
+
+#ifdef V_TRACK_MEMORY
+		uint8_t *block = static_cast<uint8_t*>(std::malloc(size + sizeof(AllocationHeader)));
+
+		if (!block)
+			throw std::bad_alloc();
+
+		AllocationHeader *header = reinterpret_cast<AllocationHeader*>(block);
+		header->size = size;
+		header->tag = MemoryTracker::onAllocate(size);
+
+		return block + sizeof(AllocationHeader);
+#else
+		// malloc(0) may return null
+		void *memory = std::malloc(size ? size : 1);
+
+		if (!memory)
+			throw std::bad_alloc();
+
+		return memory;
+#endif
+	}
+
+	static void countedFree(void *memory)
+	{
+		if (!memory)
+			return;
+
+		freeCount.fetch_add(1, std::memory_order_relaxed);
+
+#ifdef V_TRACK_MEMORY
+		AllocationHeader *header = reinterpret_cast<AllocationHeader*>(static_cast<uint8_t*>(memory) - sizeof(AllocationHeader));
+		MemoryTracker::onFree(header->tag, header->size);
+		std::free(header);
+#else
+		std::free(memory);
+#endif
+	}
+
+	uint64_t HeapStats::getAllocationCount()
+	{
+		return allocationCount.load(std::memory_order_relaxed);
+	}
+
+	uint64_t HeapStats::getFreeCount()
+	{
+		return freeCount.load(std::memory_order_relaxed);
+	}
+
+	uint64_t HeapStats::getAllocatedBytes()
+	{
+		return allocatedBytes.load(std::memory_order_relaxed);
+	}
+
+	uint64_t HeapStats::getThreadAllocationCount()
+	{
+		return threadAllocationCount;
+	}
+
+}
+
+
+
+//*************** Global operator new / delete ***************//
+
+void *operator new(size_t size)
+{
+	return Viper::countedAllocate(size);
+}
+
+void *operator new[](size_t size)
+{
+	return Viper::countedAllocate(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+	try { return Viper::countedAllocate(size); }
+	catch (...) { return nullptr; }
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+	try { return Viper::countedAllocate(size); }
+	catch (...) { return nullptr; }
+}
+
+void operator delete(void *memory) noexcept
+{
+	Viper::countedFree(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+	Viper::countedFree(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+	Viper::countedFree(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept
+{
+	Viper::countedFree(memory);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Viper/Core.h"
+
+namespace Viper
+{
+
+	//*************** HeapStats class ***************//
+	class VIPER_API HeapStats
+	{
+		/*
+			Counters of the global heap, maintained by the replaced global operator new / delete.
+			Sample them at two points and compare to find allocations in between (e.g. in a steady state frame).
+			Over-aligned allocations (operator new with std::align_val_t) are not counted.
+			Per subsystem usage and peaks are reported by MemoryTracker.
+		*/
+
+	public:
+		static uint64_t getAllocationCount();
+		static uint64_t getFreeCount();
+		static uint64_t getAllocatedBytes();
+
+		// allocations made by the calling thread, not disturbed by other threads
+		static uint64_t getThreadAllocationCount();
+	};
+
+}
@@ -0,0 +1,93 @@
+#include "vpch.h"
+#include "LinearAllocator.h"
+
+namespace Viper
+{
+
+	LinearAllocator::LinearAllocator(size_t blockSize)
+		: blockSize(blockSize)
+	{
+	}
+
+	LinearAllocator::~LinearAllocator()
+	{
+		for (Block &block : this->blocks)
+			::operator delete(block.memory);
+	}
+
+	void *LinearAllocator::allocate(size_t size, size_t alignment)
+	{
+		V_CORE_ASSERT((alignment & (alignment - 1)) == 0, "alignment has to be a power of two!");
+
+		for (;;)
+		{
+			if (this->currentBlock < this->blocks.size())
+			{
+				Block &block = this->blocks[this->currentBlock];
+
+				uintptr_t address = reinterpret_cast<uintptr_t>(block.memory) + this->offset;
+				size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+
+				if (this->offset + padding + size <= block.size)
+				{
+					this->offset += padding + size;
+
+					return reinterpret_cast<void*>(address + padding);
+				}
+
+				// does not fit - continue in the next block
+				if (this->currentBlock + 1 < this->blocks.size())
+				{
+					this->currentBlock++;
+					this->offset = 0;
+					continue;
+				}
+			}
+
+			// out of blocks, the new one is kept for the following frames
+			Block block;
+			block.size = std::max(this->blockSize, size + alignment);
+			block.memory = static_cast<uint8_t*>(::operator new(block.size));
+
+			this->blocks.push_back(block);
+			this->currentBlock = this->blocks.size() - 1;
+			this->offset = 0;
+		}
+	}
+
+	void LinearAllocator::reset()
+	{
+		this->currentBlock = 0;
+		this->offset = 0;
+	}
+
+	void LinearAllocator::rewind(const Marker &marker)
+	{
+		V_CORE_ASSERT(marker.block < this->currentBlock || (marker.block == this->currentBlock && marker.offset <= this->offset),
+					  "rewinding to a marker that is not behind the current position!");
+
+		this->currentBlock = marker.block;
+		this->offset = marker.offset;
+	}
+
+	size_t LinearAllocator::getUsed() const
+	{
+		size_t used = this->offset;
+
+		for (size_t i = 0; i < this->currentBlock && i < this->blocks.size(); i++)
+			used += this->blocks[i].size;
+
+		return used;
+	}
+
+	size_t LinearAllocator::getCapacity() const
+	{
+		size_t capacity = 0;
+
+		for (const Block &block : this->blocks)
+			capacity += block.size;
+
+		return capacity;
+	}
+
+}
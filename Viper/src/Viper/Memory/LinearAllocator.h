@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Viper/Core.h"
+
+#include <vector>
+
+namespace Viper
+{
+
+	//*************** LinearAllocator class ***************//
+	class VIPER_API LinearAllocator
+	{
+		/*
+			Bump allocator over a chain of blocks. Allocating moves an offset forward, nothing is freed individually -
+			reset() (or rewinding to a marker) releases everything allocated after that point at once.
+			Blocks are kept when the allocator is reset, so once the working set has been reached it never touches the heap again.
+		*/
+
+	public:
+		struct Marker
+		{
+			size_t block = 0;
+			size_t offset = 0;
+		};
+
+		LinearAllocator(size_t blockSize = 64 * 1024);
+		~LinearAllocator();
+
+		LinearAllocator(const LinearAllocator &) = delete;
+		LinearAllocator &operator=(const LinearAllocator &) = delete;
+
+		void *allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+		template<typename T>
+		inline T *allocate(size_t count = 1) { return static_cast<T*>(this->allocate(count * sizeof(T), alignof(T))); }
+
+		void reset();
+
+		inline Marker getMarker() const { return { this->currentBlock, this->offset }; }
+		void rewind(const Marker &marker);
+
+		// bytes consumed since the last reset (including alignment padding and unused block tails) / reserved from the heap
+		size_t getUsed() const;
+		size_t getCapacity() const;
+
+	private:
+		struct Block
+		{
+			uint8_t *memory;
+			size_t size;
+		};
+
+		std::vector<Block> blocks;
+		size_t blockSize;
+		size_t currentBlock = 0;
+		size_t offset = 0;
+	};
+
+
+	//*************** ScopedArena class ***************//
+	class ScopedArena
+	{
+		/*
+			Stack-like use of a linear allocator: everything allocated from it while the scope is alive is released at its end.
+		*/
+
+	public:
+		ScopedArena(LinearAllocator &allocator) : allocator(allocator), marker(allocator.getMarker()) { }
+		~ScopedArena() { this->allocator.rewind(this->marker); }
+
+		ScopedArena(const ScopedArena &) = delete;
+		ScopedArena &operator=(const ScopedArena &) = delete;
+
+		inline void *allocate(size_t size, size_t alignment = alignof(std::max_align_t)) { return this->allocator.allocate(size, alignment); }
+
+		template<typename T>
+		inline T *allocate(size_t count = 1) { return this->allocator.allocate<T>(count); }
+
+		inline LinearAllocator &getAllocator() { return this->allocator; }
+
+	private:
+		LinearAllocator &allocator;
+		LinearAllocator::Marker marker;
+	};
+
+
+	//*************** ArenaAllocator class ***************//
+	template<typename T>
+	class ArenaAllocator
+	{
+		/*
+			STL allocator adaptor over a linear allocator, deallocate() is a no-op.
+			Containers using it must not outlive the arena's next reset / rewind.
+		*/
+
+	public:
+		using value_type = T;
+
+		ArenaAllocator(LinearAllocator &arena) : arena(&arena) { }
+
+		template<typename U>
+		ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.getArena()) { }
+
+		inline T *allocate(size_t count) { return this->arena->allocate<T>(count); }
+		inline void deallocate(T *, size_t) { }
+
+		inline LinearAllocator *getArena() const { return this->arena; }
+
+		template<typename U>
+		inline bool operator==(const ArenaAllocator<U> &other) const { return this->arena == other.getArena(); }
+
+		template<typename U>
+		inline bool operator!=(const ArenaAllocator<U> &other) const { return this->arena != other.getArena(); }
+
+	private:
+		LinearAllocator *arena;
+	};
+
+}
@@ -0,0 +1,325 @@
+#include "vpch.h"
+#include "MemoryTracker.h"
+#include "HeapStats.h"
+
+#include <atomic>
+#include <thread>
+
+#ifdef V_PLATFORM_WINDOWS
+	#include <DbgHelp.h>
+	#pragma comment(lib, "Dbghelp.lib")
+#endif
+
+namespace Viper
+{
+
+	#define MAX_SAMPLE_DEPTH 16
+	#define SAMPLE_TABLE_SIZE 1024		// power of two
+	#define SAMPLE_SKIPPED_FRAMES 3		// sampler, tracker hook and allocation function
+
+	struct TagCounters
+	{
+		std::atomic<int64_t> currentBytes{ 0 };
+		std::atomic<int64_t> peakBytes{ 0 };
+		std::atomic<uint64_t> allocations{ 0 };
+		std::atomic<uint64_t> frees{ 0 };
+	};
+
+	struct AllocationSample
+	{
+		uint32_t hash;
+		uint32_t depth;
+		void *frames[MAX_SAMPLE_DEPTH];
+		uint64_t count;
+		uint64_t bytes;
+	};
+
+	static TagCounters tagCounters[(size_t)MemoryTag::Count];
+	static std::atomic<int64_t> currentBytes{ 0 };
+	static std::atomic<int64_t> peakBytes{ 0 };
+	static thread_local MemoryTag threadTag = MemoryTag::Untagged;
+
+	static FrameMemoryStats lastFrame;
+	static uint64_t frameStartAllocations = 0;
+	static uint64_t frameStartFrees = 0;
+	static uint64_t frameStartBytes = 0;
+
+	// sampling profiler, the table is filled from inside operator new so it must never allocate
+	static AllocationSample samples[SAMPLE_TABLE_SIZE];
+	static std::atomic_flag sampleLock = ATOMIC_FLAG_INIT;
+	static std::atomic<uint32_t> samplingInterval{ 0 };
+	static std::atomic<uint64_t> droppedSamples{ 0 };
+	static thread_local uint32_t allocationsSinceSample = 0;
+	static thread_local bool insideSampler = false;
+
+	static const char *tagNames[(size_t)MemoryTag::Count] =
+	{
+		"Untagged", "Renderer", "Assets", "Events", "Layers", "Jobs", "ECS"
+	};
+
+	static void updatePeak(std::atomic<int64_t> &peak, int64_t value)
+	{
+		int64_t current = peak.load(std::memory_order_relaxed);
+
+		while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed))
+			;
+	}
+
+	static void lockSamples()
+	{
+		while (sampleLock.test_and_set(std::memory_order_acquire))
+			std::this_thread::yield();
+	}
+
+	static void unlockSamples()
+	{
+		sampleLock.clear(std::memory_order_release);
+	}
+
+	static void recordSample(size_t size)
+	{
+		AllocationSample sample = {};
+
+#ifdef V_PLATFORM_WINDOWS
+		ULONG hash = 0;
+		sample.depth = CaptureStackBackTrace(SAMPLE_SKIPPED_FRAMES, MAX_SAMPLE_DEPTH, sample.frames, &hash);
+		sample.hash = hash;
+#endif
+
+		lockSamples();
+
+		uint32_t slot = sample.hash & (SAMPLE_TABLE_SIZE - 1);
+
+		for (uint32_t probe = 0; probe < SAMPLE_TABLE_SIZE; probe++, slot = (slot + 1) & (SAMPLE_TABLE_SIZE - 1))
+		{
+			AllocationSample &entry = samples[slot];
+
+			if (entry.count == 0)
+			{
+				entry = sample;
+			}
+			else if (entry.hash != sample.hash || entry.depth != sample.depth ||
+					 memcmp(entry.frames, sample.frames, sample.depth * sizeof(void*)) != 0)
+			{
+				continue;
+			}
+
+			entry.count++;
+			entry.bytes += size;
+
+			unlockSamples();
+			return;
+		}
+
+		unlockSamples();
+		droppedSamples.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	static std::string describeFrame(void *address)
+	{
+#ifdef V_PLATFORM_WINDOWS
+		HANDLE process = GetCurrentProcess();
+
+		alignas(SYMBOL_INFO) char buffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME];
+		SYMBOL_INFO *symbol = reinterpret_cast<SYMBOL_INFO*>(buffer);
+		symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+		symbol->MaxNameLen = MAX_SYM_NAME;
+
+		DWORD64 displacement = 0;
+
+		if (SymFromAddr(process, (DWORD64)address, &displacement, symbol))
+		{
+			IMAGEHLP_LINE64 line = {};
+			line.SizeOfStruct = sizeof(line);
+			DWORD lineDisplacement = 0;
+
+			if (SymGetLineFromAddr64(process, (DWORD64)address, &lineDisplacement, &line))
+				return fmt::format("{0} ({1}:{2})", symbol->Name, line.FileName, line.LineNumber);
+
+			return symbol->Name;
+		}
+#endif
+
+		return fmt::format("{0}", address);
+	}
+
+
+
+	//*************** MemoryTracker class ***************//
+
+	void MemoryTracker::beginFrame()
+	{
+		uint64_t allocations = HeapStats::getAllocationCount();
+		uint64_t frees = HeapStats::getFreeCount();
+		uint64_t bytes = HeapStats::getAllocatedBytes();
+
+		lastFrame.allocations = allocations - frameStartAllocations;
+		lastFrame.frees = frees - frameStartFrees;
+		lastFrame.bytes = bytes - frameStartBytes;
+
+		frameStartAllocations = allocations;
+		frameStartFrees = frees;
+		frameStartBytes = bytes;
+	}
+
+	const FrameMemoryStats &MemoryTracker::getLastFrame()
+	{
+		return lastFrame;
+	}
+
+	MemoryTagStats MemoryTracker::getTagStats(MemoryTag tag)
+	{
+		const TagCounters &counters = tagCounters[(size_t)tag];
+
+		MemoryTagStats stats;
+		stats.currentBytes = counters.currentBytes.load(std::memory_order_relaxed);
+		stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+		stats.allocations = counters.allocations.load(std::memory_order_relaxed);
+		stats.frees = counters.frees.load(std::memory_order_relaxed);
+
+		return stats;
+	}
+
+	int64_t MemoryTracker::getCurrentBytes()
+	{
+		return currentBytes.load(std::memory_order_relaxed);
+	}
+
+	int64_t MemoryTracker::getPeakBytes()
+	{
+		return peakBytes.load(std::memory_order_relaxed);
+	}
+
+	MemoryTag MemoryTracker::getThreadTag()
+	{
+		return threadTag;
+	}
+
+	MemoryTag MemoryTracker::setThreadTag(MemoryTag tag)
+	{
+		MemoryTag previous = threadTag;
+		threadTag = tag;
+
+		return previous;
+	}
+
+	const char *MemoryTracker::getTagName(MemoryTag tag)
+	{
+		return tagNames[(size_t)tag];
+	}
+
+	void MemoryTracker::setSamplingInterval(uint32_t interval)
+	{
+		samplingInterval.store(interval, std::memory_order_relaxed);
+	}
+
+	void MemoryTracker::clearSamples()
+	{
+		lockSamples();
+		memset(samples, 0, sizeof(samples));
+		unlockSamples();
+
+		droppedSamples.store(0, std::memory_order_relaxed);
+	}
+
+	void MemoryTracker::logReport()
+	{
+#ifdef V_TRACK_MEMORY
+		V_CORE_INFO("Heap: {0} KB in use, peak {1} KB", getCurrentBytes() / 1024, getPeakBytes() / 1024);
+
+		for (size_t i = 0; i < (size_t)MemoryTag::Count; i++)
+		{
+			MemoryTagStats stats = getTagStats((MemoryTag)i);
+
+			if (stats.allocations == 0)
+				continue;
+
+			V_CORE_INFO("    {0:<9} {1:>8} KB in use, peak {2:>8} KB, {3} allocations, {4} frees",
+						tagNames[i], stats.currentBytes / 1024, stats.peakBytes / 1024, stats.allocations, stats.frees);
+		}
+#else
+		V_CORE_INFO("Heap: {0} allocations, {1} frees, {2} KB allocated (build without V_TRACK_MEMORY)",
+					HeapStats::getAllocationCount(), HeapStats::getFreeCount(), HeapStats::getAllocatedBytes() / 1024);
+#endif
+	}
+
+	void MemoryTracker::dumpSamples(uint32_t maxStacks)
+	{
+		uint32_t interval = samplingInterval.load(std::memory_order_relaxed);
+
+		if (interval == 0)
+			return;
+
+		// the dump allocates itself, keep it out of the table
+		insideSampler = true;
+
+		std::vector<AllocationSample> hottest;
+		hottest.reserve(SAMPLE_TABLE_SIZE);
+
+		lockSamples();
+		for (const AllocationSample &sample : samples)
+		{
+			if (sample.count)
+				hottest.push_back(sample);
+		}
+		unlockSamples();
+
+		std::sort(hottest.begin(), hottest.end(),
+				  [](const AllocationSample &a, const AllocationSample &b) { return a.count > b.count; });
+
+#ifdef V_PLATFORM_WINDOWS
+		static bool symbolsLoaded = false;
+
+		if (!symbolsLoaded)
+			symbolsLoaded = SymInitialize(GetCurrentProcess(), nullptr, TRUE);
+#endif
+
+		V_CORE_INFO("Allocation hotspots (1 in {0} allocations sampled, {1} samples dropped):",
+					interval, droppedSamples.load(std::memory_order_relaxed));
+
+		for (size_t i = 0; i < std::min<size_t>(maxStacks, hottest.size()); i++)
+		{
+			const AllocationSample &sample = hottest[i];
+
+			V_CORE_INFO("#{0}: ~{1} allocations, ~{2} KB", i, sample.count * interval, sample.bytes * interval / 1024);
+
+			for (uint32_t frame = 0; frame < sample.depth; frame++)
+				V_CORE_INFO("        {0}", describeFrame(sample.frames[frame]));
+		}
+
+		insideSampler = false;
+	}
+
+	uint8_t MemoryTracker::onAllocate(size_t size)
+	{
+		MemoryTag tag = threadTag;
+		TagCounters &counters = tagCounters[(size_t)tag];
+
+		counters.allocations.fetch_add(1, std::memory_order_relaxed);
+		updatePeak(counters.peakBytes, counters.currentBytes.fetch_add(size, std::memory_order_relaxed) + (int64_t)size);
+		updatePeak(peakBytes, currentBytes.fetch_add(size, std::memory_order_relaxed) + (int64_t)size);
+
+		uint32_t interval = samplingInterval.load(std::memory_order_relaxed);
+
+		if (interval && !insideSampler && ++allocationsSinceSample >= interval)
+		{
+			allocationsSinceSample = 0;
+
+			insideSampler = true;
+			recordSample(size);
+			insideSampler = false;
+		}
+
+		return (uint8_t)tag;
+	}
+
+	void MemoryTracker::onFree(uint8_t tag, size_t size)
+	{
+		TagCounters &counters = tagCounters[tag];
+
+		counters.frees.fetch_add(1, std::memory_order_relaxed);
+		counters.currentBytes.fetch_sub(size, std::memory_order_relaxed);
+		currentBytes.fetch_sub(size, std::memory_order_relaxed);
+	}
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Viper/Core.h"
+
+namespace Viper
+{
+
+	enum class MemoryTag : uint8_t
+	{
+		Untagged = 0, Renderer, Assets, Events, Layers, Jobs, ECS,
+		Count
+	};
+
+	struct MemoryTagStats
+	{
+		int64_t currentBytes = 0;
+		int64_t peakBytes = 0;
+		uint64_t allocations = 0;
+		uint64_t frees = 0;
+	};
+
+	struct FrameMemoryStats
+	{
+		// heap traffic of all threads during the last completed frame
+		uint64_t allocations = 0;
+		uint64_t frees = 0;
+		uint64_t bytes = 0;
+	};
+
+
+	//*************** MemoryTracker class ***************//
+	class VIPER_API MemoryTracker
+	{
+		/*
+			Tagged view of the global heap, fed by the replaced operator new / delete.
+			In tracked builds (V_TRACK_MEMORY) every block carries a small header with its size and the tag that was
+			active on the allocating thread, so frees are attributed to the right subsystem and current / peak usage is exact.
+			Without tracking only the untagged counters of HeapStats exist and the tag queries return zeros.
+
+			The sampling profiler records the callstack of every n-th allocation and aggregates identical stacks,
+			dumpSamples() logs the hottest ones.
+		*/
+
+	public:
+		static void beginFrame();
+		static const FrameMemoryStats &getLastFrame();
+
+		static MemoryTagStats getTagStats(MemoryTag tag);
+		static int64_t getCurrentBytes();
+		static int64_t getPeakBytes();
+
+		static MemoryTag getThreadTag();
+		static MemoryTag setThreadTag(MemoryTag tag);
+		static const char *getTagName(MemoryTag tag);
+
+		// sample every n-th allocation of each thread, 0 turns sampling off
+		static void setSamplingInterval(uint32_t interval);
+		static void clearSamples();
+
+		static void logReport();
+		static void dumpSamples(uint32_t maxStacks = 10);
+
+		// called by the global allocation functions
+		static uint8_t onAllocate(size_t size);
+		static void onFree(uint8_t tag, size_t size);
+	};
+
+
+	//*************** MemoryTagScope class ***************//
+	class MemoryTagScope
+	{
+		/*
+			Tags every allocation of the current thread until the end of the scope.
+		*/
+
+	public:
+		MemoryTagScope(MemoryTag tag) : previous(MemoryTracker::setThreadTag(tag)) {}
+		~MemoryTagScope() { MemoryTracker::setThreadTag(this->previous); }
+
+		MemoryTagScope(const MemoryTagScope &) = delete;
+		MemoryTagScope &operator=(const MemoryTagScope &) = delete;
+
+	private:
+		MemoryTag previous;
+	};
+
+}
+
+#define V_MEMORY_TAG_CONCAT_IMPL(a, b) a##b
+#define V_MEMORY_TAG_CONCAT(a, b) V_MEMORY_TAG_CONCAT_IMPL(a, b)
+
+#ifdef V_TRACK_MEMORY
+	#define V_MEMORY_TAG(tag) ::Viper::MemoryTagScope V_MEMORY_TAG_CONCAT(memoryTagScope, __LINE__)(::Viper::MemoryTag::tag)
+#else
+	#define V_MEMORY_TAG(tag)
+#endif
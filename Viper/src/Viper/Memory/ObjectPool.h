@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Viper/Core.h"
+
+#include <vector>
+#include <type_traits>
+
+namespace Viper
+{
+
+	//*************** ObjectPool class ***************//
+	template<typename T, size_t ObjectsPerChunk = 256>
+	class ObjectPool
+	{
+		/*
+			Fixed-size object pool. Objects live in chunks of ObjectsPerChunk slots that are never moved or freed
+			while the pool exists; free slots are linked through their own storage, so create/destroy is a list push/pop.
+			Not thread safe.
+		*/
+
+	public:
+		ObjectPool() = default;
+
+		~ObjectPool()
+		{
+			V_CORE_ASSERT(this->liveCount == 0, "object pool destroyed with live objects!");
+
+			for (Slot *chunk : this->chunks)
+				delete[] chunk;
+		}
+
+		ObjectPool(const ObjectPool &) = delete;
+		ObjectPool &operator=(const ObjectPool &) = delete;
+
+		template<typename... Args>
+		T *create(Args&&... args)
+		{
+			if (!this->freeList)
+				this->addChunk();
+
+			Slot *slot = this->freeList;
+			this->freeList = slot->next;
+			this->liveCount++;
+
+			return new (&slot->storage) T(std::forward<Args>(args)...);
+		}
+
+		void destroy(T *object)
+		{
+			if (!object)
+				return;
+
+			object->~T();
+
+			Slot *slot = reinterpret_cast<Slot*>(object);
+			slot->next = this->freeList;
+			this->freeList = slot;
+			this->liveCount--;
+		}
+
+		inline size_t size() const { return this->liveCount; }
+		inline size_t capacity() const { return this->chunks.size() * ObjectsPerChunk; }
+
+	private:
+		union Slot
+		{
+			Slot *next;
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+		};
+
+		void addChunk()
+		{
+			Slot *chunk = new Slot[ObjectsPerChunk];
+			this->chunks.push_back(chunk);
+
+			// lowest addresses first, consecutive creates end up next to each other
+			for (size_t i = 0; i < ObjectsPerChunk; i++)
+				chunk[i].next = (i + 1 < ObjectsPerChunk) ? &chunk[i + 1] : this->freeList;
+
+			this->freeList = chunk;
+		}
+
+	private:
+		std::vector<Slot*> chunks;
+		Slot *freeList = nullptr;
+		size_t liveCount = 0;
+	};
+
+}
@@ -0,0 +1,81 @@
+#include "vpch.h"
+#include "SlabAllocator.h"
+
+namespace Viper
+{
+
+	SlabAllocator::SlabAllocator()
+	{
+	}
+
+	SlabAllocator::~SlabAllocator()
+	{
+		V_CORE_ASSERT(this->liveBlocks == 0, "slab allocator destroyed with live blocks!");
+
+		for (uint8_t *slab : this->slabs)
+			::operator delete(slab);
+	}
+
+	void *SlabAllocator::allocate(size_t size)
+	{
+		if (size > MaxBlockSize)
+			return ::operator new(size);
+
+		size_t sizeClass = SlabAllocator::getSizeClass(size);
+
+		if (!this->freeLists[sizeClass])
+		{
+			// carve a new slab into blocks of this class
+			size_t blockSize = MinBlockSize << sizeClass;
+			uint8_t *slab = static_cast<uint8_t*>(::operator new(SlabSize));
+			this->slabs.push_back(slab);
+
+			for (size_t offset = SlabSize; offset >= blockSize; offset -= blockSize)
+			{
+				FreeBlock *block = reinterpret_cast<FreeBlock*>(slab + offset - blockSize);
+				block->next = this->freeLists[sizeClass];
+				this->freeLists[sizeClass] = block;
+			}
+		}
+
+		FreeBlock *block = this->freeLists[sizeClass];
+		this->freeLists[sizeClass] = block->next;
+		this->liveBlocks++;
+
+		return block;
+	}
+
+	void SlabAllocator::free(void *memory, size_t size)
+	{
+		if (!memory)
+			return;
+
+		if (size > MaxBlockSize)
+		{
+			::operator delete(memory);
+			return;
+		}
+
+		size_t sizeClass = SlabAllocator::getSizeClass(size);
+
+		FreeBlock *block = static_cast<FreeBlock*>(memory);
+		block->next = this->freeLists[sizeClass];
+		this->freeLists[sizeClass] = block;
+		this->liveBlocks--;
+	}
+
+	size_t SlabAllocator::getSizeClass(size_t size)
+	{
+		size_t sizeClass = 0;
+		size_t blockSize = MinBlockSize;
+
+		while (blockSize < size)
+		{
+			blockSize <<= 1;
+			sizeClass++;
+		}
+
+		return sizeClass;
+	}
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Viper/Core.h"
+
+#include <vector>
+
+namespace Viper
+{
+
+	//*************** SlabAllocator class ***************//
+	class VIPER_API SlabAllocator
+	{
+		/*
+			General purpose allocator for small objects of varying size.
+			Requests are rounded up to a power of two size class (16 B .. 2 KB); every class carves fixed-size blocks
+			out of 64 KB slabs and recycles them through a free list. Larger requests go to the heap.
+			The caller passes the size back when freeing, no per-block header is stored. Not thread safe.
+		*/
+
+	public:
+		static constexpr size_t MinBlockSize = 16;
+		static constexpr size_t MaxBlockSize = 2048;
+		static constexpr size_t SlabSize = 64 * 1024;
+
+		SlabAllocator();
+		~SlabAllocator();
+
+		SlabAllocator(const SlabAllocator &) = delete;
+		SlabAllocator &operator=(const SlabAllocator &) = delete;
+
+		void *allocate(size_t size);
+		void free(void *memory, size_t size);
+
+		template<typename T, typename... Args>
+		T *create(Args&&... args)
+		{
+			static_assert(alignof(T) <= MinBlockSize, "over-aligned types are not supported by the slab allocator");
+			return new (this->allocate(sizeof(T))) T(std::forward<Args>(args)...);
+		}
+
+		template<typename T>
+		void destroy(T *object)
+		{
+			if (!object)
+				return;
+
+			object->~T();
+			this->free(object, sizeof(T));
+		}
+
+		// blocks handed out and bytes reserved in slabs
+		inline size_t getLiveBlocks() const { return this->liveBlocks; }
+		inline size_t getReservedBytes() const { return this->slabs.size() * SlabSize; }
+
+	private:
+		static size_t getSizeClass(size_t size);
+
+	private:
+		struct FreeBlock
+		{
+			FreeBlock *next;
+		};
+
+		static constexpr size_t SizeClassCount = 8;	// 16, 32, ..., 2048
+
+		FreeBlock *freeLists[SizeClassCount] = {};
+		std::vector<uint8_t*> slabs;
+		size_t liveBlocks = 0;
+	};
+
+}
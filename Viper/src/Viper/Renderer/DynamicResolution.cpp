@@ -0,0 +1,97 @@
+#include "vpch.h"
+#include "DynamicResolution.h"
+
+namespace Viper
+{
+
+	#define FILTER_WEIGHT 0.1f			// weight of a new sample in the exponential moving average
+	#define TARGET_LOAD 0.9f			// aim below the budget to leave headroom for spikes
+	#define UPSCALE_THRESHOLD 0.75f		// only grow once the frame uses less than this share of the budget
+	#define MAX_UPSCALE_STEP 0.02f
+	#define CHANGE_COOLDOWN 4
+
+	DynamicResolution::DynamicResolution(float gpuBudget, float minScale, float maxScale)
+		: gpuBudget(gpuBudget), minScale(minScale), maxScale(maxScale), scale(maxScale)
+	{
+		V_CORE_ASSERT(minScale > 0.0f && minScale <= maxScale, "invalid resolution scale range!");
+	}
+
+	float DynamicResolution::update(float gpuTime)
+	{
+		if (gpuTime <= 0.0f)
+			return this->scale;
+
+		// the frames still in flight after a change were rendered at the old scale, keep them out of the filter
+		if (this->enabled && this->cooldown > 0)
+		{
+			this->cooldown--;
+			return this->scale;
+		}
+
+		if (this->filteredTime == 0.0f)
+			this->filteredTime = gpuTime;
+		else
+			this->filteredTime += (gpuTime - this->filteredTime) * FILTER_WEIGHT;
+
+		if (!this->enabled)
+			return this->scale;
+
+		float target = this->scale * std::sqrt(this->gpuBudget * TARGET_LOAD / this->filteredTime);
+		target = std::max(this->minScale, std::min(this->maxScale, target));
+
+		float next = this->scale;
+
+		// over budget - drop straight to the estimate, under budget - creep back up
+		if (this->filteredTime > this->gpuBudget)
+			next = std::min(this->scale, target);
+		else if (this->filteredTime < this->gpuBudget * UPSCALE_THRESHOLD)
+			next = std::min(target, this->scale + MAX_UPSCALE_STEP);
+
+		if (next != this->scale)
+		{
+			this->applyScale(next);
+			this->cooldown = CHANGE_COOLDOWN;
+		}
+
+		return this->scale;
+	}
+
+	void DynamicResolution::setEnabled(bool enabled)
+	{
+		this->enabled = enabled;
+
+		if (!enabled)
+			this->applyScale(this->maxScale);
+	}
+
+	void DynamicResolution::setBudget(float gpuBudget)
+	{
+		V_CORE_ASSERT(gpuBudget > 0.0f, "GPU budget has to be positive!");
+		this->gpuBudget = gpuBudget;
+	}
+
+	void DynamicResolution::setScaleRange(float minScale, float maxScale)
+	{
+		V_CORE_ASSERT(minScale > 0.0f && minScale <= maxScale, "invalid resolution scale range!");
+
+		this->minScale = minScale;
+		this->maxScale = maxScale;
+		this->applyScale(std::max(minScale, std::min(maxScale, this->scale)));
+	}
+
+	void DynamicResolution::applyScale(float newScale)
+	{
+		/*
+			The filtered time holds samples taken at the old scale. Without carrying it over to the new one,
+			the next estimate would shrink the already reduced scale again for the same slow frames.
+		*/
+		if (this->filteredTime > 0.0f)
+		{
+			float ratio = newScale / this->scale;
+			this->filteredTime *= ratio * ratio;
+		}
+
+		this->scale = newScale;
+	}
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Viper/Core.h"
+
+namespace Viper
+{
+
+	class VIPER_API DynamicResolution
+	{
+		/*
+			Picks the resolution scale of the scene render target from the measured GPU frame time.
+			GPU time is roughly proportional to the number of shaded pixels (scale^2), so the next scale is
+			estimated from the ratio between the budget and the filtered frame time. The scale drops quickly
+			when the budget is exceeded and recovers slowly once there is headroom again.
+		*/
+
+	public:
+		DynamicResolution(float gpuBudget = 16.6f, float minScale = 0.5f, float maxScale = 1.0f);
+
+		// feed the GPU time of a finished frame in milliseconds, returns the scale for the next frame
+		float update(float gpuTime);
+
+		void setEnabled(bool enabled);
+		void setBudget(float gpuBudget);
+		void setScaleRange(float minScale, float maxScale);
+
+		inline bool isEnabled() const { return this->enabled; }
+		inline float getBudget() const { return this->gpuBudget; }
+		inline float getScale() const { return this->scale; }
+		inline float getFilteredTime() const { return this->filteredTime; }
+
+	private:
+		// switches to a new scale and rescales the filtered time to the pixel count it will be measured at
+		void applyScale(float newScale);
+
+	private:
+		bool enabled = true;
+
+		float gpuBudget;
+		float minScale;
+		float maxScale;
+
+		float scale;
+		float filteredTime = 0.0f;
+
+		// frames to wait after a change - GPU times arrive a few frames late
+		uint32_t cooldown = 0;
+	};
+
+}
@@ -1,6 +1,11 @@
 #pragma once
 
+#include "Viper/Renderer/RenderQueue.h"
+#include "Viper/Renderer/OverlayBatch.h"
+#include "Viper/Renderer/RenderStats.h"
+#include "Viper/Renderer/DynamicResolution.h"
 
+#include <glm/glm.hpp>
 
 namespace Viper
 {
@@ -12,9 +17,39 @@ namespace Viper
 		virtual void init() = 0;
 		virtual void swapBuffers() = 0;
 
-		// testing
-		virtual void updateVertices(std::pair<float, float> v1, std::pair<float, float> v2, std::pair<float, float> v3) = 0;
+		// draws submitted during the frame are handed to the render thread by swapBuffers(), which sorts and records them
+		virtual RenderQueue &getRenderQueue() = 0;
+
+		// screen space quads and text drawn over the frame, handed over together with the render queue
+		virtual OverlayBatch &getOverlay() = 0;
+
+		// counters of the last frame the render thread finished
+		virtual const RenderStats &getStats() const = 0;
+
+		// controller of the scene render scale (GPU time budget, scale range, on/off)
+		// it is updated on the render thread, configure it before the first frame
+		virtual DynamicResolution &getDynamicResolution() = 0;
+
+		// camera used for the next recorded frame, draws submitted with bounds are culled against its frustum
+		virtual void setCamera(const glm::mat4 &viewProjection) = 0;
+		virtual const glm::mat4 &getCamera() const = 0;
+
+		// world matrices of the next recorded frame, copied as one block into a storage buffer read by the vertex shader
+		// draws address them with DrawCommand::transformIndex
+		virtual void setTransforms(const glm::mat4 *matrices, uint32_t count) = 0;
+
+		// recreate the swap chain before the next frame (e.g. the presentation policy has changed)
+		virtual void invalidateSwapChain() = 0;
+
+		// glfw time of the oldest input the next presented frame reacts to (0 = none), used for the input latency stat
+		virtual void setInputTimestamp(double time) = 0;
+
+		// testing: the matrix places the culling bounds, the index (when set) is what the draw uses (see setTransforms)
+		virtual void setTestTransform(const glm::mat4 &transform, uint32_t transformIndex = DrawCommand::NoTransform) = 0;
+
+		// world space bounds of the test triangle as it is drawn with the current transform
+		virtual AABB getTestBounds() const = 0;
 
 	};
 
-}
\ No newline at end of file
+}
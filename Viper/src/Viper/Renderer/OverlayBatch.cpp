@@ -0,0 +1,158 @@
+#include "vpch.h"
+#include "OverlayBatch.h"
+
+namespace Viper
+{
+
+	#define OVERLAY_BATCH_RESERVE 4096
+	#define GLYPH_SPACING 1
+
+	// rows of the 5x7 font, top row first, bit 4 is the leftmost pixel (ASCII 32..95)
+	static const uint8_t fontRows[64][7] =
+	{
+		{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },	// ' '
+		{ 0x04, 0x04, 0x04, 0x04, 0x00, 0x00, 0x04 },	// !
+		{ 0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00 },	// "
+		{ 0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A },	// #
+		{ 0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04 },	// $
+		{ 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 },	// %
+		{ 0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D },	// &
+		{ 0x0C, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00 },	// '
+		{ 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 },	// (
+		{ 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 },	// )
+		{ 0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00 },	// *
+		{ 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00 },	// +
+		{ 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08 },	// ,
+		{ 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 },	// -
+		{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C },	// .
+		{ 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 },	// /
+		{ 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E },	// 0
+		{ 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E },	// 1
+		{ 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F },	// 2
+		{ 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E },	// 3
+		{ 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 },	// 4
+		{ 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E },	// 5
+		{ 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E },	// 6
+		{ 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },	// 7
+		{ 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E },	// 8
+		{ 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C },	// 9
+		{ 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 },	// :
+		{ 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08 },	// ;
+		{ 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02 },	// <
+		{ 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00 },	// =
+		{ 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08 },	// >
+		{ 0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 },	// ?
+		{ 0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E },	// @
+		{ 0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11 },	// A
+		{ 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E },	// B
+		{ 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E },	// C
+		{ 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C },	// D
+		{ 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F },	// E
+		{ 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 },	// F
+		{ 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F },	// G
+		{ 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 },	// H
+		{ 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E },	// I
+		{ 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C },	// J
+		{ 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 },	// K
+		{ 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F },	// L
+		{ 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 },	// M
+		{ 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 },	// N
+		{ 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },	// O
+		{ 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 },	// P
+		{ 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D },	// Q
+		{ 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 },	// R
+		{ 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E },	// S
+		{ 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },	// T
+		{ 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E },	// U
+		{ 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 },	// V
+		{ 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A },	// W
+		{ 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 },	// X
+		{ 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 },	// Y
+		{ 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F },	// Z
+		{ 0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E },	// [
+		{ 0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00 },	// backslash
+		{ 0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E },	// ]
+		{ 0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00 },	// ^
+		{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F }	// _
+	};
+
+	static const uint64_t solidGlyph = (1ull << (OverlayBatch::GlyphWidth * OverlayBatch::GlyphHeight)) - 1;
+
+	static uint64_t getGlyph(char character)
+	{
+		// the masks the shader reads, built once from the rows above
+		static const std::array<uint64_t, 64> glyphs = []()
+		{
+			std::array<uint64_t, 64> masks = {};
+
+			for (size_t glyph = 0; glyph < masks.size(); glyph++)
+			{
+				for (uint32_t row = 0; row < OverlayBatch::GlyphHeight; row++)
+				{
+					for (uint32_t column = 0; column < OverlayBatch::GlyphWidth; column++)
+					{
+						if (fontRows[glyph][row] & (0x10 >> column))
+							masks[glyph] |= 1ull << (row * OverlayBatch::GlyphWidth + column);
+					}
+				}
+			}
+
+			return masks;
+		}();
+
+		if (character >= 'a' && character <= 'z')
+			character -= 'a' - 'A';
+
+		if (character < ' ' || character > '_')
+			character = '?';
+
+		return glyphs[character - ' '];
+	}
+
+	OverlayBatch::OverlayBatch()
+	{
+		this->vertices.reserve(OVERLAY_BATCH_RESERVE);
+	}
+
+	void OverlayBatch::drawRect(float x, float y, float width, float height, uint32_t color)
+	{
+		this->pushQuad(x, y, width, height, color, solidGlyph);
+	}
+
+	float OverlayBatch::drawText(float x, float y, const char *text, uint32_t color, float scale)
+	{
+		const float advance = (GlyphWidth + GLYPH_SPACING) * scale;
+
+		for (; *text; text++, x += advance)
+		{
+			// nothing to draw for spaces
+			if (*text == ' ')
+				continue;
+
+			this->pushQuad(x, y, GlyphWidth * scale, GlyphHeight * scale, color, getGlyph(*text));
+		}
+
+		return x;
+	}
+
+	void OverlayBatch::pushQuad(float x, float y, float width, float height, uint32_t color, uint64_t glyph)
+	{
+		uint32_t low = (uint32_t)glyph;
+		uint32_t high = (uint32_t)(glyph >> 32);
+
+		// the cell coordinates span the whole glyph grid, for solid quads every pixel of it is set
+		OverlayVertex topLeft = { { x, y }, { 0.0f, 0.0f }, color, { low, high } };
+		OverlayVertex topRight = { { x + width, y }, { (float)GlyphWidth, 0.0f }, color, { low, high } };
+		OverlayVertex bottomLeft = { { x, y + height }, { 0.0f, (float)GlyphHeight }, color, { low, high } };
+		OverlayVertex bottomRight = { { x + width, y + height }, { (float)GlyphWidth, (float)GlyphHeight }, color, { low, high } };
+
+		this->vertices.push_back(topLeft);
+		this->vertices.push_back(topRight);
+		this->vertices.push_back(bottomRight);
+
+		this->vertices.push_back(bottomRight);
+		this->vertices.push_back(bottomLeft);
+		this->vertices.push_back(topLeft);
+	}
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Viper/Core.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace Viper
+{
+
+	//*************** OverlayVertex struct ***************//
+	struct OverlayVertex
+	{
+		glm::vec2 position;		// pixels, origin in the top-left corner of the window
+		glm::vec2 cell;			// position inside the 5x7 glyph cell
+		uint32_t color;			// RGBA8
+		uint32_t glyph[2];		// 35 bit glyph mask, bit (row * 5 + column); all set for solid quads
+	};
+
+
+	//*************** OverlayBatch class ***************//
+	class VIPER_API OverlayBatch
+	{
+		/*
+			Screen space quads and text drawn over the finished frame (debug overlays, stats).
+			Everything ends up in one vertex array drawn with a single draw call. Text uses a built-in 5x7 bitmap font
+			whose glyphs travel with the vertices, the fragment shader picks the pixels - no font texture involved.
+			Only ASCII 32..95 have glyphs, lower case letters are drawn upper case.
+		*/
+
+	public:
+		static constexpr uint32_t GlyphWidth = 5;
+		static constexpr uint32_t GlyphHeight = 7;
+
+		OverlayBatch();
+
+		void drawRect(float x, float y, float width, float height, uint32_t color);
+
+		// scale is the size of a font pixel, returns the x coordinate after the last character
+		float drawText(float x, float y, const char *text, uint32_t color, float scale = 2.0f);
+
+		inline static uint32_t packColor(float r, float g, float b, float a = 1.0f)
+		{
+			return  (uint32_t)(r * 255.0f + 0.5f) | ((uint32_t)(g * 255.0f + 0.5f) << 8) |
+				   ((uint32_t)(b * 255.0f + 0.5f) << 16) | ((uint32_t)(a * 255.0f + 0.5f) << 24);
+		}
+
+		inline void clear() { this->vertices.clear(); }
+		inline bool empty() const { return this->vertices.empty(); }
+		inline size_t size() const { return this->vertices.size(); }
+		inline const OverlayVertex *data() const { return this->vertices.data(); }
+
+	private:
+		void pushQuad(float x, float y, float width, float height, uint32_t color, uint64_t glyph);
+
+	private:
+		std::vector<OverlayVertex> vertices;
+	};
+
+}
@@ -0,0 +1,147 @@
+#include "vpch.h"
+#include "RenderQueue.h"
+
+#include "Viper/Memory/FrameAllocator.h"
+
+namespace Viper
+{
+
+	#define RENDER_QUEUE_RESERVE 1024
+	#define INSERTION_SORT_THRESHOLD 32
+
+	//*************** SortKey class ***************//
+
+	uint64_t SortKey::encode(RenderPassType pass, uint32_t pipeline, uint32_t material, float depth)
+	{
+		V_CORE_ASSERT(pipeline < (1u << PipelineBits), "pipeline index does not fit in the sort key!");
+		V_CORE_ASSERT(material < (1u << MaterialBits), "material index does not fit in the sort key!");
+
+		// bit pattern of a non-negative IEEE float grows monotonically with its value
+		depth = std::max(depth, 0.0f);
+		uint32_t depthBits;
+		memcpy(&depthBits, &depth, sizeof(depthBits));
+
+		// transparent geometry has to be blended back-to-front
+		if (pass == RenderPassType::Transparent)
+			depthBits = ~depthBits;
+
+		return ((uint64_t)pass << PassShift) |
+			   ((uint64_t)pipeline << PipelineShift) |
+			   ((uint64_t)material << MaterialShift) |
+			   ((uint64_t)depthBits << DepthShift);
+	}
+
+
+
+	//*************** RenderQueue class ***************//
+
+	RenderQueue::RenderQueue()
+		: cullFrustum(Frustum::fromMatrix(glm::mat4(1.0f)))	// the default camera of the context
+	{
+		this->commands.reserve(RENDER_QUEUE_RESERVE);
+		this->entries.reserve(RENDER_QUEUE_RESERVE);
+	}
+
+	void RenderQueue::submit(RenderPassType pass, float depth, const DrawCommand &command)
+	{
+		Entry entry;
+		entry.key = SortKey::encode(pass, command.pipeline, command.material, depth);
+		entry.index = static_cast<uint32_t>(this->commands.size());
+
+		this->commands.push_back(command);
+		this->entries.push_back(entry);
+	}
+
+	bool RenderQueue::submit(RenderPassType pass, float depth, const DrawCommand &command, const AABB &bounds)
+	{
+		if (this->cullFrustum.test(bounds) == Frustum::Containment::Outside)
+		{
+			this->culledCount++;
+			return false;
+		}
+
+		this->submit(pass, depth, command);
+		return true;
+	}
+
+	void RenderQueue::sort()
+	{
+		/*
+			LSD radix sort over the 8 bytes of the key.
+			All 8 histograms are built in a single pass; a byte that is equal for every key (e.g. the pass nibble
+			in a frame with only opaque draws) leaves the order unchanged, so its scatter pass is skipped.
+		*/
+
+		const size_t count = this->entries.size();
+
+		if (count < 2)
+			return;
+
+		if (count < INSERTION_SORT_THRESHOLD)
+		{
+			for (size_t i = 1; i < count; i++)
+			{
+				Entry entry = this->entries[i];
+				size_t j = i;
+
+				while (j > 0 && this->entries[j - 1].key > entry.key)
+				{
+					this->entries[j] = this->entries[j - 1];
+					j--;
+				}
+
+				this->entries[j] = entry;
+			}
+
+			return;
+		}
+
+		uint32_t histograms[8][256] = {};
+
+		for (const Entry &entry : this->entries)
+		{
+			for (uint32_t byte = 0; byte < 8; byte++)
+				histograms[byte][(entry.key >> (byte * 8)) & 0xFF]++;
+		}
+
+		ScopedArena arena(FrameAllocator::getScratch());
+
+		Entry *src = this->entries.data();
+		Entry *dst = arena.allocate<Entry>(count);
+
+		for (uint32_t byte = 0; byte < 8; byte++)
+		{
+			uint32_t *histogram = histograms[byte];
+
+			// every key has the same value in this byte
+			if (histogram[(src[0].key >> (byte * 8)) & 0xFF] == count)
+				continue;
+
+			// exclusive prefix sum -> first output slot of every bucket
+			uint32_t offset = 0;
+			for (uint32_t bucket = 0; bucket < 256; bucket++)
+			{
+				uint32_t bucketCount = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += bucketCount;
+			}
+
+			for (size_t i = 0; i < count; i++)
+				dst[histogram[(src[i].key >> (byte * 8)) & 0xFF]++] = src[i];
+
+			std::swap(src, dst);
+		}
+
+		// odd number of scatter passes - the result lives in the scratch buffer
+		if (src != this->entries.data())
+			memcpy(this->entries.data(), src, count * sizeof(Entry));
+	}
+
+	void RenderQueue::clear()
+	{
+		this->commands.clear();
+		this->entries.clear();
+		this->culledCount = 0;
+	}
+
+}
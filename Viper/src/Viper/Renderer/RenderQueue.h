@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Viper/Core.h"
+#include "Viper/Scene/Bounds.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace Viper
+{
+
+	enum class RenderPassType : uint8_t
+	{
+		Opaque = 0, Transparent = 1
+	};
+
+	//*************** SortKey class ***************//
+	class VIPER_API SortKey
+	{
+		/*
+			Packed 64-bit draw key, most significant bits first:
+				[63..60] pass | [59..48] pipeline | [47..32] material | [31..0] depth
+
+			Sorting keys in ascending order groups draws by pass, then by pipeline and material (fewer state changes),
+			and inside one state bucket orders opaque draws front-to-back (less overdraw) and transparent draws back-to-front.
+		*/
+
+	public:
+		static constexpr uint32_t PassBits = 4;
+		static constexpr uint32_t PipelineBits = 12;
+		static constexpr uint32_t MaterialBits = 16;
+		static constexpr uint32_t DepthBits = 32;
+
+		static constexpr uint32_t DepthShift = 0;
+		static constexpr uint32_t MaterialShift = DepthShift + DepthBits;
+		static constexpr uint32_t PipelineShift = MaterialShift + MaterialBits;
+		static constexpr uint32_t PassShift = PipelineShift + PipelineBits;
+
+		static uint64_t encode(RenderPassType pass, uint32_t pipeline, uint32_t material, float depth);
+
+		inline static RenderPassType getPass(uint64_t key) { return (RenderPassType)(key >> PassShift); }
+		inline static uint32_t getPipeline(uint64_t key) { return (uint32_t)(key >> PipelineShift) & ((1u << PipelineBits) - 1); }
+		inline static uint32_t getMaterial(uint64_t key) { return (uint32_t)(key >> MaterialShift) & ((1u << MaterialBits) - 1); }
+	};
+
+
+	//*************** DrawCommand struct ***************//
+	struct DrawCommand
+	{
+		uint32_t pipeline = 0;
+		uint32_t material = 0;
+		uint32_t mesh = 0;
+
+		uint32_t indexCount = 0;
+		uint32_t firstIndex = 0;
+		int32_t vertexOffset = 0;
+
+		// object to world transform, handed to the vertex shader as a push constant
+		glm::mat4 transform = glm::mat4(1.0f);
+
+		// index into the world matrices of the frame (GraphicsContext::setTransforms), replaces 'transform' when set
+		static constexpr uint32_t NoTransform = ~0u;
+		uint32_t transformIndex = NoTransform;
+	};
+
+
+	//*************** RenderQueue class ***************//
+	class VIPER_API RenderQueue
+	{
+	public:
+		RenderQueue();
+
+		// depth is the normalized view depth of the draw ([0, 1], 0 = near plane)
+		void submit(RenderPassType pass, float depth, const DrawCommand &command);
+
+		// drops the draw when its world space bounds are outside of the cull frustum, returns whether it was queued
+		bool submit(RenderPassType pass, float depth, const DrawCommand &command, const AABB &bounds);
+
+		// frustum of the camera the queue is drawn with (kept up to date by the graphics context)
+		inline void setCullFrustum(const Frustum &frustum) { this->cullFrustum = frustum; }
+
+		// draws dropped by the frustum test since the last clear()
+		inline uint32_t getCulledCount() const { return this->culledCount; }
+
+		// radix sort of the submitted draws by their sort key, the temporary buffer comes from the calling thread's scratch arena
+		void sort();
+		void clear();
+
+		inline size_t size() const { return this->entries.size(); }
+		inline bool empty() const { return this->entries.empty(); }
+
+		// access in sorted order (valid after sort())
+		inline const DrawCommand &operator[](size_t i) const { return this->commands[this->entries[i].index]; }
+		inline uint64_t getKey(size_t i) const { return this->entries[i].key; }
+
+	private:
+		struct Entry
+		{
+			uint64_t key;
+			uint32_t index;
+		};
+
+		std::vector<DrawCommand> commands;
+		std::vector<Entry> entries;
+
+		Frustum cullFrustum;
+		uint32_t culledCount = 0;
+	};
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Viper
+{
+
+	//*************** RenderStats struct ***************//
+	struct RenderStats
+	{
+		/*
+			Per-frame counters filled while the render queue is recorded, and frame timings measured at present.
+			"Elided" counts binds that were skipped because the same object was already bound.
+		*/
+
+		uint32_t drawCalls = 0;
+		uint32_t indices = 0;
+
+		// draws dropped by the frustum test on submission
+		uint32_t drawsCulled = 0;
+
+		uint32_t pipelineBinds = 0;
+		uint32_t pipelineBindsElided = 0;
+
+		uint32_t descriptorSetBinds = 0;
+		uint32_t descriptorSetBindsElided = 0;
+
+		uint32_t vertexBufferBinds = 0;
+		uint32_t vertexBufferBindsElided = 0;
+
+		uint32_t indexBufferBinds = 0;
+		uint32_t indexBufferBindsElided = 0;
+
+		// milliseconds between the last two presents
+		float frameTime = 0.0f;
+
+		// milliseconds from the oldest input a frame reacted to until that frame was handed to the presentation engine
+		// (the last measured value - it is kept while there is no input)
+		float inputLatency = 0.0f;
+
+		// milliseconds the GPU spent on the frame (measured with timestamps, a few frames behind)
+		float gpuTime = 0.0f;
+
+		// milliseconds the render thread spent recording and submitting the frame
+		float renderThreadTime = 0.0f;
+
+		// bytes of device memory allocated by the context
+		uint64_t gpuMemory = 0;
+
+		// resolution the scene was rendered at before the upscale to the swap chain
+		float renderScale = 1.0f;
+		uint32_t renderWidth = 0;
+		uint32_t renderHeight = 0;
+
+		inline uint32_t getBindsIssued() const { return pipelineBinds + descriptorSetBinds + vertexBufferBinds + indexBufferBinds; }
+		inline uint32_t getBindsElided() const { return pipelineBindsElided + descriptorSetBindsElided + vertexBufferBindsElided + indexBufferBindsElided; }
+	};
+
+}
@@ -1,3 +1,5 @@
 C:\VulkanSDK\1.1.106.0\Bin32\glslangValidator.exe -V shader.vert
 C:\VulkanSDK\1.1.106.0\Bin32\glslangValidator.exe -V shader.frag
+C:\VulkanSDK\1.1.106.0\Bin32\glslangValidator.exe -V overlay.vert -o overlay_vert.spv
+C:\VulkanSDK\1.1.106.0\Bin32\glslangValidator.exe -V overlay.frag -o overlay_frag.spv
 pause
\ No newline at end of file
@@ -0,0 +1,20 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(location = 0) in vec2 fragCell;
+layout(location = 1) flat in vec4 fragColor;
+layout(location = 2) flat in uvec2 fragGlyph;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    // 5x7 glyph mask, bit (row * 5 + column)
+    ivec2 cell = clamp(ivec2(fragCell), ivec2(0), ivec2(4, 6));
+    uint bit = uint(cell.y * 5 + cell.x);
+    uint bits = bit < 32u ? fragGlyph.x : fragGlyph.y;
+
+    if (((bits >> (bit & 31u)) & 1u) == 0u)
+        discard;
+
+    outColor = fragColor;
+}
\ No newline at end of file
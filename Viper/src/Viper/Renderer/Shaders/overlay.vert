@@ -0,0 +1,23 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(push_constant) uniform OverlayData {
+    vec2 screenSize;
+} overlay;
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec2 inCell;
+layout(location = 2) in vec4 inColor;
+layout(location = 3) in uvec2 inGlyph;
+
+layout(location = 0) out vec2 fragCell;
+layout(location = 1) flat out vec4 fragColor;
+layout(location = 2) flat out uvec2 fragGlyph;
+
+void main() {
+    // pixels with the origin in the top-left corner -> clip space (y points down in Vulkan)
+    gl_Position = vec4(inPosition / overlay.screenSize * 2.0 - 1.0, 0.0, 1.0);
+    fragCell = inCell;
+    fragColor = inColor;
+    fragGlyph = inGlyph;
+}
\ No newline at end of file
@@ -1,12 +1,26 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
-layout(location = 0) in vec2 inPosition;
+layout(set = 0, binding = 0) uniform CameraData {
+    mat4 viewProjection;
+} camera;
+
+layout(set = 0, binding = 1) readonly buffer TransformData {
+    mat4 world[];
+} transforms;
+
+layout(push_constant) uniform ObjectData {
+    mat4 model;
+    uint transformIndex;
+} object;
+
+layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inColor;
 
 layout(location = 0) out vec3 fragColor;
 
 void main() {
-    gl_Position = vec4(inPosition, 0.0, 1.0);
+    mat4 model = object.transformIndex == 0xFFFFFFFFu ? object.model : transforms.world[object.transformIndex];
+    gl_Position = camera.viewProjection * model * vec4(inPosition, 1.0);
     fragColor = inColor;
 }
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "vpch.h"
+#include "Bounds.h"
+
+namespace Viper
+{
+
+	//*************** Ray struct ***************//
+
+	Ray::Ray(const glm::vec3 &origin, const glm::vec3 &direction)
+		: origin(origin), direction(glm::normalize(direction))
+	{
+		// an axis parallel ray divides by zero on purpose, the slab test works with the resulting infinities
+		this->inverseDirection = glm::vec3(1.0f) / this->direction;
+	}
+
+	Ray Ray::fromScreen(float x, float y, float width, float height, const glm::mat4 &inverseViewProjection)
+	{
+		float ndcX = 2.0f * (x + 0.5f) / width - 1.0f;
+		float ndcY = 2.0f * (y + 0.5f) / height - 1.0f;
+
+		glm::vec4 nearPoint = inverseViewProjection * glm::vec4(ndcX, ndcY, 0.0f, 1.0f);
+		glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+
+		glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+		glm::vec3 target = glm::vec3(farPoint) / farPoint.w;
+
+		return Ray(origin, target - origin);
+	}
+
+	bool Ray::intersects(const AABB &bounds, float maxDistance, float &distance) const
+	{
+		glm::vec3 t1 = (bounds.min - this->origin) * this->inverseDirection;
+		glm::vec3 t2 = (bounds.max - this->origin) * this->inverseDirection;
+
+		glm::vec3 tNear = glm::min(t1, t2);
+		glm::vec3 tFar = glm::max(t1, t2);
+
+		float entry = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+		float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+
+		if (entry > exit)
+			return false;
+
+		distance = entry;
+		return true;
+	}
+
+	bool Ray::intersectsPlane(const glm::vec3 &normal, float offset, float &distance) const
+	{
+		float denominator = glm::dot(normal, this->direction);
+
+		if (std::abs(denominator) < 1e-6f)
+			return false;
+
+		distance = (offset - glm::dot(normal, this->origin)) / denominator;
+		return distance >= 0.0f;
+	}
+
+
+
+	//*************** Frustum struct ***************//
+
+	Frustum Frustum::fromMatrix(const glm::mat4 &viewProjection)
+	{
+		/*
+			Gribb / Hartmann: a clip space point is inside when -w <= x <= w, -w <= y <= w and 0 <= z <= w,
+			every inequality is a plane formed from the rows of the (column major) matrix.
+		*/
+
+		glm::vec4 rows[4];
+		for (int i = 0; i < 4; i++)
+			rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+
+		Frustum frustum;
+		frustum.planes[0] = rows[3] + rows[0];
+		frustum.planes[1] = rows[3] - rows[0];
+		frustum.planes[2] = rows[3] + rows[1];
+		frustum.planes[3] = rows[3] - rows[1];
+		frustum.planes[4] = rows[2];
+		frustum.planes[5] = rows[3] - rows[2];
+
+		for (glm::vec4 &plane : frustum.planes)
+			plane = plane * (1.0f / glm::length(glm::vec3(plane)));
+
+		return frustum;
+	}
+
+	Frustum::Containment Frustum::test(const AABB &bounds) const
+	{
+		Containment result = Containment::Inside;
+
+		for (const glm::vec4 &plane : this->planes)
+		{
+			// corners furthest along / against the plane normal
+			glm::vec3 positive(plane.x >= 0.0f ? bounds.max.x : bounds.min.x, plane.y >= 0.0f ? bounds.max.y : bounds.min.y, plane.z >= 0.0f ? bounds.max.z : bounds.min.z);
+			glm::vec3 negative(plane.x >= 0.0f ? bounds.min.x : bounds.max.x, plane.y >= 0.0f ? bounds.min.y : bounds.max.y, plane.z >= 0.0f ? bounds.min.z : bounds.max.z);
+
+			if (glm::dot(glm::vec3(plane), positive) + plane.w < 0.0f)
+				return Containment::Outside;
+
+			if (glm::dot(glm::vec3(plane), negative) + plane.w < 0.0f)
+				result = Containment::Intersecting;
+		}
+
+		return result;
+	}
+
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Viper/Core.h"
+
+#include <glm/glm.hpp>
+
+namespace Viper
+{
+
+	//*************** AABB struct ***************//
+	struct AABB
+	{
+		glm::vec3 min = glm::vec3(0.0f);
+		glm::vec3 max = glm::vec3(0.0f);
+
+		AABB() = default;
+		AABB(const glm::vec3 &min, const glm::vec3 &max) : min(min), max(max) {}
+
+		inline glm::vec3 getCenter() const { return (this->min + this->max) * 0.5f; }
+		inline glm::vec3 getExtent() const { return this->max - this->min; }
+
+		// cost metric of the bounding volume hierarchy
+		inline float getSurfaceArea() const
+		{
+			glm::vec3 extent = this->max - this->min;
+			return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+		}
+
+		inline bool contains(const AABB &other) const
+		{
+			return this->min.x <= other.min.x && this->min.y <= other.min.y && this->min.z <= other.min.z &&
+				   other.max.x <= this->max.x && other.max.y <= this->max.y && other.max.z <= this->max.z;
+		}
+
+		inline bool overlaps(const AABB &other) const
+		{
+			return this->min.x <= other.max.x && other.min.x <= this->max.x &&
+				   this->min.y <= other.max.y && other.min.y <= this->max.y &&
+				   this->min.z <= other.max.z && other.min.z <= this->max.z;
+		}
+
+		inline AABB expanded(float margin) const { return AABB(this->min - glm::vec3(margin), this->max + glm::vec3(margin)); }
+
+		// box around the corners after an affine transform (e.g. object bounds to world space)
+		inline AABB transformed(const glm::mat4 &transform) const
+		{
+			glm::vec3 center = glm::vec3(transform * glm::vec4(this->getCenter(), 1.0f));
+			glm::vec3 halfExtent = this->getExtent() * 0.5f;
+
+			glm::vec3 extent = glm::abs(glm::vec3(transform[0])) * halfExtent.x +
+							   glm::abs(glm::vec3(transform[1])) * halfExtent.y +
+							   glm::abs(glm::vec3(transform[2])) * halfExtent.z;
+
+			return AABB(center - extent, center + extent);
+		}
+
+		inline static AABB merge(const AABB &a, const AABB &b) { return AABB(glm::min(a.min, b.min), glm::max(a.max, b.max)); }
+	};
+
+
+	//*************** Ray struct ***************//
+	struct VIPER_API Ray
+	{
+		glm::vec3 origin = glm::vec3(0.0f);
+		glm::vec3 direction = glm::vec3(0.0f, 0.0f, 1.0f);
+		glm::vec3 inverseDirection = glm::vec3(1.0f);
+
+		Ray() = default;
+		Ray(const glm::vec3 &origin, const glm::vec3 &direction);
+
+		/*
+			Picking ray through a window position (pixels, origin in the top-left corner).
+			The near and far plane points of the pixel center are unprojected with the inverse view projection (Vulkan clip space, depth [0, 1]).
+		*/
+		static Ray fromScreen(float x, float y, float width, float height, const glm::mat4 &inverseViewProjection);
+
+		inline glm::vec3 getPoint(float distance) const { return this->origin + this->direction * distance; }
+
+		// slab test, 'distance' is the entry distance (0 when the origin is inside)
+		bool intersects(const AABB &bounds, float maxDistance, float &distance) const;
+
+		// plane dot(normal, p) = offset
+		bool intersectsPlane(const glm::vec3 &normal, float offset, float &distance) const;
+	};
+
+
+	//*************** Frustum struct ***************//
+	struct VIPER_API Frustum
+	{
+		enum class Containment : uint8_t
+		{
+			Outside, Intersecting, Inside
+		};
+
+		// left, right, bottom, top, near, far - xyz is the inward normal, w the offset (inside: dot(xyz, p) + w >= 0)
+		glm::vec4 planes[6];
+
+		// planes of a view projection matrix (Vulkan clip space, depth [0, 1])
+		static Frustum fromMatrix(const glm::mat4 &viewProjection);
+
+		Containment test(const AABB &bounds) const;
+	};
+
+}
@@ -0,0 +1,445 @@
+#include "vpch.h"
+#include "SpatialIndex.h"
+
+#include "Viper/Debug/Profiler.h"
+#include "Viper/Jobs/JobSystem.h"
+
+namespace Viper
+{
+
+	// ranges with fewer leaves are built on the calling thread
+	#define SPATIAL_PARALLEL_BUILD_THRESHOLD 4096
+
+	// loose bounds are stretched by this multiple of the announced displacement
+	#define SPATIAL_DISPLACEMENT_MULTIPLIER 2.0f
+
+
+	//*************** SpatialIndex class ***************//
+
+	SpatialIndex::SpatialIndex(float margin)
+		: margin(margin)
+	{
+	}
+
+	uint32_t SpatialIndex::insert(const AABB &bounds, uint64_t userData)
+	{
+		uint32_t leaf = this->allocateNode();
+
+		Node &node = this->nodes[leaf];
+		node.bounds = bounds.expanded(this->margin);
+		node.userData = userData;
+		node.height = 0;
+
+		this->insertLeaf(leaf);
+		this->proxyCount++;
+
+		return leaf;
+	}
+
+	void SpatialIndex::remove(uint32_t proxy)
+	{
+		V_CORE_ASSERT(proxy < this->nodes.size() && this->nodes[proxy].height == 0, "invalid spatial index proxy!");
+
+		this->removeLeaf(proxy);
+		this->freeNode(proxy);
+		this->proxyCount--;
+	}
+
+	bool SpatialIndex::move(uint32_t proxy, const AABB &bounds, const glm::vec3 &displacement)
+	{
+		V_CORE_ASSERT(proxy < this->nodes.size() && this->nodes[proxy].height == 0, "invalid spatial index proxy!");
+
+		if (this->nodes[proxy].bounds.contains(bounds))
+			return false;
+
+		this->removeLeaf(proxy);
+
+		AABB loose = bounds.expanded(this->margin);
+		glm::vec3 stretch = displacement * SPATIAL_DISPLACEMENT_MULTIPLIER;
+		loose.min += glm::min(stretch, glm::vec3(0.0f));
+		loose.max += glm::max(stretch, glm::vec3(0.0f));
+
+		this->nodes[proxy].bounds = loose;
+		this->insertLeaf(proxy);
+
+		return true;
+	}
+
+	void SpatialIndex::rebuild()
+	{
+		V_PROFILE_FUNCTION();
+
+		if (this->root == NullProxy)
+			return;
+
+		// the leaves keep their ids, the inner nodes are reused: a binary tree of n leaves always has n - 1 of them
+		this->buildLeaves.clear();
+		this->buildInner.clear();
+
+		for (uint32_t i = 0; i < (uint32_t)this->nodes.size(); i++)
+		{
+			if (this->nodes[i].height == 0)
+				this->buildLeaves.push_back(i);
+			else if (this->nodes[i].height > 0)
+				this->buildInner.push_back(i);
+		}
+
+		bool parallel = JobSystem::getWorkerCount() > 0 && this->buildLeaves.size() >= SPATIAL_PARALLEL_BUILD_THRESHOLD;
+
+		this->root = this->buildRange(0, (uint32_t)this->buildLeaves.size(), parallel);
+		this->nodes[this->root].parent = NullProxy;
+	}
+
+	void SpatialIndex::clear()
+	{
+		this->nodes.clear();
+		this->root = NullProxy;
+		this->freeList = NullProxy;
+		this->proxyCount = 0;
+	}
+
+	float SpatialIndex::getAreaRatio() const
+	{
+		if (this->root == NullProxy)
+			return 0.0f;
+
+		float area = 0.0f;
+
+		for (const Node &node : this->nodes)
+		{
+			if (node.height > 0)
+				area += node.bounds.getSurfaceArea();
+		}
+
+		return area / this->nodes[this->root].bounds.getSurfaceArea();
+	}
+
+	uint32_t SpatialIndex::allocateNode()
+	{
+		if (this->freeList == NullProxy)
+		{
+			this->nodes.emplace_back();
+			return (uint32_t)this->nodes.size() - 1;
+		}
+
+		uint32_t index = this->freeList;
+		this->freeList = this->nodes[index].parent;
+		this->nodes[index] = Node();
+
+		return index;
+	}
+
+	void SpatialIndex::freeNode(uint32_t index)
+	{
+		Node &node = this->nodes[index];
+		node.height = -1;
+		node.left = NullProxy;
+		node.right = NullProxy;
+		node.parent = this->freeList;
+
+		this->freeList = index;
+	}
+
+	void SpatialIndex::insertLeaf(uint32_t leaf)
+	{
+		if (this->root == NullProxy)
+		{
+			this->root = leaf;
+			this->nodes[leaf].parent = NullProxy;
+			return;
+		}
+
+		// descend towards the sibling with the lowest cost: the area of the new parent plus the growth of every ancestor
+		AABB bounds = this->nodes[leaf].bounds;
+		uint32_t index = this->root;
+
+		while (!this->nodes[index].isLeaf())
+		{
+			const Node &node = this->nodes[index];
+
+			float area = node.bounds.getSurfaceArea();
+			float combinedArea = AABB::merge(node.bounds, bounds).getSurfaceArea();
+
+			// pairing with this node, or the minimum cost pushed down to the children
+			float cost = 2.0f * combinedArea;
+			float inheritance = 2.0f * (combinedArea - area);
+
+			float costs[2];
+			uint32_t children[2] = { node.left, node.right };
+
+			for (int i = 0; i < 2; i++)
+			{
+				const Node &child = this->nodes[children[i]];
+				float childArea = AABB::merge(child.bounds, bounds).getSurfaceArea();
+
+				costs[i] = (child.isLeaf() ? childArea : childArea - child.bounds.getSurfaceArea()) + inheritance;
+			}
+
+			if (cost < costs[0] && cost < costs[1])
+				break;
+
+			index = costs[0] < costs[1] ? children[0] : children[1];
+		}
+
+		uint32_t sibling = index;
+		uint32_t oldParent = this->nodes[sibling].parent;
+
+		// may grow the node array, no references across it
+		uint32_t newParent = this->allocateNode();
+
+		Node &parent = this->nodes[newParent];
+		parent.parent = oldParent;
+		parent.bounds = AABB::merge(bounds, this->nodes[sibling].bounds);
+		parent.height = this->nodes[sibling].height + 1;
+		parent.left = sibling;
+		parent.right = leaf;
+
+		if (oldParent != NullProxy)
+		{
+			if (this->nodes[oldParent].left == sibling)
+				this->nodes[oldParent].left = newParent;
+			else
+				this->nodes[oldParent].right = newParent;
+		}
+		else
+			this->root = newParent;
+
+		this->nodes[sibling].parent = newParent;
+		this->nodes[leaf].parent = newParent;
+
+		this->refitAncestors(newParent);
+	}
+
+	void SpatialIndex::removeLeaf(uint32_t leaf)
+	{
+		if (leaf == this->root)
+		{
+			this->root = NullProxy;
+			return;
+		}
+
+		uint32_t parent = this->nodes[leaf].parent;
+		uint32_t grandParent = this->nodes[parent].parent;
+		uint32_t sibling = this->nodes[parent].left == leaf ? this->nodes[parent].right : this->nodes[parent].left;
+
+		// the sibling takes the place of the parent
+		this->nodes[sibling].parent = grandParent;
+		this->freeNode(parent);
+
+		if (grandParent == NullProxy)
+		{
+			this->root = sibling;
+			return;
+		}
+
+		if (this->nodes[grandParent].left == parent)
+			this->nodes[grandParent].left = sibling;
+		else
+			this->nodes[grandParent].right = sibling;
+
+		this->refitAncestors(grandParent);
+	}
+
+	void SpatialIndex::refitAncestors(uint32_t index)
+	{
+		while (index != NullProxy)
+		{
+			index = this->balance(index);
+
+			Node &node = this->nodes[index];
+			const Node &left = this->nodes[node.left];
+			const Node &right = this->nodes[node.right];
+
+			node.height = 1 + std::max(left.height, right.height);
+			node.bounds = AABB::merge(left.bounds, right.bounds);
+
+			index = node.parent;
+		}
+	}
+
+	uint32_t SpatialIndex::balance(uint32_t indexA)
+	{
+		/*
+			       A                 C
+			      / \               / \
+			     B   C     ->      A   F|G
+			        / \           / \
+			       F   G         B   G|F
+
+			The higher child replaces A, A keeps the lower grandchild (mirrored when B is the higher one).
+		*/
+
+		Node &a = this->nodes[indexA];
+
+		if (a.isLeaf() || a.height < 2)
+			return indexA;
+
+		uint32_t indexB = a.left;
+		uint32_t indexC = a.right;
+		Node &b = this->nodes[indexB];
+		Node &c = this->nodes[indexC];
+
+		int32_t difference = c.height - b.height;
+
+		if (difference > 1)
+		{
+			uint32_t indexF = c.left;
+			uint32_t indexG = c.right;
+			Node &f = this->nodes[indexF];
+			Node &g = this->nodes[indexG];
+
+			c.left = indexA;
+			c.parent = a.parent;
+			a.parent = indexC;
+
+			if (c.parent != NullProxy)
+			{
+				if (this->nodes[c.parent].left == indexA)
+					this->nodes[c.parent].left = indexC;
+				else
+					this->nodes[c.parent].right = indexC;
+			}
+			else
+				this->root = indexC;
+
+			if (f.height > g.height)
+			{
+				c.right = indexF;
+				a.right = indexG;
+				g.parent = indexA;
+
+				a.bounds = AABB::merge(b.bounds, g.bounds);
+				c.bounds = AABB::merge(a.bounds, f.bounds);
+				a.height = 1 + std::max(b.height, g.height);
+				c.height = 1 + std::max(a.height, f.height);
+			}
+			else
+			{
+				c.right = indexG;
+				a.right = indexF;
+				f.parent = indexA;
+
+				a.bounds = AABB::merge(b.bounds, f.bounds);
+				c.bounds = AABB::merge(a.bounds, g.bounds);
+				a.height = 1 + std::max(b.height, f.height);
+				c.height = 1 + std::max(a.height, g.height);
+			}
+
+			return indexC;
+		}
+
+		if (difference < -1)
+		{
+			uint32_t indexD = b.left;
+			uint32_t indexE = b.right;
+			Node &d = this->nodes[indexD];
+			Node &e = this->nodes[indexE];
+
+			b.left = indexA;
+			b.parent = a.parent;
+			a.parent = indexB;
+
+			if (b.parent != NullProxy)
+			{
+				if (this->nodes[b.parent].left == indexA)
+					this->nodes[b.parent].left = indexB;
+				else
+					this->nodes[b.parent].right = indexB;
+			}
+			else
+				this->root = indexB;
+
+			if (d.height > e.height)
+			{
+				b.right = indexD;
+				a.left = indexE;
+				e.parent = indexA;
+
+				a.bounds = AABB::merge(c.bounds, e.bounds);
+				b.bounds = AABB::merge(a.bounds, d.bounds);
+				a.height = 1 + std::max(c.height, e.height);
+				b.height = 1 + std::max(a.height, d.height);
+			}
+			else
+			{
+				b.right = indexE;
+				a.left = indexD;
+				d.parent = indexA;
+
+				a.bounds = AABB::merge(c.bounds, d.bounds);
+				b.bounds = AABB::merge(a.bounds, e.bounds);
+				a.height = 1 + std::max(c.height, d.height);
+				b.height = 1 + std::max(a.height, e.height);
+			}
+
+			return indexB;
+		}
+
+		return indexA;
+	}
+
+	uint32_t SpatialIndex::buildRange(uint32_t begin, uint32_t end, bool parallel)
+	{
+		if (end - begin == 1)
+			return this->buildLeaves[begin];
+
+		uint32_t *leaves = this->buildLeaves.data();
+
+		// split along the widest axis of the leaf centers
+		glm::vec3 centerMin = this->nodes[leaves[begin]].bounds.getCenter();
+		glm::vec3 centerMax = centerMin;
+
+		for (uint32_t i = begin + 1; i < end; i++)
+		{
+			glm::vec3 center = this->nodes[leaves[i]].bounds.getCenter();
+			centerMin = glm::min(centerMin, center);
+			centerMax = glm::max(centerMax, center);
+		}
+
+		glm::vec3 extent = centerMax - centerMin;
+		int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+
+		uint32_t middle = begin + (end - begin) / 2;
+
+		std::nth_element(leaves + begin, leaves + middle, leaves + end, [this, axis](uint32_t a, uint32_t b)
+		{
+			const AABB &first = this->nodes[a].bounds;
+			const AABB &second = this->nodes[b].bounds;
+			return first.min[axis] + first.max[axis] < second.min[axis] + second.max[axis];
+		});
+
+		/*
+			Every split position of the leaf array is used by exactly one inner node,
+			so the position picks the inner node - the parallel halves never share one.
+		*/
+		uint32_t index = this->buildInner[middle - 1];
+		uint32_t left, right;
+
+		if (parallel && end - begin >= SPATIAL_PARALLEL_BUILD_THRESHOLD)
+		{
+			JobCounter counter(0);
+			JobSystem::run([this, begin, middle, &left]() { left = this->buildRange(begin, middle, true); }, &counter);
+
+			right = this->buildRange(middle, end, true);
+			JobSystem::wait(counter);
+		}
+		else
+		{
+			left = this->buildRange(begin, middle, false);
+			right = this->buildRange(middle, end, false);
+		}
+
+		Node &node = this->nodes[index];
+		node.left = left;
+		node.right = right;
+		node.bounds = AABB::merge(this->nodes[left].bounds, this->nodes[right].bounds);
+		node.height = 1 + std::max(this->nodes[left].height, this->nodes[right].height);
+		node.userData = 0;
+
+		this->nodes[left].parent = index;
+		this->nodes[right].parent = index;
+
+		return index;
+	}
+
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+#include "Viper/Core.h"
+#include "Viper/Scene/Bounds.h"
+
+#include <vector>
+
+namespace Viper
+{
+
+	//*************** SpatialIndex class ***************//
+	class VIPER_API SpatialIndex
+	{
+		/*
+			Dynamic bounding volume hierarchy for culling and picking.
+
+			Every object is a leaf (its proxy id stays valid until remove()) holding a "loose" copy of its bounds grown by a margin.
+			Objects that move inside their loose bounds cost nothing, the ones that leave it are re-inserted: the leaf is taken out,
+			the best sibling is picked by the surface area heuristic and the ancestors are refit and rebalanced (AVL rotations) on the
+			way back up, so the tree stays O(log n) deep without a full rebuild.
+
+			rebuild() recreates all inner nodes top down (median split along the widest axis of the centroids), the two halves of
+			large ranges are built in parallel on the job system. Useful after a bulk insert or after a lot of movement.
+
+			Queries walk the tree with a fixed stack and call back with the proxy id. Not thread safe, queries are safe to run
+			concurrently as long as nothing modifies the index.
+		*/
+
+	public:
+		static constexpr uint32_t NullProxy = ~0u;
+		static constexpr uint32_t StackSize = 256;
+
+		explicit SpatialIndex(float margin = 0.1f);
+
+		uint32_t insert(const AABB &bounds, uint64_t userData = 0);
+		void remove(uint32_t proxy);
+
+		/*
+			Updates the bounds of a moving object, returns true when the proxy had to be re-inserted.
+			The loose bounds are additionally stretched along 'displacement' (the expected movement until the next update).
+		*/
+		bool move(uint32_t proxy, const AABB &bounds, const glm::vec3 &displacement = glm::vec3(0.0f));
+
+		void rebuild();
+		void clear();
+
+		inline uint64_t getUserData(uint32_t proxy) const { return this->nodes[proxy].userData; }
+		inline const AABB &getBounds(uint32_t proxy) const { return this->nodes[proxy].bounds; }
+
+		inline uint32_t size() const { return this->proxyCount; }
+		inline uint32_t getHeight() const { return this->root == NullProxy ? 0 : (uint32_t)this->nodes[this->root].height; }
+
+		// summed surface area of the inner nodes relative to the root, lower is better
+		float getAreaRatio() const;
+
+		// callback(proxy) -> bool, return false to stop the query
+		template<typename F>
+		void queryAABB(const AABB &bounds, F &&callback) const;
+
+		// callback(proxy) -> bool, leaves of fully visible subtrees are reported without further plane tests
+		template<typename F>
+		void queryFrustum(const Frustum &frustum, F &&callback) const;
+
+		/*
+			Closest hit along the ray, returns the proxy (or NullProxy) and writes its distance.
+			callback(proxy, maxDistance) -> float does the exact test against the object, it returns the hit distance or a negative
+			value for a miss. Nodes further away than the closest hit so far are skipped.
+		*/
+		template<typename F>
+		uint32_t raycast(const Ray &ray, float maxDistance, float &distance, F &&callback) const;
+
+	private:
+		struct Node
+		{
+			AABB bounds;
+			uint64_t userData = 0;
+
+			// next free node while in the free list
+			uint32_t parent = NullProxy;
+			uint32_t left = NullProxy;
+			uint32_t right = NullProxy;
+
+			// 0 for leaves, -1 for free nodes
+			int32_t height = -1;
+
+			inline bool isLeaf() const { return this->left == NullProxy; }
+		};
+
+		uint32_t allocateNode();
+		void freeNode(uint32_t index);
+
+		void insertLeaf(uint32_t leaf);
+		void removeLeaf(uint32_t leaf);
+
+		// refits the bounds and heights from 'index' up to the root, rotating unbalanced nodes
+		void refitAncestors(uint32_t index);
+		uint32_t balance(uint32_t index);
+
+		uint32_t buildRange(uint32_t begin, uint32_t end, bool parallel);
+
+	private:
+		std::vector<Node> nodes;
+		uint32_t root = NullProxy;
+		uint32_t freeList = NullProxy;
+		uint32_t proxyCount = 0;
+
+		float margin;
+
+		// rebuild() scratch
+		std::vector<uint32_t> buildLeaves;
+		std::vector<uint32_t> buildInner;
+	};
+
+
+	template<typename F>
+	void SpatialIndex::queryAABB(const AABB &bounds, F &&callback) const
+	{
+		if (this->root == NullProxy)
+			return;
+
+		uint32_t stack[StackSize];
+		uint32_t count = 0;
+		stack[count++] = this->root;
+
+		while (count > 0)
+		{
+			uint32_t index = stack[--count];
+			const Node &node = this->nodes[index];
+
+			if (!node.bounds.overlaps(bounds))
+				continue;
+
+			if (node.isLeaf())
+			{
+				if (!callback(index))
+					return;
+
+				continue;
+			}
+
+			V_CORE_ASSERT(count + 2 <= StackSize, "spatial index query stack overflow!");
+			stack[count++] = node.left;
+			stack[count++] = node.right;
+		}
+	}
+
+	template<typename F>
+	void SpatialIndex::queryFrustum(const Frustum &frustum, F &&callback) const
+	{
+		if (this->root == NullProxy)
+			return;
+
+		// the top bit marks nodes inside the frustum
+		constexpr uint32_t InsideBit = 1u << 31;
+
+		uint32_t stack[StackSize];
+		uint32_t count = 0;
+		stack[count++] = this->root;
+
+		while (count > 0)
+		{
+			uint32_t entry = stack[--count];
+			uint32_t index = entry & ~InsideBit;
+			uint32_t inside = entry & InsideBit;
+
+			const Node &node = this->nodes[index];
+
+			if (!inside)
+			{
+				Frustum::Containment containment = frustum.test(node.bounds);
+
+				if (containment == Frustum::Containment::Outside)
+					continue;
+
+				if (containment == Frustum::Containment::Inside)
+					inside = InsideBit;
+			}
+
+			if (node.isLeaf())
+			{
+				if (!callback(index))
+					return;
+
+				continue;
+			}
+
+			V_CORE_ASSERT(count + 2 <= StackSize, "spatial index query stack overflow!");
+			stack[count++] = node.left | inside;
+			stack[count++] = node.right | inside;
+		}
+	}
+
+	template<typename F>
+	uint32_t SpatialIndex::raycast(const Ray &ray, float maxDistance, float &distance, F &&callback) const
+	{
+		uint32_t hit = NullProxy;
+		distance = maxDistance;
+
+		if (this->root == NullProxy)
+			return hit;
+
+		uint32_t stack[StackSize];
+		uint32_t count = 0;
+		stack[count++] = this->root;
+
+		while (count > 0)
+		{
+			uint32_t index = stack[--count];
+			const Node &node = this->nodes[index];
+
+			float entry;
+			if (!ray.intersects(node.bounds, distance, entry))
+				continue;
+
+			if (node.isLeaf())
+			{
+				float result = callback(index, distance);
+
+				if (result >= 0.0f && result <= distance)
+				{
+					distance = result;
+					hit = index;
+				}
+
+				continue;
+			}
+
+			// visit the nearer child first, a close hit prunes the other one
+			float leftEntry = 0.0f, rightEntry = 0.0f;
+			bool leftHit = ray.intersects(this->nodes[node.left].bounds, distance, leftEntry);
+			bool rightHit = ray.intersects(this->nodes[node.right].bounds, distance, rightEntry);
+
+			V_CORE_ASSERT(count + 2 <= StackSize, "spatial index query stack overflow!");
+
+			if (leftHit && rightHit)
+			{
+				stack[count++] = leftEntry < rightEntry ? node.right : node.left;
+				stack[count++] = leftEntry < rightEntry ? node.left : node.right;
+			}
+			else if (leftHit)
+				stack[count++] = node.left;
+			else if (rightHit)
+				stack[count++] = node.right;
+		}
+
+		return hit;
+	}
+
+}
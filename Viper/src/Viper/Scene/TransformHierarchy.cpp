@@ -0,0 +1,334 @@
+#include "vpch.h"
+#include "TransformHierarchy.h"
+
+#include "Viper/Debug/Profiler.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+	#include <xmmintrin.h>
+	#define TRANSFORM_SSE
+#endif
+
+namespace Viper
+{
+
+	//*************** TransformHierarchy class ***************//
+
+	TransformHandle TransformHierarchy::create(const Transform &local, TransformHandle parent)
+	{
+		uint32_t parentIndex = InvalidIndex;
+
+		if (!parent.isNull())
+		{
+			V_CORE_ASSERT(this->isValid(parent), "parent transform doesn't exist!");
+			parentIndex = parent.index;
+		}
+
+		uint32_t index;
+
+		if (!this->freeNodes.empty())
+		{
+			index = this->freeNodes.back();
+			this->freeNodes.pop_back();
+		}
+		else
+		{
+			index = (uint32_t)this->nodes.size();
+			this->nodes.emplace_back();
+		}
+
+		Node &node = this->nodes[index];
+		node.alive = true;
+		node.dense = (uint32_t)this->worlds.size();
+		this->link(index, parentIndex);
+
+		// appending keeps the order valid, the parent already sits before the new node
+		this->locals.push_back(local);
+		this->worlds.push_back(glm::mat4(1.0f));
+		this->parents.push_back(parentIndex == InvalidIndex ? InvalidIndex : this->nodes[parentIndex].dense);
+		this->dirty.push_back(1);
+
+		return { index, node.generation };
+	}
+
+	void TransformHierarchy::destroy(TransformHandle handle)
+	{
+		if (!this->getNode(handle))
+			return;
+
+		this->unlink(handle.index);
+
+		// the subtree is detached now, walk it depth first through the child / sibling links
+		this->order.clear();
+		this->order.push_back(handle.index);
+
+		while (!this->order.empty())
+		{
+			uint32_t index = this->order.back();
+			this->order.pop_back();
+
+			Node &node = this->nodes[index];
+
+			for (uint32_t child = node.firstChild; child != InvalidIndex; child = this->nodes[child].nextSibling)
+				this->order.push_back(child);
+
+			uint32_t generation = node.generation + 1;
+			node = Node();
+			node.generation = generation;
+
+			this->freeNodes.push_back(index);
+		}
+
+		this->orderDirty = true;
+	}
+
+	void TransformHierarchy::setParent(TransformHandle handle, TransformHandle parent)
+	{
+		Node *node = this->getNode(handle);
+		V_CORE_ASSERT(node, "transform doesn't exist!");
+
+		uint32_t parentIndex = InvalidIndex;
+
+		if (!parent.isNull())
+		{
+			V_CORE_ASSERT(this->isValid(parent), "parent transform doesn't exist!");
+
+			for (uint32_t ancestor = parent.index; ancestor != InvalidIndex; ancestor = this->nodes[ancestor].parent)
+				V_CORE_ASSERT(ancestor != handle.index, "a transform can't become a child of its own subtree!");
+
+			parentIndex = parent.index;
+		}
+
+		if (node->parent == parentIndex)
+			return;
+
+		this->unlink(handle.index);
+		this->link(handle.index, parentIndex);
+
+		this->dirty[node->dense] = 1;
+		this->orderDirty = true;
+	}
+
+	TransformHandle TransformHierarchy::getParent(TransformHandle handle) const
+	{
+		const Node *node = this->getNode(handle);
+
+		if (!node || node->parent == InvalidIndex)
+			return TransformHandle();
+
+		return { node->parent, this->nodes[node->parent].generation };
+	}
+
+	void TransformHierarchy::setLocal(TransformHandle handle, const Transform &local)
+	{
+		const Node *node = this->getNode(handle);
+		V_CORE_ASSERT(node, "transform doesn't exist!");
+
+		this->locals[node->dense] = local;
+		this->dirty[node->dense] = 1;
+	}
+
+	const Transform &TransformHierarchy::getLocal(TransformHandle handle) const
+	{
+		const Node *node = this->getNode(handle);
+		V_CORE_ASSERT(node, "transform doesn't exist!");
+
+		return this->locals[node->dense];
+	}
+
+	const glm::mat4 &TransformHierarchy::getWorld(TransformHandle handle) const
+	{
+		const Node *node = this->getNode(handle);
+		V_CORE_ASSERT(node, "transform doesn't exist!");
+
+		return this->worlds[node->dense];
+	}
+
+	uint32_t TransformHierarchy::getIndex(TransformHandle handle) const
+	{
+		const Node *node = this->getNode(handle);
+		return node ? node->dense : InvalidIndex;
+	}
+
+	bool TransformHierarchy::isValid(TransformHandle handle) const
+	{
+		return this->getNode(handle) != nullptr;
+	}
+
+	void TransformHierarchy::update()
+	{
+		V_PROFILE_FUNCTION();
+
+		if (this->orderDirty)
+			this->rebuildOrder();
+
+		uint32_t count = (uint32_t)this->worlds.size();
+		uint32_t updated = 0;
+
+		uint8_t *dirty = this->dirty.data();
+		const uint32_t *parents = this->parents.data();
+		const Transform *locals = this->locals.data();
+		glm::mat4 *worlds = this->worlds.data();
+
+		// parents come first - their flag already tells whether the world matrix changed in this pass
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint32_t parent = parents[i];
+
+			if (parent != InvalidIndex)
+				dirty[i] |= dirty[parent];
+
+			if (!dirty[i])
+				continue;
+
+			if (parent == InvalidIndex)
+				worlds[i] = TransformHierarchy::compose(locals[i]);
+			else
+				TransformHierarchy::multiply(worlds[parent], TransformHierarchy::compose(locals[i]), worlds[i]);
+
+			updated++;
+		}
+
+		memset(dirty, 0, count);
+		this->updatedCount = updated;
+	}
+
+	void TransformHierarchy::multiply(const glm::mat4 &a, const glm::mat4 &b, glm::mat4 &out)
+	{
+	#ifdef TRANSFORM_SSE
+		// column major: out[c] = a[0] * b[c].x + a[1] * b[c].y + a[2] * b[c].z + a[3] * b[c].w
+		__m128 a0 = _mm_loadu_ps(&a[0][0]);
+		__m128 a1 = _mm_loadu_ps(&a[1][0]);
+		__m128 a2 = _mm_loadu_ps(&a[2][0]);
+		__m128 a3 = _mm_loadu_ps(&a[3][0]);
+
+		__m128 columns[4];
+
+		for (int c = 0; c < 4; c++)
+		{
+			__m128 column = _mm_loadu_ps(&b[c][0]);
+
+			__m128 result = _mm_mul_ps(a0, _mm_shuffle_ps(column, column, _MM_SHUFFLE(0, 0, 0, 0)));
+			result = _mm_add_ps(result, _mm_mul_ps(a1, _mm_shuffle_ps(column, column, _MM_SHUFFLE(1, 1, 1, 1))));
+			result = _mm_add_ps(result, _mm_mul_ps(a2, _mm_shuffle_ps(column, column, _MM_SHUFFLE(2, 2, 2, 2))));
+			result = _mm_add_ps(result, _mm_mul_ps(a3, _mm_shuffle_ps(column, column, _MM_SHUFFLE(3, 3, 3, 3))));
+
+			columns[c] = result;
+		}
+
+		for (int c = 0; c < 4; c++)
+			_mm_storeu_ps(&out[c][0], columns[c]);
+	#else
+		out = a * b;
+	#endif
+	}
+
+	glm::mat4 TransformHierarchy::compose(const Transform &transform)
+	{
+		// translation * rotation * scale without the two full matrix products
+		glm::mat3 rotation = glm::mat3_cast(transform.rotation);
+
+		glm::mat4 matrix;
+		matrix[0] = glm::vec4(rotation[0] * transform.scale.x, 0.0f);
+		matrix[1] = glm::vec4(rotation[1] * transform.scale.y, 0.0f);
+		matrix[2] = glm::vec4(rotation[2] * transform.scale.z, 0.0f);
+		matrix[3] = glm::vec4(transform.position, 1.0f);
+
+		return matrix;
+	}
+
+	TransformHierarchy::Node *TransformHierarchy::getNode(TransformHandle handle)
+	{
+		if (handle.index >= this->nodes.size())
+			return nullptr;
+
+		Node &node = this->nodes[handle.index];
+
+		if (!node.alive || node.generation != handle.generation)
+			return nullptr;
+
+		return &node;
+	}
+
+	const TransformHierarchy::Node *TransformHierarchy::getNode(TransformHandle handle) const
+	{
+		return const_cast<TransformHierarchy*>(this)->getNode(handle);
+	}
+
+	void TransformHierarchy::link(uint32_t index, uint32_t parent)
+	{
+		Node &node = this->nodes[index];
+		uint32_t &first = parent == InvalidIndex ? this->firstRoot : this->nodes[parent].firstChild;
+
+		node.parent = parent;
+		node.previousSibling = InvalidIndex;
+		node.nextSibling = first;
+
+		if (first != InvalidIndex)
+			this->nodes[first].previousSibling = index;
+
+		first = index;
+	}
+
+	void TransformHierarchy::unlink(uint32_t index)
+	{
+		Node &node = this->nodes[index];
+
+		if (node.previousSibling != InvalidIndex)
+			this->nodes[node.previousSibling].nextSibling = node.nextSibling;
+		else if (node.parent != InvalidIndex)
+			this->nodes[node.parent].firstChild = node.nextSibling;
+		else
+			this->firstRoot = node.nextSibling;
+
+		if (node.nextSibling != InvalidIndex)
+			this->nodes[node.nextSibling].previousSibling = node.previousSibling;
+
+		node.parent = InvalidIndex;
+		node.previousSibling = InvalidIndex;
+		node.nextSibling = InvalidIndex;
+	}
+
+	void TransformHierarchy::rebuildOrder()
+	{
+		V_PROFILE_FUNCTION();
+
+		// breadth first: the roots, then all their children, then the grandchildren...
+		this->order.clear();
+
+		for (uint32_t root = this->firstRoot; root != InvalidIndex; root = this->nodes[root].nextSibling)
+			this->order.push_back(root);
+
+		for (size_t i = 0; i < this->order.size(); i++)
+		{
+			for (uint32_t child = this->nodes[this->order[i]].firstChild; child != InvalidIndex; child = this->nodes[child].nextSibling)
+				this->order.push_back(child);
+		}
+
+		size_t count = this->order.size();
+
+		this->sortedLocals.resize(count);
+		this->sortedWorlds.resize(count);
+		this->sortedDirty.resize(count);
+		this->parents.resize(count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			Node &node = this->nodes[this->order[i]];
+
+			this->sortedLocals[i] = this->locals[node.dense];
+			this->sortedWorlds[i] = this->worlds[node.dense];
+			this->sortedDirty[i] = this->dirty[node.dense];
+
+			// the parent was visited earlier, its dense index is already the new one
+			node.dense = (uint32_t)i;
+			this->parents[i] = node.parent == InvalidIndex ? InvalidIndex : this->nodes[node.parent].dense;
+		}
+
+		this->locals.swap(this->sortedLocals);
+		this->worlds.swap(this->sortedWorlds);
+		this->dirty.swap(this->sortedDirty);
+
+		this->orderDirty = false;
+	}
+
+}
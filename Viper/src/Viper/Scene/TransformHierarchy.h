@@ -0,0 +1,125 @@
+#pragma once
+
+#include "Viper/Core.h"
+#include "Viper/Memory/Handle.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <vector>
+
+namespace Viper
+{
+
+	//*************** Transform struct ***************//
+	struct Transform
+	{
+		// relative to the parent (or to the world for a root)
+		glm::vec3 position = glm::vec3(0.0f);
+		glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+		glm::vec3 scale = glm::vec3(1.0f);
+	};
+
+	using TransformHandle = Handle<Transform>;
+
+
+	//*************** TransformHierarchy class ***************//
+	class VIPER_API TransformHierarchy
+	{
+		/*
+			Scene graph of local transforms and their world matrices.
+
+			The tree itself lives in per-handle nodes (parent / first child / siblings), the transform data in arrays sorted
+			breadth first, so every parent comes before its children. update() is then one linear pass: a node is recomputed
+			when its local transform changed or its parent was recomputed in the same pass, untouched subtrees cost a flag test.
+			Structural changes (create / destroy / setParent) only mark the order stale, the arrays are re-sorted once in update().
+
+			The world matrices are contiguous, getWorldMatrices() can be handed to GraphicsContext::setTransforms() as a whole
+			and a draw refers to its matrix with getIndex(). Not thread safe.
+		*/
+
+	public:
+		static constexpr uint32_t InvalidIndex = ~0u;
+
+		TransformHierarchy() = default;
+
+		TransformHierarchy(const TransformHierarchy &) = delete;
+		TransformHierarchy &operator=(const TransformHierarchy &) = delete;
+
+		TransformHandle create(const Transform &local = Transform(), TransformHandle parent = TransformHandle());
+
+		// destroys the whole subtree
+		void destroy(TransformHandle handle);
+
+		// a null parent makes the node a root, the local transform is kept
+		void setParent(TransformHandle handle, TransformHandle parent);
+		TransformHandle getParent(TransformHandle handle) const;
+
+		void setLocal(TransformHandle handle, const Transform &local);
+		const Transform &getLocal(TransformHandle handle) const;
+
+		// valid after update()
+		const glm::mat4 &getWorld(TransformHandle handle) const;
+
+		// position of the world matrix in getWorldMatrices(), changes with structural changes (valid after update())
+		uint32_t getIndex(TransformHandle handle) const;
+
+		bool isValid(TransformHandle handle) const;
+
+		void update();
+
+		inline const glm::mat4 *getWorldMatrices() const { return this->worlds.data(); }
+		inline uint32_t size() const { return (uint32_t)this->worlds.size(); }
+
+		// world matrices recomputed by the last update()
+		inline uint32_t getUpdatedCount() const { return this->updatedCount; }
+
+		// out = a * b with SSE when available, out may alias a or b
+		static void multiply(const glm::mat4 &a, const glm::mat4 &b, glm::mat4 &out);
+		static glm::mat4 compose(const Transform &transform);
+
+	private:
+		struct Node
+		{
+			uint32_t parent = InvalidIndex;
+			uint32_t firstChild = InvalidIndex;
+			uint32_t previousSibling = InvalidIndex;
+			uint32_t nextSibling = InvalidIndex;
+
+			uint32_t dense = InvalidIndex;
+			uint32_t generation = 1;
+			bool alive = false;
+		};
+
+		Node *getNode(TransformHandle handle);
+		const Node *getNode(TransformHandle handle) const;
+
+		void link(uint32_t index, uint32_t parent);
+		void unlink(uint32_t index);
+
+		// breadth first re-sort of the dense arrays
+		void rebuildOrder();
+
+	private:
+		// per handle index
+		std::vector<Node> nodes;
+		std::vector<uint32_t> freeNodes;
+		uint32_t firstRoot = InvalidIndex;
+
+		// dense, breadth first once the order is up to date (stale entries of destroyed nodes are dropped by the re-sort)
+		std::vector<Transform> locals;
+		std::vector<glm::mat4> worlds;
+		std::vector<uint32_t> parents;
+		std::vector<uint8_t> dirty;
+
+		// re-sort buffers, kept to avoid allocations
+		std::vector<uint32_t> order;
+		std::vector<Transform> sortedLocals;
+		std::vector<glm::mat4> sortedWorlds;
+		std::vector<uint8_t> sortedDirty;
+
+		bool orderDirty = false;
+		uint32_t updatedCount = 0;
+	};
+
+}
@@ -8,14 +8,27 @@
 namespace Viper
 {
 
+	enum class PresentMode
+	{
+		VSync = 0,		// tear free, finished frames queue up behind the vertical blank
+		NoVSync,		// frames are shown immediately, lowest latency but may tear
+		Mailbox,		// tear free, a new frame replaces the one waiting for the vertical blank
+		LowLatency		// lowest latency mode available, minimal swap chain image count and a single frame queued
+	};
+
 	struct WindowProperties
 	{
 		std::string title;
 		uint16_t width;
 		uint16_t height;
 
-		WindowProperties(const std::string &title = "Viper Engine", uint16_t width = 1280, uint16_t height = 720)
-			: title(title), width(width), height(height) { }
+		PresentMode presentMode;
+		uint16_t frameRateLimit;	// frames per second, 0 = unlimited
+		bool rawMouseMotion;		// see Window::setRawMouseMotion
+
+		WindowProperties(const std::string &title = "Viper Engine", uint16_t width = 1280, uint16_t height = 720,
+						 PresentMode presentMode = PresentMode::Mailbox, uint16_t frameRateLimit = 0, bool rawMouseMotion = false)
+			: title(title), width(width), height(height), presentMode(presentMode), frameRateLimit(frameRateLimit), rawMouseMotion(rawMouseMotion) { }
 	};
 
 	class VIPER_API Window
@@ -30,10 +43,24 @@ namespace Viper
 		virtual uint16_t getWidth() const = 0;
 		virtual uint16_t getHeight() const = 0;
 		virtual bool getFramebufferResizeState() const = 0;
+		virtual PresentMode getPresentMode() const = 0;
+		virtual uint16_t getFrameRateLimit() const = 0;
 
 		virtual void setEventCallback(const eventCallbackFunc &callback) = 0;
 		virtual void setFramebufferResizeState(bool framebufferResized) = 0;
 
+		// presentation policy can be changed at runtime, the swap chain is recreated before the next frame
+		virtual void setPresentMode(PresentMode presentMode) = 0;
+		virtual void setFrameRateLimit(uint16_t framesPerSecond) = 0;
+
+		/*
+			Captures the cursor and reads unaccelerated motion where the platform supports it. The motion reaches the
+			application only through the per-frame samples of the input snapshot (Input::getMouseDelta, InputSnapshot::motion),
+			no MouseMovedEvents are sent while it is on.
+		*/
+		virtual void setRawMouseMotion(bool enabled) = 0;
+		virtual bool isRawMouseMotion() const = 0;
+
 		virtual void *getNativeWindow() const = 0;
 		virtual void *getContextHandle() const = 0;
 
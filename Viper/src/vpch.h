@@ -8,6 +8,7 @@
 #include <sstream>
 
 #include <vector>
+#include <array>
 #include <string>
 #include <set>
 #include <optional>
@@ -0,0 +1,273 @@
+#include "vpch.h"
+#include "Bench.h"
+
+#include <chrono>
+#include <cmath>
+#include <map>
+
+namespace ViperBench
+{
+
+	static double percentile(const std::vector<double> &sorted, double p)
+	{
+		// nearest rank
+		size_t rank = (size_t)std::ceil(p * sorted.size());
+		return sorted[std::min(std::max(rank, (size_t)1), sorted.size()) - 1];
+	}
+
+	static bool readNumber(const std::string &line, const char *key, double &value)
+	{
+		size_t pos = line.find(key);
+
+		if (pos == std::string::npos)
+			return false;
+
+		value = std::strtod(line.c_str() + pos + strlen(key), nullptr);
+		return true;
+	}
+
+	static bool readString(const std::string &line, const char *key, std::string &value)
+	{
+		size_t pos = line.find(key);
+
+		if (pos == std::string::npos)
+			return false;
+
+		size_t start = line.find('"', pos + strlen(key));
+		size_t end = line.find('"', start + 1);
+
+		if (start == std::string::npos || end == std::string::npos)
+			return false;
+
+		value = line.substr(start + 1, end - start - 1);
+		return true;
+	}
+
+
+
+	//*************** BenchResult struct ***************//
+
+	void BenchResult::summarize()
+	{
+		if (this->samples.empty())
+			return;
+
+		std::sort(this->samples.begin(), this->samples.end());
+
+		double sum = 0.0;
+		for (double sample : this->samples)
+			sum += sample;
+
+		this->min = this->samples.front();
+		this->max = this->samples.back();
+		this->mean = sum / this->samples.size();
+		this->p50 = percentile(this->samples, 0.5);
+		this->p90 = percentile(this->samples, 0.9);
+		this->p99 = percentile(this->samples, 0.99);
+	}
+
+
+
+	//*************** BenchSuite class ***************//
+
+	void BenchSuite::add(const Benchmark &benchmark)
+	{
+		this->benchmarks.push_back(benchmark);
+	}
+
+	void BenchSuite::run(const std::string &filter, bool gpu)
+	{
+		for (const Benchmark &benchmark : this->benchmarks)
+		{
+			if (!filter.empty() && benchmark.name.find(filter) == std::string::npos)
+				continue;
+
+			if (benchmark.gpu && !gpu)
+			{
+				V_INFO("{0}: skipped (needs --gpu)", benchmark.name);
+				continue;
+			}
+
+			if (benchmark.setup)
+				benchmark.setup();
+
+			BenchResult result;
+			result.name = benchmark.name;
+			result.unit = benchmark.unit;
+			result.samples.reserve(benchmark.samples);
+
+			bool failed = false;
+
+			for (uint32_t i = 0; i < benchmark.warmup + benchmark.samples && !failed; i++)
+			{
+				double sample = benchmark.sample();
+				failed = std::isnan(sample);
+
+				if (i >= benchmark.warmup)
+					result.samples.push_back(sample);
+			}
+
+			if (benchmark.teardown)
+				benchmark.teardown();
+
+			// a failed benchmark has no result, it must not end up in the percentiles or the baseline comparison
+			if (failed)
+			{
+				V_ERROR("{0}: failed, a sample could not be taken", benchmark.name);
+				this->failures++;
+				continue;
+			}
+
+			result.summarize();
+
+			if (benchmark.report)
+				benchmark.report(result);
+
+			V_INFO("{0:<40} p50 {1:>12.3f}  p90 {2:>12.3f}  p99 {3:>12.3f}  {4}", result.name, result.p50, result.p90, result.p99, result.unit);
+
+			for (const auto &counter : result.counters)
+				V_INFO("{0:<40} {1:>16.3f}  {2}", "", counter.second, counter.first);
+
+			this->results.push_back(std::move(result));
+		}
+	}
+
+	void BenchSuite::writeJson(const std::string &filename) const
+	{
+		/*
+			One result per line, compare() reads the file back line by line.
+		*/
+
+		std::ofstream file(filename);
+
+		if (!file.is_open())
+		{
+			V_ERROR("Could not write {0}", filename);
+			return;
+		}
+
+		file << "{\n";
+#if defined(V_DEBUG)
+		file << "\t\"config\": \"Debug\",\n";
+#elif defined(V_RELEASE)
+		file << "\t\"config\": \"Release\",\n";
+#else
+		file << "\t\"config\": \"Dist\",\n";
+#endif
+		file << "\t\"results\":\n\t[\n";
+
+		char line[512];
+		char counter[128];
+
+		for (size_t i = 0; i < this->results.size(); i++)
+		{
+			const BenchResult &result = this->results[i];
+
+			snprintf(line, sizeof(line),
+					 "\t\t{ \"name\": \"%s\", \"unit\": \"%s\", \"samples\": %zu, \"min\": %.4f, \"mean\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f",
+					 result.name.c_str(), result.unit.c_str(), result.samples.size(), result.min, result.mean,
+					 result.p50, result.p90, result.p99, result.max);
+
+			file << line;
+
+			for (const auto &entry : result.counters)
+			{
+				snprintf(counter, sizeof(counter), ", \"%s\": %.4f", entry.first.c_str(), entry.second);
+				file << counter;
+			}
+
+			file << " }" << (i + 1 < this->results.size() ? "," : "") << "\n";
+		}
+
+		file << "\t]\n}\n";
+
+		V_INFO("Results written to {0}", filename);
+	}
+
+	uint32_t BenchSuite::compare(const std::string &baselineFile, double threshold) const
+	{
+		/*
+			Medians are compared, they are the least sensitive to the odd slow sample.
+			Every unit is "lower is better" except throughput units ending in "/s".
+		*/
+
+		std::ifstream file(baselineFile);
+
+		if (!file.is_open())
+		{
+			V_ERROR("Could not read baseline {0}", baselineFile);
+			return 0;
+		}
+
+		std::map<std::string, double> baseline;
+		std::string line;
+
+		while (std::getline(file, line))
+		{
+			std::string name;
+			double p50;
+
+			if (readString(line, "\"name\":", name) && readNumber(line, "\"p50\":", p50))
+				baseline[name] = p50;
+		}
+
+		uint32_t regressions = 0;
+
+		for (const BenchResult &result : this->results)
+		{
+			auto it = baseline.find(result.name);
+
+			if (it == baseline.end() || it->second == 0.0)
+			{
+				V_INFO("{0:<40} no baseline", result.name);
+				continue;
+			}
+
+			bool higherIsBetter = result.unit.size() >= 2 && result.unit.compare(result.unit.size() - 2, 2, "/s") == 0;
+			double change = (result.p50 - it->second) / it->second;
+			double slowdown = higherIsBetter ? -change : change;
+
+			if (slowdown > threshold)
+			{
+				V_ERROR("{0:<40} REGRESSION {1:+.1f}% ({2:.3f} -> {3:.3f} {4})", result.name, change * 100.0, it->second, result.p50, result.unit);
+				regressions++;
+			}
+			else
+			{
+				V_INFO("{0:<40} {1:+.1f}%", result.name, change * 100.0);
+			}
+		}
+
+		return regressions;
+	}
+
+
+
+	//*************** BenchTimer class ***************//
+
+	static int64_t nowNanoseconds()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	BenchTimer::BenchTimer()
+	{
+		this->reset();
+	}
+
+	void BenchTimer::reset()
+	{
+		this->start = nowNanoseconds();
+	}
+
+	double BenchTimer::elapsedSeconds() const
+	{
+		return (nowNanoseconds() - this->start) * 1e-9;
+	}
+
+	double BenchTimer::elapsedNanoseconds() const
+	{
+		return (double)(nowNanoseconds() - this->start);
+	}
+
+}
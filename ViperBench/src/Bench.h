@@ -0,0 +1,138 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Viper
+{
+	class Window;
+}
+
+namespace ViperBench
+{
+
+	// every scenario generates its input from this seed, so runs see identical work
+	constexpr uint32_t BenchSeed = 0x5EED1234;
+
+	//*************** BenchResult struct ***************//
+	struct BenchResult
+	{
+		std::string name;
+		std::string unit;
+
+		std::vector<double> samples;
+
+		double min = 0.0;
+		double mean = 0.0;
+		double p50 = 0.0;
+		double p90 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+
+		// extra per-benchmark figures (e.g. hardware counters per operation), written next to the statistics
+		std::vector<std::pair<std::string, double>> counters;
+
+		// sorts the samples and fills the statistics
+		void summarize();
+	};
+
+
+	//*************** Benchmark struct ***************//
+	struct Benchmark
+	{
+		/*
+			One scenario: setup, warmup samples that are thrown away, measured samples, teardown.
+			sample() runs a fixed amount of work and returns the measured value in unit, so runs are
+			comparable between machines only through the baseline of the same machine.
+			A sample that can't be taken returns NaN, the benchmark then fails and produces no result.
+		*/
+
+		std::string name;
+		std::string unit;
+
+		uint32_t samples = 30;
+		uint32_t warmup = 3;
+
+		// needs a window and a GPU (skipped unless the suite runs with --gpu)
+		bool gpu = false;
+
+		std::function<void()> setup;
+		std::function<double()> sample;
+		std::function<void()> teardown;
+
+		// adds extra figures to the result after the samples are taken
+		std::function<void(BenchResult &result)> report;
+	};
+
+
+	//*************** BenchSuite class ***************//
+	class BenchSuite
+	{
+	public:
+		void add(const Benchmark &benchmark);
+
+		// runs every benchmark whose name contains filter (all for an empty filter)
+		void run(const std::string &filter, bool gpu);
+
+		void writeJson(const std::string &filename) const;
+
+		// compares the medians against a JSON file written by a previous run,
+		// returns the number of benchmarks that got slower by more than threshold (0.1 = 10%)
+		uint32_t compare(const std::string &baselineFile, double threshold) const;
+
+		inline const std::vector<BenchResult> &getResults() const { return this->results; }
+		inline uint32_t getFailureCount() const { return this->failures; }
+
+	private:
+		std::vector<Benchmark> benchmarks;
+		std::vector<BenchResult> results;
+		uint32_t failures = 0;
+	};
+
+
+	//*************** BenchTimer class ***************//
+	class BenchTimer
+	{
+	public:
+		BenchTimer();
+
+		void reset();
+
+		double elapsedSeconds() const;
+		double elapsedNanoseconds() const;
+
+	private:
+		int64_t start;
+	};
+
+	// keeps the compiler from optimizing away a computed value
+	template<typename T>
+	inline void doNotOptimize(const T &value)
+	{
+		const volatile char *sink = reinterpret_cast<const volatile char *>(&value);
+		(void)*sink;
+	}
+
+
+	//*************** Scenarios ***************//
+	void registerECSBenchmarks(BenchSuite &suite);
+	void registerEventBenchmarks(BenchSuite &suite);
+	void registerFrameBenchmarks(BenchSuite &suite);
+	void registerJobBenchmarks(BenchSuite &suite);
+	void registerLayerBenchmarks(BenchSuite &suite);
+	void registerLogBenchmarks(BenchSuite &suite);
+	void registerRenderBenchmarks(BenchSuite &suite);
+	void registerSpatialBenchmarks(BenchSuite &suite);
+	void registerTransformBenchmarks(BenchSuite &suite);
+	void registerWindowBenchmarks(BenchSuite &suite);
+	void setReplayFile(const std::string &filename);
+	void registerMicroBenchmarks(BenchSuite &suite);
+
+	// window shared by the scenarios that need one, created on first use
+	Viper::Window *getBenchWindow();
+
+	// destroys the window of the GPU scenarios (if one was created)
+	void shutdownWindowBenchmarks();
+
+}
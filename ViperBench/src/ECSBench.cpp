@@ -0,0 +1,184 @@
+#include "vpch.h"
+#include "Bench.h"
+
+#include "Viper/ECS/World.h"
+#include "Viper/Jobs/JobSystem.h"
+
+#include <memory>
+
+namespace ViperBench
+{
+
+	#define ECS_ENTITIES 1000000
+	#define ECS_STRUCTURAL_CHANGES 100000
+	#define ECS_DELTA_TIME (1.0f / 60.0f)
+
+	using namespace Viper;
+
+	struct Position
+	{
+		float x = 0.0f, y = 0.0f, z = 0.0f;
+	};
+
+	struct Velocity
+	{
+		float x = 0.0f, y = 0.0f, z = 0.0f;
+	};
+
+	// splits the entities over two archetypes, queries have to walk both
+	struct Sleeping
+	{
+	};
+
+	static std::unique_ptr<World> world;
+
+	static void populateWorld()
+	{
+		world = std::make_unique<World>();
+
+		for (uint32_t i = 0; i < ECS_ENTITIES; i++)
+		{
+			float value = (float)(i % 1024);
+			Entity entity = world->create(Position{ value, 0.0f, -value }, Velocity{ 1.0f, value * 0.01f, 0.5f });
+
+			if (i % 2)
+				world->add<Sleeping>(entity);
+		}
+	}
+
+	static Benchmark makeUpdateBenchmark(const std::string &name, double (*update)())
+	{
+		Benchmark benchmark;
+		benchmark.name = name;
+		benchmark.unit = "ms";
+		benchmark.samples = 20;
+		benchmark.setup = populateWorld;
+		benchmark.sample = update;
+		benchmark.teardown = []() { world.reset(); };
+
+		return benchmark;
+	}
+
+	void registerECSBenchmarks(BenchSuite &suite)
+	{
+		//////////////////// Creating (and destroying with the world) 1M entities with two components
+		Benchmark create;
+		create.name = "ecs/create_destroy_1m";
+		create.unit = "ns/entity";
+		create.samples = 10;
+		create.sample = []()
+		{
+			BenchTimer timer;
+
+			World createWorld;
+			for (uint32_t i = 0; i < ECS_ENTITIES; i++)
+				createWorld.create(Position{ (float)i, 0.0f, 0.0f }, Velocity());
+
+			doNotOptimize(createWorld.getEntityCount());
+			return timer.elapsedNanoseconds() / ECS_ENTITIES;
+		};
+		suite.add(create);
+
+		//////////////////// Integrating the positions of 1M entities
+		suite.add(makeUpdateBenchmark("ecs/update_each_1m", []()
+		{
+			BenchTimer timer;
+
+			world->each<Position, Velocity>([](Entity, Position &position, const Velocity &velocity)
+			{
+				position.x += velocity.x * ECS_DELTA_TIME;
+				position.y += velocity.y * ECS_DELTA_TIME;
+				position.z += velocity.z * ECS_DELTA_TIME;
+			});
+
+			return timer.elapsedNanoseconds() * 1e-6;
+		}));
+
+		suite.add(makeUpdateBenchmark("ecs/update_chunks_1m", []()
+		{
+			BenchTimer timer;
+
+			world->query<Position, Velocity>().eachChunk<Position, Velocity>([](uint32_t count, const Entity *, Position *positions, const Velocity *velocities)
+			{
+				for (uint32_t i = 0; i < count; i++)
+				{
+					positions[i].x += velocities[i].x * ECS_DELTA_TIME;
+					positions[i].y += velocities[i].y * ECS_DELTA_TIME;
+					positions[i].z += velocities[i].z * ECS_DELTA_TIME;
+				}
+			});
+
+			return timer.elapsedNanoseconds() * 1e-6;
+		}));
+
+		Benchmark parallel = makeUpdateBenchmark("ecs/update_parallel_1m", []()
+		{
+			BenchTimer timer;
+
+			world->query<Position, Velocity>().parallelEach<Position, Velocity>([](Entity, Position &position, const Velocity &velocity)
+			{
+				position.x += velocity.x * ECS_DELTA_TIME;
+				position.y += velocity.y * ECS_DELTA_TIME;
+				position.z += velocity.z * ECS_DELTA_TIME;
+			}, 4);
+
+			return timer.elapsedNanoseconds() * 1e-6;
+		});
+		parallel.setup = []()
+		{
+			JobSystem::init();
+			populateWorld();
+		};
+		parallel.teardown = []()
+		{
+			world.reset();
+			JobSystem::shutdown();
+		};
+		suite.add(parallel);
+
+		//////////////////// Structural changes: moving rows between archetypes directly and through a command buffer
+		suite.add(makeUpdateBenchmark("ecs/add_remove_component_100k", []()
+		{
+			std::vector<Entity> entities;
+			entities.reserve(ECS_STRUCTURAL_CHANGES);
+
+			world->query<Position>(ComponentRegistry::getMask<Sleeping>()).each<Position>([&entities](Entity entity, Position &)
+			{
+				if (entities.size() < ECS_STRUCTURAL_CHANGES)
+					entities.push_back(entity);
+			});
+
+			BenchTimer timer;
+
+			for (Entity entity : entities)
+				world->add<Sleeping>(entity);
+
+			for (Entity entity : entities)
+				world->remove<Sleeping>(entity);
+
+			return timer.elapsedNanoseconds() * 1e-6;
+		}));
+
+		suite.add(makeUpdateBenchmark("ecs/command_buffer_100k", []()
+		{
+			BenchTimer timer;
+
+			CommandBuffer &commands = world->getCommandBuffer();
+			uint32_t recorded = 0;
+
+			world->query<Position>(ComponentRegistry::getMask<Sleeping>()).each<Position>([&commands, &recorded](Entity entity, Position &)
+			{
+				if (recorded++ < ECS_STRUCTURAL_CHANGES)
+				{
+					commands.destroy(entity);
+					commands.add<Position>(commands.create(), Position{ 1.0f, 2.0f, 3.0f });
+				}
+			});
+
+			world->flush();
+
+			return timer.elapsedNanoseconds() * 1e-6;
+		}));
+	}
+
+}
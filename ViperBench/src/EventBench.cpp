@@ -0,0 +1,195 @@
+#include "vpch.h"
+#include "Bench.h"
+
+#include "Viper/Events/ApplicationEvent.h"
+#include "Viper/Events/KeyEvent.h"
+#include "Viper/Events/MouseEvent.h"
+#include "Viper/Events/EventQueue.h"
+#include "Viper/Events/EventBus.h"
+
+#include <random>
+#include <thread>
+
+namespace ViperBench
+{
+
+	#define EVENTS_PER_SAMPLE 100000
+	#define EVENT_BUS_PRODUCERS 4
+
+	using namespace Viper;
+
+	// input-like stream: mostly mouse moves, some keys and clicks, the odd resize
+	static std::vector<QueuedEvent> generateEvents(uint32_t count)
+	{
+		std::mt19937 random(BenchSeed);
+		std::vector<QueuedEvent> events(count);
+
+		for (QueuedEvent &event : events)
+		{
+			uint32_t roll = random() % 100;
+
+			if (roll < 60)
+			{
+				event.type = EventType::MouseMoved;
+				event.position = { (float)(random() % 1280), (float)(random() % 720) };
+			}
+			else if (roll < 85)
+			{
+				event.type = roll < 75 ? EventType::KeyPressed : EventType::KeyReleased;
+				event.key = { (uint16_t)(32 + random() % 64), 0 };
+			}
+			else if (roll < 98)
+			{
+				event.type = roll < 92 ? EventType::MouseButtonPressed : EventType::MouseButtonReleased;
+				event.button = { (uint16_t)(random() % 3) };
+			}
+			else
+			{
+				event.type = EventType::WindowResize;
+				event.size = { (uint16_t)(640 + random() % 640), (uint16_t)(360 + random() % 360) };
+			}
+		}
+
+		return events;
+	}
+
+	// handlers that do a little work, like the application's handlers
+	static uint64_t handledSum = 0;
+
+	static bool onKeyPressed(KeyPressedEvent &e) { handledSum += e.getKeyCode(); return false; }
+	static bool onKeyReleased(KeyReleasedEvent &e) { handledSum += e.getKeyCode(); return false; }
+	static bool onMouseMoved(MouseMovedEvent &e) { handledSum += (uint64_t)e.getX(); return false; }
+	static bool onMouseButtonPressed(MouseButtonPressedEvent &e) { handledSum += e.getMouseButton(); return false; }
+	static bool onMouseButtonReleased(MouseButtonReleasedEvent &e) { handledSum += e.getMouseButton(); return false; }
+	static bool onWindowResize(WindowResizeEvent &e) { handledSum += e.getWidth(); return false; }
+
+	void registerEventBenchmarks(BenchSuite &suite)
+	{
+		static std::vector<QueuedEvent> events = generateEvents(EVENTS_PER_SAMPLE);
+
+		//////////////////// Handler table (application handlers)
+		static EventHandlerTable table;
+		table.bind<KeyPressedEvent, &onKeyPressed>();
+		table.bind<KeyReleasedEvent, &onKeyReleased>();
+		table.bind<MouseMovedEvent, &onMouseMoved>();
+		table.bind<MouseButtonPressedEvent, &onMouseButtonPressed>();
+		table.bind<MouseButtonReleasedEvent, &onMouseButtonReleased>();
+		table.bind<WindowResizeEvent, &onWindowResize>();
+
+		Benchmark handlerTable;
+		handlerTable.name = "events/handler_table";
+		handlerTable.unit = "ns/event";
+		handlerTable.sample = []()
+		{
+			BenchTimer timer;
+
+			for (const QueuedEvent &event : events)
+				EventQueue::dispatchEvent(event, [](Event &e) { table.dispatch(e); });
+
+			doNotOptimize(handledSum);
+			return timer.elapsedNanoseconds() / EVENTS_PER_SAMPLE;
+		};
+		suite.add(handlerTable);
+
+		//////////////////// EventDispatcher chain (layer handlers)
+		Benchmark dispatcher;
+		dispatcher.name = "events/dispatcher_chain";
+		dispatcher.unit = "ns/event";
+		dispatcher.sample = []()
+		{
+			BenchTimer timer;
+
+			for (const QueuedEvent &event : events)
+			{
+				EventQueue::dispatchEvent(event, [](Event &e)
+				{
+					EventDispatcher dispatcher(e);
+					dispatcher.dispatch<KeyPressedEvent>(onKeyPressed);
+					dispatcher.dispatch<KeyReleasedEvent>(onKeyReleased);
+					dispatcher.dispatch<MouseMovedEvent>(onMouseMoved);
+					dispatcher.dispatch<MouseButtonPressedEvent>(onMouseButtonPressed);
+					dispatcher.dispatch<MouseButtonReleasedEvent>(onMouseButtonReleased);
+					dispatcher.dispatch<WindowResizeEvent>(onWindowResize);
+				});
+			}
+
+			doNotOptimize(handledSum);
+			return timer.elapsedNanoseconds() / EVENTS_PER_SAMPLE;
+		};
+		suite.add(dispatcher);
+
+		//////////////////// Window path: record into the queue, dispatch once per frame
+		static EventQueue queue;
+
+		Benchmark queued;
+		queued.name = "events/queue_push_dispatch";
+		queued.unit = "ns/event";
+		queued.sample = []()
+		{
+			BenchTimer timer;
+
+			for (const QueuedEvent &event : events)
+			{
+				switch (event.type)
+				{
+				case EventType::MouseMoved:				queue.pushMouseMoved(event.position.x, event.position.y); break;
+				case EventType::KeyPressed:				queue.pushKeyPressed(event.key.keyCode, event.key.repeatCount); break;
+				case EventType::KeyReleased:			queue.pushKeyReleased(event.key.keyCode); break;
+				case EventType::MouseButtonPressed:		queue.pushMouseButtonPressed(event.button.button); break;
+				case EventType::MouseButtonReleased:	queue.pushMouseButtonReleased(event.button.button); break;
+				case EventType::WindowResize:			queue.pushWindowResize(event.size.width, event.size.height); break;
+				default: break;
+				}
+			}
+
+			queue.dispatch([](Event &e) { table.dispatch(e); });
+
+			doNotOptimize(handledSum);
+			return timer.elapsedNanoseconds() / EVENTS_PER_SAMPLE;
+		};
+		suite.add(queued);
+
+		//////////////////// Event bus, several producer threads and the draining main thread
+		static EventBus bus(EVENTS_PER_SAMPLE);
+
+		Benchmark busThroughput;
+		busThroughput.name = "events/bus_mpsc";
+		busThroughput.unit = "Mevents/s";
+		busThroughput.sample = []()
+		{
+			std::atomic<bool> start{ false };
+			std::vector<std::thread> producers;
+
+			for (uint32_t p = 0; p < EVENT_BUS_PRODUCERS; p++)
+			{
+				producers.emplace_back([&start, p]()
+				{
+					while (!start.load(std::memory_order_acquire))
+						std::this_thread::yield();
+
+					for (uint32_t i = p; i < EVENTS_PER_SAMPLE; i += EVENT_BUS_PRODUCERS)
+					{
+						while (!bus.post(events[i]))
+							std::this_thread::yield();
+					}
+				});
+			}
+
+			BenchTimer timer;
+			start.store(true, std::memory_order_release);
+
+			size_t drained = 0;
+			while (drained < EVENTS_PER_SAMPLE)
+				drained += bus.drain([](Event &e) { table.dispatch(e); });
+
+			double seconds = timer.elapsedSeconds();
+
+			for (std::thread &producer : producers)
+				producer.join();
+
+			return EVENTS_PER_SAMPLE / seconds * 1e-6;
+		};
+		suite.add(busThroughput);
+	}
+
+}
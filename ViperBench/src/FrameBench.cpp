@@ -0,0 +1,178 @@
+#include "vpch.h"
+#include "Bench.h"
+
+#include "Viper/LayerStack.h"
+#include "Viper/ECS/World.h"
+#include "Viper/Events/EventQueue.h"
+#include "Viper/Renderer/RenderQueue.h"
+#include "Viper/Renderer/OverlayBatch.h"
+#include "Viper/Jobs/JobSystem.h"
+#include "Viper/Memory/FrameAllocator.h"
+#include "Viper/Memory/HeapStats.h"
+
+#include <memory>
+
+namespace ViperBench
+{
+
+	#define FRAME_PARTICLES 20000
+	#define FRAME_WARMUP_FRAMES 120
+	#define FRAME_TIMESTEP (1.0f / 60.0f)
+
+	using namespace Viper;
+
+	struct FramePosition
+	{
+		float x = 0.0f, y = 0.0f;
+	};
+
+	struct FrameVelocity
+	{
+		float x = 0.0f, y = 0.0f;
+	};
+
+	struct FrameLifetime
+	{
+		float remaining = 0.0f;
+	};
+
+	//*************** ParticleLayer class ***************//
+	class ParticleLayer : public Layer
+	{
+		/*
+			The game's particle layer: a parallel update, expired particles replaced through command buffers,
+			one draw per particle submitted to the render queue.
+		*/
+
+	public:
+		ParticleLayer(RenderQueue &queue)
+			: Layer("Bench particles"), queue(queue)
+		{
+			for (uint32_t i = 0; i < FRAME_PARTICLES; i++)
+				this->world.create(FramePosition(), FrameVelocity{ (float)(i % 7) - 3.0f, 2.0f }, FrameLifetime{ 0.1f + (i % 5) * 0.1f });
+		}
+
+		void onUpdate() override
+		{
+			this->world.query<FramePosition, FrameVelocity>().parallelEach<FramePosition, FrameVelocity>([](Entity, FramePosition &position, const FrameVelocity &velocity)
+			{
+				position.x += velocity.x * FRAME_TIMESTEP;
+				position.y += velocity.y * FRAME_TIMESTEP;
+			}, 4);
+
+			World *world = &this->world;
+
+			this->world.query<FrameLifetime>().parallelEach<FrameLifetime>([world](Entity entity, FrameLifetime &lifetime)
+			{
+				lifetime.remaining -= FRAME_TIMESTEP;
+
+				if (lifetime.remaining <= 0.0f)
+				{
+					CommandBuffer &commands = world->getCommandBuffer();
+					commands.destroy(entity);
+
+					Entity particle = commands.create();
+					commands.add<FramePosition>(particle);
+					commands.add<FrameVelocity>(particle, FrameVelocity{ (float)(entity.index % 7) - 3.0f, 2.0f });
+					commands.add<FrameLifetime>(particle, FrameLifetime{ 0.1f + (entity.index % 5) * 0.1f });
+				}
+			}, 4);
+
+			this->world.flush();
+
+			RenderQueue &queue = this->queue;
+
+			this->world.query<FramePosition>().each<FramePosition>([&queue](Entity entity, const FramePosition &position)
+			{
+				DrawCommand draw;
+				draw.material = entity.index & 63;
+				draw.indexCount = 3;
+				draw.transform[3] = glm::vec4(position.x, position.y, 0.0f, 1.0f);
+
+				queue.submit(RenderPassType::Opaque, (position.y + 100.0f) * 0.001f, draw);
+			});
+		}
+
+	private:
+		World world;
+		RenderQueue &queue;
+	};
+
+	static struct
+	{
+		std::unique_ptr<LayerStack> layers;
+		std::unique_ptr<RenderQueue> queue;
+		std::unique_ptr<EventQueue> events;
+		std::unique_ptr<OverlayBatch> overlay;
+		uint64_t frame = 0;
+	} frameBench;
+
+	// everything the main thread does in a frame of the game, without the window and the GPU
+	static void runFrame()
+	{
+		FrameAllocator::beginFrame();
+
+		float cursor = (float)(frameBench.frame++ % 640);
+		frameBench.events->pushMouseMoved(cursor, cursor * 0.5f);
+		frameBench.events->pushMouseMoved(cursor + 1.0f, cursor * 0.5f);
+		frameBench.events->pushKeyPressed(32, 0);
+		frameBench.events->pushKeyReleased(32);
+
+		uint32_t dispatched = 0;
+		frameBench.events->dispatch([&dispatched](Event &) { dispatched++; });
+
+		frameBench.layers->update();
+		frameBench.queue->sort();
+
+		char line[64];
+		snprintf(line, sizeof(line), "DRAWS %u  EVENTS %u", (uint32_t)frameBench.queue->size(), dispatched);
+		frameBench.overlay->drawText(8.0f, 8.0f, line, OverlayBatch::packColor(1.0f, 1.0f, 1.0f), 2.0f);
+
+		doNotOptimize(frameBench.queue->getKey(0));
+
+		frameBench.queue->clear();
+		frameBench.overlay->clear();
+	}
+
+	void registerFrameBenchmarks(BenchSuite &suite)
+	{
+		//////////////////// Heap allocations of the main thread in a steady state frame - has to stay at zero
+		Benchmark steadyState;
+		steadyState.name = "frame/steady_state_allocations";
+		steadyState.unit = "allocs/frame";
+		steadyState.setup = []()
+		{
+			JobSystem::init();
+
+			frameBench.queue = std::make_unique<RenderQueue>();
+			frameBench.events = std::make_unique<EventQueue>();
+			frameBench.overlay = std::make_unique<OverlayBatch>();
+			frameBench.layers = std::make_unique<LayerStack>();
+			frameBench.layers->emplaceLayer<ParticleLayer>(*frameBench.queue);
+			frameBench.frame = 0;
+
+			// the containers grow to their working size, every particle expires at least once
+			for (uint32_t i = 0; i < FRAME_WARMUP_FRAMES; i++)
+				runFrame();
+		};
+		steadyState.sample = []()
+		{
+			uint64_t allocations = HeapStats::getThreadAllocationCount();
+			runFrame();
+			allocations = HeapStats::getThreadAllocationCount() - allocations;
+
+			V_CORE_ASSERT(allocations == 0, "a steady state frame allocated from the heap!");
+			return (double)allocations;
+		};
+		steadyState.teardown = []()
+		{
+			frameBench.layers.reset();
+			frameBench.queue.reset();
+			frameBench.events.reset();
+			frameBench.overlay.reset();
+			JobSystem::shutdown();
+		};
+		suite.add(steadyState);
+	}
+
+}
@@ -0,0 +1,113 @@
+#include "vpch.h"
+#include "Bench.h"
+
+#include "Viper/Jobs/JobSystem.h"
+
+#include <cmath>
+#include <random>
+#include <thread>
+
+namespace ViperBench
+{
+
+	#define JOB_WORK_ITEMS (1 << 20)
+	#define JOB_BATCH_SIZE 1024
+	#define EMPTY_JOBS_PER_SAMPLE 4000
+
+	using namespace Viper;
+
+	static std::vector<float> input;
+	static std::vector<float> output;
+
+	// fixed amount of arithmetic per item, enough for the batches to outweigh the scheduling
+	static void processItem(uint32_t i)
+	{
+		float value = input[i];
+
+		for (uint32_t step = 0; step < 16; step++)
+			value = std::sqrt(value * value + 1.0f) * 0.5f;
+
+		output[i] = value;
+	}
+
+	void registerJobBenchmarks(BenchSuite &suite)
+	{
+		//////////////////// parallelFor scaling over 1..N threads (main thread + workers)
+		uint32_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+
+		for (uint32_t threads = 1; ; threads = std::min(threads * 2, maxThreads))
+		{
+			Benchmark scaling;
+			scaling.name = "jobs/parallel_for/" + std::to_string(threads) + "_threads";
+			scaling.unit = "ms";
+			scaling.samples = 20;
+			scaling.setup = [threads]()
+			{
+				std::mt19937 random(BenchSeed);
+				std::uniform_real_distribution<float> distribution(0.0f, 100.0f);
+
+				input.resize(JOB_WORK_ITEMS);
+				output.resize(JOB_WORK_ITEMS);
+
+				for (float &value : input)
+					value = distribution(random);
+
+				// the job system always starts at least one worker (init(0) means one per core), one thread is the plain loop
+				if (threads > 1)
+					JobSystem::init(threads - 1);
+			};
+			scaling.sample = [threads]()
+			{
+				BenchTimer timer;
+
+				if (threads > 1)
+				{
+					JobSystem::parallelFor(JOB_WORK_ITEMS, JOB_BATCH_SIZE, processItem);
+				}
+				else
+				{
+					for (uint32_t i = 0; i < JOB_WORK_ITEMS; i++)
+						processItem(i);
+				}
+
+				doNotOptimize(output[0]);
+				return timer.elapsedNanoseconds() * 1e-6;
+			};
+			scaling.teardown = []()
+			{
+				JobSystem::shutdown();
+			};
+			suite.add(scaling);
+
+			if (threads == maxThreads)
+				break;
+		}
+
+		//////////////////// Cost of an empty job (submit, steal/execute, counter)
+		Benchmark overhead;
+		overhead.name = "jobs/empty_job";
+		overhead.unit = "ns/job";
+		overhead.setup = []()
+		{
+			JobSystem::init();
+		};
+		overhead.sample = []()
+		{
+			JobCounter counter(0);
+			BenchTimer timer;
+
+			for (uint32_t i = 0; i < EMPTY_JOBS_PER_SAMPLE; i++)
+				JobSystem::run([]() {}, &counter);
+
+			JobSystem::wait(counter);
+
+			return timer.elapsedNanoseconds() / EMPTY_JOBS_PER_SAMPLE;
+		};
+		overhead.teardown = []()
+		{
+			JobSystem::shutdown();
+		};
+		suite.add(overhead);
+	}
+
+}
@@ -0,0 +1,84 @@
+#include "vpch.h"
+#include "Bench.h"
+
+#include "Viper/LayerStack.h"
+#include "Viper/Jobs/JobSystem.h"
+
+#include <cmath>
+#include <memory>
+
+namespace ViperBench
+{
+
+	#define LAYER_WORK_ITEMS 20000
+
+	using namespace Viper;
+
+	//*************** WorkLayer class ***************//
+	class WorkLayer : public Layer
+	{
+		/*
+			Fixed amount of arithmetic per update. Independent layers write their own resource bit,
+			dependent ones declare nothing and update alone in stack order.
+		*/
+
+	public:
+		WorkLayer(uint32_t index, bool independent)
+			: Layer("Bench layer " + std::to_string(index)), data(LAYER_WORK_ITEMS, (float)index)
+		{
+			if (independent)
+				this->declareAccess(0, 1ull << (index % 64));
+		}
+
+		void onUpdate() override
+		{
+			for (float &value : this->data)
+				value = std::sqrt(value * value + 1.0f) * 0.5f;
+		}
+
+	private:
+		std::vector<float> data;
+	};
+
+	static void addLayerBenchmark(BenchSuite &suite, uint32_t layerCount, bool independent)
+	{
+		auto layers = std::make_shared<std::unique_ptr<LayerStack>>();
+
+		Benchmark benchmark;
+		benchmark.name = std::string("layers/update/") + (independent ? "independent_" : "serial_") + std::to_string(layerCount);
+		benchmark.unit = "ms";
+		benchmark.setup = [layers, layerCount, independent]()
+		{
+			JobSystem::init();
+
+			*layers = std::make_unique<LayerStack>();
+			for (uint32_t i = 0; i < layerCount; i++)
+				(*layers)->emplaceLayer<WorkLayer>(i, independent);
+		};
+		benchmark.sample = [layers]()
+		{
+			BenchTimer timer;
+			(*layers)->update();
+			return timer.elapsedNanoseconds() * 1e-6;
+		};
+		benchmark.teardown = [layers]()
+		{
+			layers->reset();
+			JobSystem::shutdown();
+		};
+
+		suite.add(benchmark);
+	}
+
+	void registerLayerBenchmarks(BenchSuite &suite)
+	{
+		// every layer brings the same amount of work: serial updates grow linearly with the count,
+		// independent layers are spread over the job system's threads
+		for (uint32_t layerCount : { 1, 4, 16, 64 })
+		{
+			addLayerBenchmark(suite, layerCount, false);
+			addLayerBenchmark(suite, layerCount, true);
+		}
+	}
+
+}
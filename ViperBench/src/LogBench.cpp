@@ -0,0 +1,114 @@
+#include "vpch.h"
+#include "Bench.h"
+
+#include "spdlog/async.h"
+#include "spdlog/sinks/null_sink.h"
+
+namespace ViperBench
+{
+
+	#define LOG_MESSAGES_PER_SAMPLE 20000
+
+	using namespace Viper;
+
+	/*
+		The engine macros log through Log::getCoreLogger(), for the measurement it is swapped for a logger
+		writing to a null sink, so the numbers are the cost paid by the logging thread and not the console's.
+	*/
+
+	static std::shared_ptr<spdlog::logger> engineLogger;
+
+	static void useLogger(const std::shared_ptr<spdlog::logger> &logger)
+	{
+		engineLogger = Log::getCoreLogger();
+
+		logger->set_level(spdlog::level::trace);
+		Log::getCoreLogger() = logger;
+	}
+
+	static void restoreLogger()
+	{
+		spdlog::drop(Log::getCoreLogger()->name());
+		Log::getCoreLogger() = engineLogger;
+		engineLogger.reset();
+	}
+
+	static double logMessages()
+	{
+		BenchTimer timer;
+
+		for (uint32_t i = 0; i < LOG_MESSAGES_PER_SAMPLE; i++)
+			V_CORE_INFO("frame {0}: {1} draws, {2} ms", i, i % 100, 16.6f);
+
+		return timer.elapsedNanoseconds() / LOG_MESSAGES_PER_SAMPLE;
+	}
+
+	void registerLogBenchmarks(BenchSuite &suite)
+	{
+		//////////////////// Synchronous: formatting and the sink on the calling thread
+		Benchmark sync;
+		sync.name = "log/sync";
+		sync.unit = "ns/msg";
+		sync.setup = []()
+		{
+			useLogger(spdlog::create<spdlog::sinks::null_sink_mt>("Bench sync"));
+		};
+		sync.sample = logMessages;
+		sync.teardown = restoreLogger;
+		suite.add(sync);
+
+		//////////////////// Asynchronous: formatting into the queue, the sink runs on the logging thread
+		Benchmark async;
+		async.name = "log/async";
+		async.unit = "ns/msg";
+		async.setup = []()
+		{
+			useLogger(spdlog::create_async_nb<spdlog::sinks::null_sink_mt>("Bench async"));
+		};
+		async.sample = logMessages;
+		async.teardown = restoreLogger;
+		suite.add(async);
+
+		//////////////////// Rate limited: the calls that are filtered out
+		Benchmark everyN;
+		everyN.name = "log/every_n_filtered";
+		everyN.unit = "ns/call";
+		everyN.setup = []()
+		{
+			useLogger(spdlog::create<spdlog::sinks::null_sink_mt>("Bench every n"));
+		};
+		everyN.sample = []()
+		{
+			BenchTimer timer;
+
+			for (uint32_t i = 0; i < LOG_MESSAGES_PER_SAMPLE; i++)
+				V_LOG_EVERY_N(1000, V_CORE_INFO, "frame {0}", i);
+
+			return timer.elapsedNanoseconds() / LOG_MESSAGES_PER_SAMPLE;
+		};
+		everyN.teardown = restoreLogger;
+		suite.add(everyN);
+
+		//////////////////// Trace: a runtime level check in Debug, nothing at all in Release and Dist
+		Benchmark trace;
+		trace.name = "log/trace_filtered";
+		trace.unit = "ns/call";
+		trace.setup = []()
+		{
+			useLogger(spdlog::create<spdlog::sinks::null_sink_mt>("Bench trace"));
+			Log::getCoreLogger()->set_level(spdlog::level::info);
+		};
+		trace.sample = []()
+		{
+			BenchTimer timer;
+
+			for (uint32_t i = 0; i < LOG_MESSAGES_PER_SAMPLE; i++)
+				V_CORE_TRACE("frame {0}", i);
+
+			return timer.elapsedNanoseconds() / LOG_MESSAGES_PER_SAMPLE;
+		};
+		trace.teardown = restoreLogger;
+		suite.add(trace);
+	}
+
+}
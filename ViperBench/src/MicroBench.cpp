@@ -0,0 +1,118 @@
+#include "vpch.h"
+#include "MicroBench.h"
+
+#include <intrin.h>
+
+namespace ViperBench
+{
+
+	#define MICRO_SAMPLE_TIME_NS 5000000.0
+	#define MICRO_MAX_ITERATIONS (1ull << 30)
+	#define MICRO_SAMPLES 20
+	#define MICRO_WARMUP 3
+
+	// unpinned unless --cpu is given
+	static int32_t microBenchCpu = -1;
+
+	//*************** PerfCounters class ***************//
+
+	void PerfCounters::start()
+	{
+		this->timestampStart = __rdtsc();
+	}
+
+	void PerfCounters::stop()
+	{
+		this->timestampTicks = __rdtsc() - this->timestampStart;
+	}
+
+
+
+	//*************** MicroBench ***************//
+
+	void setMicroBenchCpu(int32_t cpu)
+	{
+		microBenchCpu = cpu;
+	}
+
+	uint64_t pinThread(int32_t cpu)
+	{
+		if (cpu < 0 || cpu >= 64)
+			return 0;
+
+		return (uint64_t)SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu);
+	}
+
+	void restoreThreadAffinity(uint64_t previous)
+	{
+		if (previous == 0)
+			return;
+
+		SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)previous);
+	}
+
+	void MicroBenchState::accumulate(uint64_t ops)
+	{
+		// warmup samples are timed but not counted
+		if (this->samplesTaken++ < this->warmup)
+			return;
+
+		this->measuredOps += ops;
+		this->timestampTicks += this->counters.getTimestampTicks();
+	}
+
+	void MicroBenchState::report(BenchResult &result) const
+	{
+		if (this->measuredOps == 0)
+			return;
+
+		double ops = (double)this->measuredOps;
+
+		result.counters.emplace_back("iterations", (double)this->iterations);
+
+		result.counters.emplace_back("tsc_ticks/op", this->timestampTicks / ops);
+	}
+
+	Benchmark makeMicroBenchmark(const std::string &name, std::function<double(MicroBenchState &state)> sample)
+	{
+		auto state = std::make_shared<MicroBenchState>();
+
+		Benchmark benchmark;
+		benchmark.name = "micro/" + name;
+		benchmark.unit = "ns/op";
+		benchmark.samples = MICRO_SAMPLES;
+		benchmark.warmup = MICRO_WARMUP;
+
+		benchmark.setup = [state, sample]()
+		{
+			state->previousAffinity = pinThread(microBenchCpu);
+			state->samplesTaken = 0;
+			state->warmup = MICRO_WARMUP;
+			state->measuredOps = 0;
+			state->timestampTicks = 0;
+
+			// grow the batch until it is long enough for the timer and the counters
+			state->iterations = 1;
+			while (sample(*state) < MICRO_SAMPLE_TIME_NS && state->iterations < MICRO_MAX_ITERATIONS)
+				state->iterations *= 2;
+		};
+		benchmark.sample = [state, sample]()
+		{
+			double ns = sample(*state);
+			state->accumulate(state->iterations);
+
+			return ns / state->iterations;
+		};
+		benchmark.teardown = [state]()
+		{
+			restoreThreadAffinity(state->previousAffinity);
+		};
+		benchmark.report = [state](BenchResult &result)
+		{
+			state->report(result);
+		};
+
+		return benchmark;
+	}
+
+}
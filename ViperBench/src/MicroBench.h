@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Bench.h"
+
+#include <memory>
+
+namespace ViperBench
+{
+
+	//*************** PerfCounters class ***************//
+	class PerfCounters
+	{
+		/*
+			Time stamp counter of the calling thread between start() and stop() - reference cycles at a fixed rate,
+			not core cycles. Windows has no user mode access to the PMU without a driver, so core cycles, retired
+			instructions and cache misses are not read.
+		*/
+
+	public:
+		void start();
+		void stop();
+
+		// ticks of the last start/stop
+		inline uint64_t getTimestampTicks() const { return this->timestampTicks; }
+
+	private:
+		uint64_t timestampStart = 0;
+		uint64_t timestampTicks = 0;
+	};
+
+
+	//*************** MicroBench ***************//
+	/*
+		Microbenchmarks time a tight loop around one operation. The thread is pinned to one core for the run,
+		the loop length is scaled so a sample takes about MICRO_SAMPLE_TIME, and the counters are reported per operation.
+	*/
+
+	// core the microbenchmarks are pinned to (-1 = no pinning, the default)
+	void setMicroBenchCpu(int32_t cpu);
+
+	// pins the calling thread, returns an opaque copy of the previous affinity for restoreThreadAffinity()
+	uint64_t pinThread(int32_t cpu);
+	void restoreThreadAffinity(uint64_t previous);
+
+	struct MicroBenchState
+	{
+		// operations per sample, found in setup
+		uint64_t iterations = 1;
+
+		uint32_t samplesTaken = 0;
+		uint32_t warmup = 0;
+
+		// totals of the measured (non-warmup) samples
+		uint64_t measuredOps = 0;
+
+		uint64_t timestampTicks = 0;
+
+		uint64_t previousAffinity = 0;
+		PerfCounters counters;
+
+		void accumulate(uint64_t ops);
+		void report(BenchResult &result) const;
+	};
+
+	// sample runs state.iterations operations between state.counters.start() and stop() and returns the nanoseconds they took
+	Benchmark makeMicroBenchmark(const std::string &name, std::function<double(MicroBenchState &state)> sample);
+
+	// op is called once per operation, setup/teardown around the whole benchmark
+	template<typename F>
+	void addMicroBenchmark(BenchSuite &suite, const std::string &name, F op, std::function<void()> setup = {}, std::function<void()> teardown = {})
+	{
+		Benchmark benchmark = makeMicroBenchmark(name, [op](MicroBenchState &state) mutable
+		{
+			uint64_t iterations = state.iterations;
+
+			state.counters.start();
+			BenchTimer timer;
+
+			for (uint64_t i = 0; i < iterations; i++)
+				op();
+
+			double ns = timer.elapsedNanoseconds();
+			state.counters.stop();
+
+			return ns;
+		});
+
+		if (setup)
+		{
+			auto pinAndCalibrate = benchmark.setup;
+			benchmark.setup = [setup, pinAndCalibrate]() { setup(); pinAndCalibrate(); };
+		}
+
+		if (teardown)
+		{
+			auto restore = benchmark.teardown;
+			benchmark.teardown = [teardown, restore]() { restore(); teardown(); };
+		}
+
+		suite.add(benchmark);
+	}
+
+}
@@ -0,0 +1,313 @@
+#include "vpch.h"
+#include "MicroBench.h"
+
+#include "Viper/Window.h"
+#include "Viper/Input.h"
+#include "Viper/LayerStack.h"
+#include "Viper/KeyCodes.h"
+#include "Viper/Events/ApplicationEvent.h"
+#include "Viper/Events/KeyEvent.h"
+#include "Viper/Events/MouseEvent.h"
+#include "Viper/Memory/LinearAllocator.h"
+#include "Viper/Memory/SlabAllocator.h"
+#include "Viper/Memory/ObjectPool.h"
+
+#include <GLFW/glfw3.h>
+
+namespace ViperBench
+{
+
+	#define MICRO_LAYER_COUNT 16
+	#define MICRO_ALLOCATION_SIZE 64
+	#define MICRO_MOTION_SAMPLES_PER_FRAME 16
+
+	using namespace Viper;
+
+	struct MicroObject
+	{
+		float data[MICRO_ALLOCATION_SIZE / sizeof(float)];
+	};
+
+	static bool onKeyPressed(KeyPressedEvent &e) { return e.getKeyCode() == V_KEY_ESCAPE; }
+	static bool onMouseMoved(MouseMovedEvent &e) { return false; }
+	static bool onWindowResize(WindowResizeEvent &e) { return false; }
+
+	//*************** NoopLayer class ***************//
+	class NoopLayer : public Layer
+	{
+	public:
+		NoopLayer() : Layer("Noop layer") { }
+
+		void onEvent(Event &event) override { event.handled = false; }
+	};
+
+	static void registerEventMicroBenchmarks(BenchSuite &suite)
+	{
+		// read through a volatile pointer, so the compiler cannot hoist the dispatch out of the loop
+		static KeyPressedEvent keyEvent(V_KEY_SPACE, 0);
+		static Event *volatile event = &keyEvent;
+
+		// the matching handler is the last one tried
+		addMicroBenchmark(suite, "event_dispatcher", []()
+		{
+			EventDispatcher dispatcher(*event);
+			dispatcher.dispatch<MouseMovedEvent>(onMouseMoved);
+			dispatcher.dispatch<WindowResizeEvent>(onWindowResize);
+			dispatcher.dispatch<KeyPressedEvent>(onKeyPressed);
+			doNotOptimize(event->handled);
+		});
+
+		static EventHandlerTable table;
+		table.bind<KeyPressedEvent, &onKeyPressed>();
+		table.bind<MouseMovedEvent, &onMouseMoved>();
+		table.bind<WindowResizeEvent, &onWindowResize>();
+
+		addMicroBenchmark(suite, "event_handler_table", []()
+		{
+			table.dispatch(*event);
+			doNotOptimize(event->handled);
+		});
+	}
+
+	static void registerLayerMicroBenchmarks(BenchSuite &suite)
+	{
+		static LayerStack *stack = nullptr;
+		static Layer *layer = nullptr;
+
+		// nothing is allocated in the loop, the stack's vector keeps its capacity
+		addMicroBenchmark(suite, "layerstack_push_pop", []()
+		{
+			stack->pushLayer(layer);
+			stack->popLayer(layer);
+		},
+		[]()
+		{
+			stack = new LayerStack();
+			layer = new NoopLayer();
+		},
+		[]()
+		{
+			delete stack;
+			delete layer;
+		});
+
+		// one op is a pass of an event over the whole stack, top to bottom like Application::onEvent
+		static KeyPressedEvent event(V_KEY_SPACE, 0);
+
+		addMicroBenchmark(suite, "layerstack_iterate_" + std::to_string(MICRO_LAYER_COUNT), []()
+		{
+			for (auto it = stack->end(); it != stack->begin(); )
+			{
+				(*--it)->onEvent(event);
+				if (event.handled)
+					break;
+			}
+		},
+		[]()
+		{
+			stack = new LayerStack();
+			for (uint32_t i = 0; i < MICRO_LAYER_COUNT; i++)
+				stack->emplaceLayer<NoopLayer>();
+		},
+		[]()
+		{
+			delete stack;
+		});
+	}
+
+	static void registerInputMicroBenchmarks(BenchSuite &suite)
+	{
+		// a query on the polled snapshot, no window needed
+		Benchmark snapshot = makeMicroBenchmark("input_snapshot_query", [](MicroBenchState &state)
+		{
+			uint64_t iterations = state.iterations;
+			int pressed = 0;
+
+			state.counters.start();
+			BenchTimer timer;
+
+			for (uint64_t i = 0; i < iterations; i++)
+				pressed += Input::isKeyPressed(V_KEY_W + (int)(i & 3));
+
+			double ns = timer.elapsedNanoseconds();
+			state.counters.stop();
+
+			doNotOptimize(pressed);
+			return ns;
+		});
+		suite.add(snapshot);
+
+		// raw motion of a 1000 Hz mouse: every sample is accumulated into the pending snapshot, 16 samples per published frame
+		Benchmark motion = makeMicroBenchmark("input_motion_samples", [](MicroBenchState &state)
+		{
+			uint64_t iterations = state.iterations;
+			float motionX = 0.0f;
+
+			// drop what the previous batch left pending, each frame below then holds exactly its own samples
+			Input::publish();
+
+			// untimed check pass - the samples of a published frame add up to its delta
+			{
+				for (uint32_t sample = 0; sample < MICRO_MOTION_SAMPLES_PER_FRAME; sample++)
+					Input::recordCursorMove((float)sample, 0.0f, (double)sample * 0.001);
+
+				Input::publish();
+
+				const InputSnapshot &frame = Input::getSnapshot();
+				float sum = 0.0f;
+
+				for (uint32_t sample = 0; sample < frame.motionCount; sample++)
+					sum += frame.motion[sample].dx;
+
+				V_CORE_ASSERT(frame.motionCount == MICRO_MOTION_SAMPLES_PER_FRAME && sum == frame.motionX, "motion samples don't add up to the frame's delta!");
+			}
+
+			state.counters.start();
+			BenchTimer timer;
+
+			for (uint64_t i = 0; i < iterations; i++)
+			{
+				Input::recordCursorMove((float)(i & 1023), 0.0f, (double)i * 0.001);
+
+				if ((i & (MICRO_MOTION_SAMPLES_PER_FRAME - 1)) == MICRO_MOTION_SAMPLES_PER_FRAME - 1)
+				{
+					Input::publish();
+					motionX += Input::getSnapshot().motionX;
+				}
+			}
+
+			double ns = timer.elapsedNanoseconds();
+			state.counters.stop();
+
+			doNotOptimize(motionX);
+			return ns;
+		});
+		suite.add(motion);
+
+		// what every query did before the snapshot - a glfwGetKey on the window, so it needs the benchmark window
+		static GLFWwindow *nativeWindow = nullptr;
+
+		Benchmark getKey = makeMicroBenchmark("input_glfw_get_key", [](MicroBenchState &state)
+		{
+			uint64_t iterations = state.iterations;
+			int pressed = 0;
+
+			state.counters.start();
+			BenchTimer timer;
+
+			for (uint64_t i = 0; i < iterations; i++)
+				pressed += glfwGetKey(nativeWindow, V_KEY_W + (int)(i & 3)) == GLFW_PRESS;
+
+			double ns = timer.elapsedNanoseconds();
+			state.counters.stop();
+
+			doNotOptimize(pressed);
+			return ns;
+		});
+
+		auto pinAndCalibrate = getKey.setup;
+		getKey.setup = [pinAndCalibrate]()
+		{
+			nativeWindow = static_cast<GLFWwindow *>(getBenchWindow()->getNativeWindow());
+			pinAndCalibrate();
+		};
+		getKey.gpu = true;
+
+		suite.add(getKey);
+	}
+
+	static void registerLogMicroBenchmarks(BenchSuite &suite)
+	{
+		// messages below the logger's level, nothing reaches a sink
+		static spdlog::level::level_enum previousLevel;
+
+		auto raiseLevel = []()
+		{
+			previousLevel = Log::getCoreLogger()->level();
+			Log::getCoreLogger()->set_level(spdlog::level::warn);
+		};
+		auto restoreLevel = []()
+		{
+			Log::getCoreLogger()->set_level(previousLevel);
+		};
+
+		static uint32_t frame = 0;
+
+		addMicroBenchmark(suite, "log_info_filtered", []()
+		{
+			V_CORE_INFO("frame {0}", frame++);
+		}, raiseLevel, restoreLevel);
+
+		addMicroBenchmark(suite, "log_every_n_filtered", []()
+		{
+			V_LOG_EVERY_N(64, V_CORE_INFO, "frame {0}", frame++);
+		}, raiseLevel, restoreLevel);
+
+		addMicroBenchmark(suite, "log_trace", []()
+		{
+			V_CORE_TRACE("frame {0}", frame++);
+		}, raiseLevel, restoreLevel);
+	}
+
+	static void registerAllocatorMicroBenchmarks(BenchSuite &suite)
+	{
+		//////////////////// Linear allocator, reset whenever the first block is used up
+		static LinearAllocator *linear = nullptr;
+		static uint32_t linearCount = 0;
+
+		addMicroBenchmark(suite, "linear_allocate", []()
+		{
+			if (++linearCount == 1024)
+			{
+				linear->reset();
+				linearCount = 0;
+			}
+
+			doNotOptimize(linear->allocate(MICRO_ALLOCATION_SIZE));
+		},
+		[]() { linear = new LinearAllocator(); },
+		[]() { delete linear; });
+
+		//////////////////// Slab allocator allocate/free pair
+		static SlabAllocator *slab = nullptr;
+
+		addMicroBenchmark(suite, "slab_allocate_free", []()
+		{
+			void *memory = slab->allocate(MICRO_ALLOCATION_SIZE);
+			doNotOptimize(memory);
+			slab->free(memory, MICRO_ALLOCATION_SIZE);
+		},
+		[]() { slab = new SlabAllocator(); },
+		[]() { delete slab; });
+
+		//////////////////// Object pool create/destroy pair
+		static ObjectPool<MicroObject> *pool = nullptr;
+
+		addMicroBenchmark(suite, "object_pool_create_destroy", []()
+		{
+			MicroObject *object = pool->create();
+			doNotOptimize(object);
+			pool->destroy(object);
+		},
+		[]() { pool = new ObjectPool<MicroObject>(); },
+		[]() { delete pool; });
+
+		//////////////////// Global heap for comparison (includes the tracking header outside Dist)
+		addMicroBenchmark(suite, "global_new_delete", []()
+		{
+			MicroObject *object = new MicroObject();
+			doNotOptimize(object);
+			delete object;
+		});
+	}
+
+	void registerMicroBenchmarks(BenchSuite &suite)
+	{
+		registerEventMicroBenchmarks(suite);
+		registerLayerMicroBenchmarks(suite);
+		registerInputMicroBenchmarks(suite);
+		registerLogMicroBenchmarks(suite);
+		registerAllocatorMicroBenchmarks(suite);
+	}
+
+}
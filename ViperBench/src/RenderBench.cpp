@@ -0,0 +1,84 @@
+#include "vpch.h"
+#include "Bench.h"
+
+#include "Viper/Renderer/RenderQueue.h"
+#include "Viper/Renderer/OverlayBatch.h"
+
+#include <random>
+
+namespace ViperBench
+{
+
+	#define RENDER_QUEUE_DRAWS 10000
+	#define OVERLAY_TEXT_LINES 200
+
+	using namespace Viper;
+
+	void registerRenderBenchmarks(BenchSuite &suite)
+	{
+		//////////////////// Draw submission and the radix sort (main thread part of a draw)
+		static std::vector<DrawCommand> commands;
+		static std::vector<float> depths;
+		static RenderQueue queue;
+
+		Benchmark submitSort;
+		submitSort.name = "render/queue_submit_sort";
+		submitSort.unit = "ns/draw";
+		submitSort.setup = []()
+		{
+			std::mt19937 random(BenchSeed);
+			std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+			commands.resize(RENDER_QUEUE_DRAWS);
+			depths.resize(RENDER_QUEUE_DRAWS);
+
+			for (uint32_t i = 0; i < RENDER_QUEUE_DRAWS; i++)
+			{
+				commands[i].pipeline = random() % 8;
+				commands[i].material = random() % 64;
+				commands[i].indexCount = 3;
+				depths[i] = distribution(random);
+			}
+		};
+		submitSort.sample = []()
+		{
+			BenchTimer timer;
+
+			queue.clear();
+
+			for (uint32_t i = 0; i < RENDER_QUEUE_DRAWS; i++)
+				queue.submit(i % 5 == 0 ? RenderPassType::Transparent : RenderPassType::Opaque, depths[i], commands[i]);
+
+			queue.sort();
+
+			doNotOptimize(queue.getKey(0));
+			return timer.elapsedNanoseconds() / RENDER_QUEUE_DRAWS;
+		};
+		suite.add(submitSort);
+
+		//////////////////// Quad batching of overlay text (what the stats overlay does every frame)
+		static OverlayBatch overlay;
+
+		Benchmark batching;
+		batching.name = "render/overlay_text_batching";
+		batching.unit = "ns/quad";
+		batching.sample = []()
+		{
+			char line[64];
+			BenchTimer timer;
+
+			overlay.clear();
+
+			for (uint32_t i = 0; i < OVERLAY_TEXT_LINES; i++)
+			{
+				snprintf(line, sizeof(line), "FRAME %u  %.2f MS  DRAWS %u", i, i * 0.1f, i * 3);
+				overlay.drawText(8.0f, 8.0f + i * 20.0f, line, OverlayBatch::packColor(1.0f, 1.0f, 1.0f));
+			}
+
+			doNotOptimize(overlay.size());
+			return timer.elapsedNanoseconds() / (overlay.size() / 6);
+		};
+		suite.add(batching);
+	}
+
+}
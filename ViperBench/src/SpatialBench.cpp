@@ -0,0 +1,275 @@
+#include "vpch.h"
+#include "Bench.h"
+
+#include "Viper/Scene/SpatialIndex.h"
+#include "Viper/Jobs/JobSystem.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <memory>
+#include <random>
+
+namespace ViperBench
+{
+
+	#define SPATIAL_OBJECTS 100000
+	#define SPATIAL_WORLD_SIZE 1000.0f
+	#define SPATIAL_QUERIES 1000
+
+	using namespace Viper;
+
+	static std::unique_ptr<SpatialIndex> spatialIndex;
+	static std::vector<AABB> objects;
+	static std::vector<uint32_t> proxies;
+
+	static void generateObjects()
+	{
+		std::mt19937 random(BenchSeed);
+		std::uniform_real_distribution<float> position(-SPATIAL_WORLD_SIZE * 0.5f, SPATIAL_WORLD_SIZE * 0.5f);
+		std::uniform_real_distribution<float> size(0.5f, 4.0f);
+
+		objects.resize(SPATIAL_OBJECTS);
+
+		for (AABB &object : objects)
+		{
+			glm::vec3 center(position(random), position(random), position(random));
+			object = AABB(center - glm::vec3(size(random)), center + glm::vec3(size(random)));
+		}
+	}
+
+	static void buildIndex()
+	{
+		generateObjects();
+
+		spatialIndex = std::make_unique<SpatialIndex>();
+		proxies.resize(SPATIAL_OBJECTS);
+
+		for (uint32_t i = 0; i < SPATIAL_OBJECTS; i++)
+			proxies[i] = spatialIndex->insert(objects[i], i);
+
+		spatialIndex->rebuild();
+	}
+
+	static void destroyIndex()
+	{
+		spatialIndex.reset();
+		objects.clear();
+		proxies.clear();
+	}
+
+	// a camera at the center looking along a random direction, ~1.5% of the objects are visible
+	static Frustum makeFrustum(std::mt19937 &random)
+	{
+		std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+
+		glm::vec3 forward(direction(random), direction(random), direction(random) + 0.01f);
+		glm::mat4 view = glm::lookAt(glm::vec3(0.0f), forward, glm::vec3(0.0f, 1.0f, 0.0f));
+		glm::mat4 projection = glm::perspectiveRH_ZO(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, SPATIAL_WORLD_SIZE * 0.25f);
+
+		return Frustum::fromMatrix(projection * view);
+	}
+
+	static Ray makeRay(std::mt19937 &random)
+	{
+		std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+
+		glm::vec3 origin(value(random), value(random), value(random));
+		glm::vec3 direction(value(random), value(random), value(random) + 0.01f);
+
+		return Ray(origin * SPATIAL_WORLD_SIZE * 0.5f, direction);
+	}
+
+	void registerSpatialBenchmarks(BenchSuite &suite)
+	{
+		//////////////////// Building the hierarchy: incremental inserts vs the parallel top down rebuild
+		Benchmark insert;
+		insert.name = "spatial/insert_100k";
+		insert.unit = "ms";
+		insert.samples = 10;
+		insert.setup = generateObjects;
+		insert.sample = []()
+		{
+			SpatialIndex index;
+
+			BenchTimer timer;
+
+			for (uint32_t i = 0; i < SPATIAL_OBJECTS; i++)
+				index.insert(objects[i], i);
+
+			doNotOptimize(index.getHeight());
+			return timer.elapsedNanoseconds() * 1e-6;
+		};
+		insert.teardown = destroyIndex;
+		suite.add(insert);
+
+		Benchmark rebuild;
+		rebuild.name = "spatial/rebuild_100k";
+		rebuild.unit = "ms";
+		rebuild.samples = 10;
+		rebuild.setup = []()
+		{
+			JobSystem::init();
+			buildIndex();
+		};
+		rebuild.sample = []()
+		{
+			BenchTimer timer;
+			spatialIndex->rebuild();
+			return timer.elapsedNanoseconds() * 1e-6;
+		};
+		rebuild.teardown = []()
+		{
+			destroyIndex();
+			JobSystem::shutdown();
+		};
+		suite.add(rebuild);
+
+		//////////////////// Moving every object a little - most stay inside their loose bounds
+		Benchmark move;
+		move.name = "spatial/move_100k";
+		move.unit = "ns/object";
+		move.setup = buildIndex;
+		move.sample = []()
+		{
+			std::mt19937 random(BenchSeed);
+			std::uniform_real_distribution<float> step(-0.05f, 0.05f);
+
+			for (AABB &object : objects)
+			{
+				glm::vec3 offset(step(random), step(random), step(random));
+				object.min += offset;
+				object.max += offset;
+			}
+
+			BenchTimer timer;
+
+			uint32_t reinserted = 0;
+			for (uint32_t i = 0; i < SPATIAL_OBJECTS; i++)
+				reinserted += spatialIndex->move(proxies[i], objects[i]);
+
+			doNotOptimize(reinserted);
+			return timer.elapsedNanoseconds() / SPATIAL_OBJECTS;
+		};
+		move.teardown = destroyIndex;
+		suite.add(move);
+
+		//////////////////// Culling and picking through the index vs testing every object
+		Benchmark frustum;
+		frustum.name = "spatial/frustum_query_100k";
+		frustum.unit = "us/query";
+		frustum.setup = buildIndex;
+		frustum.sample = []()
+		{
+			std::mt19937 random(BenchSeed);
+			uint32_t visible = 0;
+
+			BenchTimer timer;
+
+			for (uint32_t i = 0; i < SPATIAL_QUERIES / 10; i++)
+			{
+				Frustum frustum = makeFrustum(random);
+				spatialIndex->queryFrustum(frustum, [&visible](uint32_t) { visible++; return true; });
+			}
+
+			doNotOptimize(visible);
+			return timer.elapsedNanoseconds() * 1e-3 / (SPATIAL_QUERIES / 10);
+		};
+		frustum.teardown = destroyIndex;
+		suite.add(frustum);
+
+		Benchmark frustumLinear;
+		frustumLinear.name = "spatial/frustum_linear_100k";
+		frustumLinear.unit = "us/query";
+		frustumLinear.samples = 10;
+		frustumLinear.setup = generateObjects;
+		frustumLinear.sample = []()
+		{
+			std::mt19937 random(BenchSeed);
+			uint32_t visible = 0;
+
+			BenchTimer timer;
+
+			for (uint32_t i = 0; i < SPATIAL_QUERIES / 10; i++)
+			{
+				Frustum frustum = makeFrustum(random);
+
+				for (const AABB &object : objects)
+					visible += frustum.test(object) != Frustum::Containment::Outside;
+			}
+
+			doNotOptimize(visible);
+			return timer.elapsedNanoseconds() * 1e-3 / (SPATIAL_QUERIES / 10);
+		};
+		frustumLinear.teardown = destroyIndex;
+		suite.add(frustumLinear);
+
+		Benchmark raycast;
+		raycast.name = "spatial/raycast_100k";
+		raycast.unit = "us/query";
+		raycast.setup = buildIndex;
+		raycast.sample = []()
+		{
+			std::mt19937 random(BenchSeed);
+			uint32_t hits = 0;
+
+			BenchTimer timer;
+
+			for (uint32_t i = 0; i < SPATIAL_QUERIES; i++)
+			{
+				Ray ray = makeRay(random);
+				float distance;
+
+				uint32_t hit = spatialIndex->raycast(ray, SPATIAL_WORLD_SIZE, distance, [&ray](uint32_t proxy, float maxDistance)
+				{
+					float entry;
+					return ray.intersects(objects[spatialIndex->getUserData(proxy)], maxDistance, entry) ? entry : -1.0f;
+				});
+
+				hits += hit != SpatialIndex::NullProxy;
+			}
+
+			doNotOptimize(hits);
+			return timer.elapsedNanoseconds() * 1e-3 / SPATIAL_QUERIES;
+		};
+		raycast.teardown = destroyIndex;
+		suite.add(raycast);
+
+		Benchmark raycastLinear;
+		raycastLinear.name = "spatial/raycast_linear_100k";
+		raycastLinear.unit = "us/query";
+		raycastLinear.samples = 10;
+		raycastLinear.setup = generateObjects;
+		raycastLinear.sample = []()
+		{
+			std::mt19937 random(BenchSeed);
+			uint32_t hits = 0;
+
+			BenchTimer timer;
+
+			for (uint32_t i = 0; i < SPATIAL_QUERIES / 10; i++)
+			{
+				Ray ray = makeRay(random);
+				float closest = SPATIAL_WORLD_SIZE;
+				bool hit = false;
+
+				for (const AABB &object : objects)
+				{
+					float entry;
+					if (ray.intersects(object, closest, entry))
+					{
+						closest = entry;
+						hit = true;
+					}
+				}
+
+				hits += hit;
+			}
+
+			doNotOptimize(hits);
+			return timer.elapsedNanoseconds() * 1e-3 / (SPATIAL_QUERIES / 10);
+		};
+		raycastLinear.teardown = destroyIndex;
+		suite.add(raycastLinear);
+	}
+
+}
@@ -0,0 +1,125 @@
+#include "vpch.h"
+#include "Bench.h"
+
+#include "Viper/Scene/TransformHierarchy.h"
+
+#include <memory>
+#include <random>
+
+namespace ViperBench
+{
+
+	#define TRANSFORM_NODES 100000
+	#define TRANSFORM_CHILDREN 4
+
+	using namespace Viper;
+
+	static std::unique_ptr<TransformHierarchy> hierarchy;
+	static std::vector<TransformHandle> handles;
+
+	// every node gets TRANSFORM_CHILDREN children until TRANSFORM_NODES exist (depth ~8 for 100k nodes)
+	static void buildHierarchy()
+	{
+		hierarchy = std::make_unique<TransformHierarchy>();
+		handles.clear();
+		handles.reserve(TRANSFORM_NODES);
+
+		Transform local;
+		local.position = glm::vec3(1.0f, 0.5f, 0.0f);
+		local.rotation = glm::angleAxis(0.1f, glm::vec3(0.0f, 1.0f, 0.0f));
+
+		handles.push_back(hierarchy->create(local));
+
+		for (uint32_t i = 1; i < TRANSFORM_NODES; i++)
+			handles.push_back(hierarchy->create(local, handles[(i - 1) / TRANSFORM_CHILDREN]));
+
+		hierarchy->update();
+	}
+
+	static void addUpdateBenchmark(BenchSuite &suite, const char *name, uint32_t dirtyPercent)
+	{
+		Benchmark benchmark;
+		benchmark.name = name;
+		benchmark.unit = "ns/node";
+		benchmark.setup = buildHierarchy;
+		benchmark.sample = [dirtyPercent]()
+		{
+			// touch random nodes, their whole subtrees are recomputed
+			std::mt19937 random(BenchSeed);
+			uint32_t touched = TRANSFORM_NODES * dirtyPercent / 100;
+
+			for (uint32_t i = 0; i < touched; i++)
+			{
+				TransformHandle handle = handles[random() % TRANSFORM_NODES];
+				hierarchy->setLocal(handle, hierarchy->getLocal(handle));
+			}
+
+			BenchTimer timer;
+			hierarchy->update();
+
+			doNotOptimize(hierarchy->getWorldMatrices()[TRANSFORM_NODES - 1]);
+			return timer.elapsedNanoseconds() / TRANSFORM_NODES;
+		};
+		benchmark.teardown = []()
+		{
+			hierarchy.reset();
+			handles.clear();
+		};
+
+		suite.add(benchmark);
+	}
+
+	void registerTransformBenchmarks(BenchSuite &suite)
+	{
+		//////////////////// Propagating world matrices through 100k nodes with a varying share of changed locals
+		addUpdateBenchmark(suite, "transform/update_100k_all_dirty", 100);
+		addUpdateBenchmark(suite, "transform/update_100k_1pct_dirty", 1);
+		addUpdateBenchmark(suite, "transform/update_100k_clean", 0);
+
+		//////////////////// Re-sorting after structural changes (reparenting moves whole subtrees)
+		Benchmark reparent;
+		reparent.name = "transform/reparent_rebuild_100k";
+		reparent.unit = "ms";
+		reparent.setup = buildHierarchy;
+		reparent.sample = []()
+		{
+			std::mt19937 random(BenchSeed);
+
+			BenchTimer timer;
+
+			// leaves only, they can't form cycles
+			for (uint32_t i = 0; i < 100; i++)
+				hierarchy->setParent(handles[TRANSFORM_NODES - 1 - i], handles[random() % 1000]);
+
+			hierarchy->update();
+
+			return timer.elapsedNanoseconds() * 1e-6;
+		};
+		reparent.teardown = []()
+		{
+			hierarchy.reset();
+			handles.clear();
+		};
+		suite.add(reparent);
+
+		//////////////////// The 4x4 product used by the propagation (SSE on x64)
+		Benchmark multiply;
+		multiply.name = "transform/matrix_multiply";
+		multiply.unit = "ns/op";
+		multiply.sample = []()
+		{
+			glm::mat4 a = TransformHierarchy::compose(Transform());
+			glm::mat4 b = glm::mat4(1.0001f);
+
+			BenchTimer timer;
+
+			for (uint32_t i = 0; i < TRANSFORM_NODES; i++)
+				TransformHierarchy::multiply(a, b, a);
+
+			doNotOptimize(a);
+			return timer.elapsedNanoseconds() / TRANSFORM_NODES;
+		};
+		suite.add(multiply);
+	}
+
+}
@@ -0,0 +1,210 @@
+#include "vpch.h"
+#include "Bench.h"
+
+#include "Viper/Window.h"
+#include "Viper/Renderer/GraphicsContext.h"
+#include "Viper/Debug/InputRecorder.h"
+
+#include <limits>
+
+namespace ViperBench
+{
+
+	#define FRAMES_PER_SAMPLE 30
+	#define WINDOW_BENCH_DRAWS 10000
+	#define WINDOW_BENCH_QUADS 4000
+
+	using namespace Viper;
+
+	/*
+		Frames drawn by the real renderer, so these need a window and a GPU. GLFW is terminated with the window,
+		so one window serves all of them and is destroyed by shutdownWindowBenchmarks().
+		Swap chain and shaders are created exactly like in the game - run the suite from the ViperBench directory.
+	*/
+
+	static Window *window = nullptr;
+	static std::string replayFile;
+
+	static GraphicsContext *getContext()
+	{
+		if (!window)
+		{
+			// no vsync and no frame rate limit, frames run as fast as the renderer allows
+			window = Window::create(WindowProperties("ViperBench", 1280, 720, PresentMode::NoVSync, 0));
+			window->setEventCallback([](Event &e) {});
+		}
+
+		return static_cast<GraphicsContext *>(window->getContextHandle());
+	}
+
+	static void submitDraws(GraphicsContext *context, uint32_t count)
+	{
+		RenderQueue &queue = context->getRenderQueue();
+
+		DrawCommand command;
+		command.indexCount = 3;
+
+		for (uint32_t i = 0; i < count; i++)
+			queue.submit(RenderPassType::Opaque, (float)i / count, command);
+	}
+
+	void registerWindowBenchmarks(BenchSuite &suite)
+	{
+		//////////////////// Empty frame, the reference for the others
+		Benchmark emptyFrame;
+		emptyFrame.name = "gpu/empty_frame";
+		emptyFrame.unit = "ms";
+		emptyFrame.gpu = true;
+		emptyFrame.sample = []()
+		{
+			getContext();
+			BenchTimer timer;
+
+			for (uint32_t i = 0; i < FRAMES_PER_SAMPLE; i++)
+				window->onUpdate();
+
+			return timer.elapsedNanoseconds() * 1e-6 / FRAMES_PER_SAMPLE;
+		};
+		suite.add(emptyFrame);
+
+		//////////////////// Draw call throughput of the render thread (record + submit)
+		Benchmark drawCalls;
+		drawCalls.name = "gpu/draw_calls";
+		drawCalls.unit = "ns/draw";
+		drawCalls.gpu = true;
+		drawCalls.sample = []()
+		{
+			GraphicsContext *context = getContext();
+			double renderTime = 0.0;
+
+			for (uint32_t i = 0; i < FRAMES_PER_SAMPLE; i++)
+			{
+				submitDraws(context, WINDOW_BENCH_DRAWS);
+				window->onUpdate();
+				renderTime += context->getStats().renderThreadTime;
+			}
+
+			return renderTime * 1e6 / FRAMES_PER_SAMPLE / WINDOW_BENCH_DRAWS;
+		};
+		suite.add(drawCalls);
+
+		//////////////////// Overlay quads: batching on the main thread, upload and one draw on the render thread
+		Benchmark quads;
+		quads.name = "gpu/overlay_quads";
+		quads.unit = "ms";
+		quads.gpu = true;
+		quads.sample = []()
+		{
+			GraphicsContext *context = getContext();
+			BenchTimer timer;
+
+			for (uint32_t i = 0; i < FRAMES_PER_SAMPLE; i++)
+			{
+				OverlayBatch &overlay = context->getOverlay();
+
+				for (uint32_t q = 0; q < WINDOW_BENCH_QUADS; q++)
+					overlay.drawRect((float)(q % 80) * 16.0f, (float)(q / 80) * 14.0f, 12.0f, 12.0f, OverlayBatch::packColor(1.0f, 0.5f, 0.0f, 0.5f));
+
+				window->onUpdate();
+			}
+
+			return timer.elapsedNanoseconds() * 1e-6 / FRAMES_PER_SAMPLE;
+		};
+		suite.add(quads);
+
+		//////////////////// GPU time of the draws (timestamps)
+		Benchmark gpuTime;
+		gpuTime.name = "gpu/draw_calls_gpu_time";
+		gpuTime.unit = "ms";
+		gpuTime.gpu = true;
+		gpuTime.sample = []()
+		{
+			// measured with timestamps a few frames behind, the draw count is the same in every frame
+			GraphicsContext *context = getContext();
+			double time = 0.0;
+
+			for (uint32_t i = 0; i < FRAMES_PER_SAMPLE; i++)
+			{
+				submitDraws(context, WINDOW_BENCH_DRAWS);
+				window->onUpdate();
+				time += context->getStats().gpuTime;
+			}
+
+			return time / FRAMES_PER_SAMPLE;
+		};
+		suite.add(gpuTime);
+
+		//////////////////// Swap chain recreation every frame
+		Benchmark recreate;
+		recreate.name = "gpu/swapchain_recreate";
+		recreate.unit = "ms";
+		recreate.gpu = true;
+		recreate.samples = 10;
+		recreate.sample = []()
+		{
+			GraphicsContext *context = getContext();
+			BenchTimer timer;
+
+			for (uint32_t i = 0; i < FRAMES_PER_SAMPLE; i++)
+			{
+				context->invalidateSwapChain();
+				window->onUpdate();
+			}
+
+			return timer.elapsedNanoseconds() * 1e-6 / FRAMES_PER_SAMPLE;
+		};
+		suite.add(recreate);
+
+		//////////////////// Whole input recording replayed, every sample sees the same input
+		// the bench window has no layers, nothing reads the replay's fixed timestep - this covers the input playback and the frames
+		if (!replayFile.empty())
+		{
+			Benchmark replay;
+			replay.name = "gpu/replay";
+			replay.unit = "ms";
+			replay.gpu = true;
+			replay.samples = 5;
+			replay.warmup = 1;
+			replay.sample = []()
+			{
+				getContext();
+
+				if (!InputRecorder::startReplay(replayFile))
+					return std::numeric_limits<double>::quiet_NaN();
+
+				uint32_t frames = 0;
+				BenchTimer timer;
+
+				while (InputRecorder::isReplaying())
+				{
+					window->onUpdate();
+					frames++;
+				}
+
+				if (frames == 0)
+					return std::numeric_limits<double>::quiet_NaN();
+
+				return timer.elapsedNanoseconds() * 1e-6 / frames;
+			};
+			suite.add(replay);
+		}
+	}
+
+	void setReplayFile(const std::string &filename)
+	{
+		replayFile = filename;
+	}
+
+	Window *getBenchWindow()
+	{
+		getContext();
+		return window;
+	}
+
+	void shutdownWindowBenchmarks()
+	{
+		delete window;
+		window = nullptr;
+	}
+
+}
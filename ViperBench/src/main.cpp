@@ -0,0 +1,88 @@
+#include "vpch.h"
+#include "MicroBench.h"
+
+#include "Viper/Memory/MemoryTracker.h"
+
+/*
+	ViperBench [--filter <text>] [--out <file>] [--baseline <file>] [--threshold <percent>] [--cpu <index>] [--gpu] [--replay <file>]
+			   [--sample-allocations <n>]
+
+	Runs the benchmark scenarios, writes the results as JSON and optionally compares them with a baseline
+	(the JSON of an earlier run). The exit code is the number of regressions and failed benchmarks, so a script can fail on them.
+	Scenarios that need a window and a GPU only run with --gpu, everything else runs headless.
+	Microbenchmarks (names starting with micro/) are pinned to the core given by --cpu, they are not pinned by default (or with -1).
+	--replay adds gpu/replay, frames of the benchmark window driven by an input recording made in the game (F9).
+			 The window has no layers, so it measures the replayed input and the frames, not the game's fixed timestep update.
+	--sample-allocations records the callstack of every n-th allocation (V_TRACK_MEMORY builds) and logs the hottest after the run.
+*/
+
+int main(int argc, char **argv)
+{
+	std::string filter;
+	std::string outFile = "ViperBenchResults.json";
+	std::string baselineFile;
+	double threshold = 10.0;
+	bool gpu = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (arg == "--filter" && hasValue)
+			filter = argv[++i];
+		else if (arg == "--out" && hasValue)
+			outFile = argv[++i];
+		else if (arg == "--baseline" && hasValue)
+			baselineFile = argv[++i];
+		else if (arg == "--threshold" && hasValue)
+			threshold = std::atof(argv[++i]);
+		else if (arg == "--cpu" && hasValue)
+			ViperBench::setMicroBenchCpu(std::atoi(argv[++i]));
+		else if (arg == "--gpu")
+			gpu = true;
+		else if (arg == "--replay" && hasValue)
+			ViperBench::setReplayFile(argv[++i]);
+		else if (arg == "--sample-allocations" && hasValue)
+			Viper::MemoryTracker::setSamplingInterval((uint32_t)std::strtoul(argv[++i], nullptr, 10));
+		else
+			std::cerr << "Unknown argument " << arg << std::endl;
+	}
+
+	Viper::Log::init();
+
+	ViperBench::BenchSuite suite;
+	ViperBench::registerECSBenchmarks(suite);
+	ViperBench::registerEventBenchmarks(suite);
+	ViperBench::registerFrameBenchmarks(suite);
+	ViperBench::registerJobBenchmarks(suite);
+	ViperBench::registerLayerBenchmarks(suite);
+	ViperBench::registerLogBenchmarks(suite);
+	ViperBench::registerRenderBenchmarks(suite);
+	ViperBench::registerSpatialBenchmarks(suite);
+	ViperBench::registerTransformBenchmarks(suite);
+	ViperBench::registerWindowBenchmarks(suite);
+	ViperBench::registerMicroBenchmarks(suite);
+
+	suite.run(filter, gpu);
+	suite.writeJson(outFile);
+
+	// nothing without --sample-allocations
+	Viper::MemoryTracker::dumpSamples();
+
+	uint32_t regressions = 0;
+
+	if (!baselineFile.empty())
+	{
+		regressions = suite.compare(baselineFile, threshold / 100.0);
+		V_INFO("{0} regression(s) above {1}%", regressions, threshold);
+	}
+
+	if (suite.getFailureCount() > 0)
+		V_ERROR("{0} benchmark(s) failed", suite.getFailureCount());
+
+	ViperBench::shutdownWindowBenchmarks();
+	Viper::Log::shutdown();
+
+	return (int)(regressions + suite.getFailureCount());
+}
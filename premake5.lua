@@ -55,6 +55,16 @@ project "Viper"
 		"C:/VulkanSDK/1.1.106.0/Lib"
 	}
 
+	-- the SPIR-V modules are compiled from the GLSL sources on every build, the same commands as Shaders/compile.bat
+	prebuildcommands
+	{
+		"cd src\\Viper\\Renderer\\Shaders",
+		"C:\\VulkanSDK\\1.1.106.0\\Bin32\\glslangValidator.exe -V shader.vert",
+		"C:\\VulkanSDK\\1.1.106.0\\Bin32\\glslangValidator.exe -V shader.frag",
+		"C:\\VulkanSDK\\1.1.106.0\\Bin32\\glslangValidator.exe -V overlay.vert -o overlay_vert.spv",
+		"C:\\VulkanSDK\\1.1.106.0\\Bin32\\glslangValidator.exe -V overlay.frag -o overlay_frag.spv"
+	}
+
 	filter "system:windows"
 		systemversion "latest"
 
@@ -125,3 +135,54 @@ project "Game"
 	filter "configurations:Dist"
 		defines "V_DIST"
 		optimize "on"
+
+
+
+project "ViperBench"
+	location "ViperBench"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-intdir/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"%{prj.name}/src/**.h",
+		"%{prj.name}/src/**.cpp"
+	}
+
+	includedirs
+	{
+		"Viper/src",
+		"Viper/vendor/spdlog/include",
+		"Viper/vendor/glm",
+		"%{IncludeDir.GLFW}"
+	}
+
+	links
+	{
+		"Viper"
+	}
+
+	filter "system:windows"
+		systemversion "latest"
+
+		defines
+		{
+			"V_PLATFORM_WINDOWS"
+		}
+
+	filter "configurations:Debug"
+		defines "V_DEBUG"
+		symbols "on"
+
+	filter "configurations:Release"
+		defines "V_RELEASE"
+		optimize "on"
+
+	filter "configurations:Dist"
+		defines "V_DIST"
+		optimize "on"